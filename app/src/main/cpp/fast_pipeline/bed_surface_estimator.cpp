@@ -0,0 +1,188 @@
+#include "bed_surface_estimator.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cmath>
+
+#define LOG_TAG "BedSurfaceEstimator"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+namespace {
+constexpr float EXTENT_BIN_METERS = 0.02f;
+// Minimum effective sample weight before the plane is trusted
+constexpr double MIN_PLANE_WEIGHT = 200.0;
+// Extent percentiles (robust to stray inliers on the floor or a table)
+constexpr float EXTENT_LOW = 0.02f;
+constexpr float EXTENT_HIGH = 0.98f;
+// Slack around the percentile extent (covers the trimmed mattress edge)
+constexpr float EXTENT_MARGIN = 0.05f;
+
+template <size_t N>
+float histPercentile(const std::array<float, N>& hist, float total, float p) {
+    float target = p * total;
+    float cumulative = 0.0f;
+    for (size_t i = 0; i < N; i++) {
+        cumulative += hist[i];
+        if (cumulative >= target) {
+            return static_cast<float>(i);
+        }
+    }
+    return static_cast<float>(N - 1);
+}
+}
+
+BedSurfaceEstimator::BedSurfaceEstimator() {
+    reset();
+}
+
+BedSurfaceEstimator::~BedSurfaceEstimator() {
+}
+
+void BedSurfaceEstimator::init(float inlier_meters, float forgetting) {
+    inlier_meters_ = inlier_meters;
+    forgetting_ = std::max(0.5f, std::min(forgetting, 1.0f));
+    reset();
+}
+
+void BedSurfaceEstimator::addPoint(float x, float y, float z) {
+    if (has_plane_) {
+        float residual = std::abs(y - (a_ * x + b_ * z + c_)) * inv_norm_;
+        if (residual > inlier_meters_) {
+            return;
+        }
+    }
+
+    bxx_ += x * x; bxz_ += x * z; bx_ += x;
+    bzz_ += z * z; bz_ += z; bn_ += 1.0;
+    bxy_ += x * y; bzy_ += z * y; by_ += y;
+
+    if (!extent_origin_set_) {
+        x_origin_ = x;
+        z_origin_ = z;
+        extent_origin_set_ = true;
+    }
+    int xi = static_cast<int>((x - x_origin_) / EXTENT_BIN_METERS) + EXTENT_BINS / 2;
+    int zi = static_cast<int>((z - z_origin_) / EXTENT_BIN_METERS) + EXTENT_BINS / 2;
+    if (xi >= 0 && xi < EXTENT_BINS) x_hist_[xi] += 1.0f;
+    if (zi >= 0 && zi < EXTENT_BINS) z_hist_[zi] += 1.0f;
+
+    accepted_points_++;
+}
+
+bool BedSurfaceEstimator::commit() {
+    if (bn_ == 0) {
+        return has_plane_;
+    }
+
+    const double f = forgetting_;
+    sxx_ = sxx_ * f + bxx_; sxz_ = sxz_ * f + bxz_; sx_ = sx_ * f + bx_;
+    szz_ = szz_ * f + bzz_; sz_ = sz_ * f + bz_; n_ = n_ * f + bn_;
+    sxy_ = sxy_ * f + bxy_; szy_ = szy_ * f + bzy_; sy_ = sy_ * f + by_;
+    bxx_ = bxz_ = bx_ = bzz_ = bz_ = bn_ = 0;
+    bxy_ = bzy_ = by_ = 0;
+
+    for (int i = 0; i < EXTENT_BINS; i++) {
+        x_hist_[i] *= forgetting_;
+        z_hist_[i] *= forgetting_;
+    }
+
+    bool had_plane = has_plane_;
+    if (n_ >= MIN_PLANE_WEIGHT && solve()) {
+        updateExtent();
+        if (!had_plane) {
+            LOGI("Bed surface found: y = %.3fx + %.3fz + %.3f, extent x[%.2f, %.2f] z[%.2f, %.2f]",
+                 a_, b_, c_, min_x_, max_x_, min_z_, max_z_);
+        }
+    }
+    return has_plane_;
+}
+
+bool BedSurfaceEstimator::solve() {
+    // Normal equations:
+    // | sxx sxz sx |   | a |   | sxy |
+    // | sxz szz sz | * | b | = | szy |
+    // | sx  sz  n  |   | c |   | sy  |
+    double m00 = sxx_, m01 = sxz_, m02 = sx_;
+    double m11 = szz_, m12 = sz_, m22 = n_;
+
+    double c00 = m11 * m22 - m12 * m12;
+    double c01 = m02 * m12 - m01 * m22;
+    double c02 = m01 * m12 - m02 * m11;
+    double det = m00 * c00 + m01 * c01 + m02 * c02;
+    if (std::abs(det) < 1e-9 * n_ * n_ * n_) {
+        return false;  // Degenerate (points on a line)
+    }
+
+    double c11 = m00 * m22 - m02 * m02;
+    double c12 = m01 * m02 - m00 * m12;
+    double c22 = m00 * m11 - m01 * m01;
+
+    a_ = static_cast<float>((c00 * sxy_ + c01 * szy_ + c02 * sy_) / det);
+    b_ = static_cast<float>((c01 * sxy_ + c11 * szy_ + c12 * sy_) / det);
+    c_ = static_cast<float>((c02 * sxy_ + c12 * szy_ + c22 * sy_) / det);
+    inv_norm_ = 1.0f / std::sqrt(a_ * a_ + b_ * b_ + 1.0f);
+    has_plane_ = true;
+    return true;
+}
+
+void BedSurfaceEstimator::updateExtent() {
+    float x_total = 0.0f, z_total = 0.0f;
+    for (int i = 0; i < EXTENT_BINS; i++) {
+        x_total += x_hist_[i];
+        z_total += z_hist_[i];
+    }
+    if (x_total <= 0.0f || z_total <= 0.0f) {
+        return;
+    }
+
+    auto toMeters = [](float bin, float origin) {
+        return origin + (bin - EXTENT_BINS / 2 + 0.5f) * EXTENT_BIN_METERS;
+    };
+    min_x_ = toMeters(histPercentile(x_hist_, x_total, EXTENT_LOW), x_origin_);
+    max_x_ = toMeters(histPercentile(x_hist_, x_total, EXTENT_HIGH), x_origin_);
+    min_z_ = toMeters(histPercentile(z_hist_, z_total, EXTENT_LOW), z_origin_);
+    max_z_ = toMeters(histPercentile(z_hist_, z_total, EXTENT_HIGH), z_origin_);
+    has_extent_ = true;
+}
+
+float BedSurfaceEstimator::heightAbove(float x, float y, float z) const {
+    if (!has_plane_) {
+        return 0.0f;
+    }
+    // Camera y points down, so "above" is the plane's y minus the point's y
+    return ((a_ * x + b_ * z + c_) - y) * inv_norm_;
+}
+
+bool BedSurfaceEstimator::isOverBed(float x, float z) const {
+    if (!has_extent_) {
+        return true;
+    }
+    return x >= min_x_ - EXTENT_MARGIN && x <= max_x_ + EXTENT_MARGIN &&
+           z >= min_z_ - EXTENT_MARGIN && z <= max_z_ + EXTENT_MARGIN;
+}
+
+void BedSurfaceEstimator::getExtent(float& min_x, float& max_x, float& min_z, float& max_z) const {
+    min_x = min_x_;
+    max_x = max_x_;
+    min_z = min_z_;
+    max_z = max_z_;
+}
+
+void BedSurfaceEstimator::reset() {
+    sxx_ = sxz_ = sx_ = szz_ = sz_ = n_ = 0;
+    sxy_ = szy_ = sy_ = 0;
+    bxx_ = bxz_ = bx_ = bzz_ = bz_ = bn_ = 0;
+    bxy_ = bzy_ = by_ = 0;
+    has_plane_ = false;
+    a_ = b_ = c_ = 0.0f;
+    inv_norm_ = 1.0f;
+    x_hist_.fill(0.0f);
+    z_hist_.fill(0.0f);
+    extent_origin_set_ = false;
+    has_extent_ = false;
+    min_x_ = max_x_ = min_z_ = max_z_ = 0.0f;
+    accepted_points_ = 0;
+}
+
+} // namespace triage
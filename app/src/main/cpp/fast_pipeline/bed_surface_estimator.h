@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace triage {
+
+/**
+ * Incremental estimate of the mattress surface in camera coordinates.
+ *
+ * Fits the plane y = a*x + b*z + c (camera y points down) by least squares
+ * over surface points, with exponential forgetting so the fit follows
+ * slow changes (bed height adjusted, new linen). Once a plane exists only
+ * points close to it are accepted, which rejects pillows, rails and people.
+ *
+ * The bed's extent on the floor plan (x, z) comes from robust percentiles
+ * of accepted points, so body points can be classified as over the bed or
+ * past its edge even where the patient hides the mattress.
+ *
+ * Points arrive in small batches (addPoint ... commit) so the caller can
+ * spread the scan of the bed zone over several frames.
+ */
+class BedSurfaceEstimator {
+public:
+    BedSurfaceEstimator();
+    ~BedSurfaceEstimator();
+
+    /**
+     * @param inlier_meters Max distance from the current plane to accept a point
+     * @param forgetting Weight kept by old statistics per commit (0-1)
+     */
+    void init(float inlier_meters = 0.10f, float forgetting = 0.98f);
+
+    /**
+     * Add a candidate surface point (meters, camera coordinates)
+     */
+    void addPoint(float x, float y, float z);
+
+    /**
+     * Fold the points added since the last commit into the plane fit
+     * @return true if a plane is available
+     */
+    bool commit();
+
+    bool hasPlane() const { return has_plane_; }
+
+    /**
+     * Height of a point above the surface along the plane normal
+     * (positive = above the mattress)
+     */
+    float heightAbove(float x, float y, float z) const;
+
+    /**
+     * Whether a floor-plan position lies within the bed extent
+     */
+    bool isOverBed(float x, float z) const;
+
+    /**
+     * Plane coefficients of y = a*x + b*z + c
+     */
+    void getPlane(float& a, float& b, float& c) const { a = a_; b = b_; c = c_; }
+
+    /**
+     * Bed extent on the floor plan (camera x and z, meters)
+     */
+    void getExtent(float& min_x, float& max_x, float& min_z, float& max_z) const;
+
+    /**
+     * Points accepted into the fit since reset
+     */
+    uint64_t getAcceptedPoints() const { return accepted_points_; }
+
+    void reset();
+
+private:
+    float inlier_meters_ = 0.10f;
+    float forgetting_ = 0.98f;
+
+    // Weighted normal equations for [x z 1] * [a b c]^T = y
+    double sxx_ = 0, sxz_ = 0, sx_ = 0, szz_ = 0, sz_ = 0, n_ = 0;
+    double sxy_ = 0, szy_ = 0, sy_ = 0;
+
+    // Pending batch (not yet folded in)
+    double bxx_ = 0, bxz_ = 0, bx_ = 0, bzz_ = 0, bz_ = 0, bn_ = 0;
+    double bxy_ = 0, bzy_ = 0, by_ = 0;
+
+    bool has_plane_ = false;
+    float a_ = 0.0f, b_ = 0.0f, c_ = 0.0f;
+    float inv_norm_ = 1.0f;  // 1 / |(a, -1, b)|
+
+    // Floor-plan extent histograms (decayed with the fit)
+    static const int EXTENT_BINS = 200;       // 2cm bins over +/-2m
+    std::array<float, EXTENT_BINS> x_hist_{};
+    std::array<float, EXTENT_BINS> z_hist_{};
+    float x_origin_ = 0.0f;                   // Histogram centers
+    float z_origin_ = 0.0f;
+    bool extent_origin_set_ = false;
+    float min_x_ = 0, max_x_ = 0, min_z_ = 0, max_z_ = 0;
+    bool has_extent_ = false;
+
+    uint64_t accepted_points_ = 0;
+
+    bool solve();
+    void updateExtent();
+};
+
+} // namespace triage
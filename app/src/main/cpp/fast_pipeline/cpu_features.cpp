@@ -0,0 +1,52 @@
+#include "cpu_features.h"
+#include <android/log.h>
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+#define LOG_TAG "CpuFeatures"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+namespace {
+
+#if defined(__aarch64__) && defined(__linux__)
+// Kernel hwcap bits (arch/arm64/include/uapi/asm/hwcap.h), for older headers
+constexpr unsigned long HWCAP_BIT_ASIMD = 1UL << 1;
+constexpr unsigned long HWCAP_BIT_FPHP = 1UL << 9;
+constexpr unsigned long HWCAP_BIT_ASIMDHP = 1UL << 10;
+constexpr unsigned long HWCAP_BIT_ASIMDDP = 1UL << 20;
+constexpr unsigned long HWCAP2_BIT_I8MM = 1UL << 13;
+#endif
+
+CpuFeatures detect() {
+    CpuFeatures f;
+#if defined(__aarch64__) && defined(__linux__)
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    const unsigned long hwcap2 = getauxval(AT_HWCAP2);
+    f.neon = (hwcap & HWCAP_BIT_ASIMD) != 0;
+    f.dotprod = (hwcap & HWCAP_BIT_ASIMDDP) != 0;
+    f.fp16 = (hwcap & HWCAP_BIT_FPHP) != 0 && (hwcap & HWCAP_BIT_ASIMDHP) != 0;
+    f.i8mm = (hwcap2 & HWCAP2_BIT_I8MM) != 0;
+#elif defined(__aarch64__)
+    f.neon = true;
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    f.avx2 = __builtin_cpu_supports("avx2");
+    f.fma = __builtin_cpu_supports("fma");
+#endif
+    LOGI("CPU features: neon=%d dotprod=%d fp16=%d i8mm=%d avx2=%d fma=%d",
+         f.neon, f.dotprod, f.fp16, f.i8mm, f.avx2, f.fma);
+    return f;
+}
+
+} // namespace
+
+const CpuFeatures& cpuFeatures() {
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+} // namespace triage
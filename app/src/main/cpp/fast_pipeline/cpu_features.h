@@ -0,0 +1,26 @@
+#pragma once
+
+namespace triage {
+
+/**
+ * Instruction-set extensions of the CPU we are running on.
+ *
+ * The library is built for the baseline ABI (ARMv8.0 NEON, x86-64 SSE2);
+ * these flags say which wider variants of the SIMD kernels are safe to
+ * call. Detected once, on first use.
+ */
+struct CpuFeatures {
+    bool neon = false;       // ARMv8 Advanced SIMD (always on arm64)
+    bool dotprod = false;    // ARMv8.2 SDOT/UDOT
+    bool fp16 = false;       // ARMv8.2 half-precision arithmetic
+    bool i8mm = false;       // ARMv8.6 int8 matrix multiply
+    bool avx2 = false;       // x86 AVX2
+    bool fma = false;        // x86 FMA3
+};
+
+/**
+ * Features of this CPU (getauxval on ARM, cpuid on x86)
+ */
+const CpuFeatures& cpuFeatures();
+
+} // namespace triage
@@ -1,9 +1,15 @@
 #include "depth_processor.h"
+#include "simd_kernels.h"
 #include <android/log.h>
 #include <algorithm>
 #include <cmath>
 #include <chrono>
 #include <numeric>
+#include <limits>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 #define LOG_TAG "DepthProcessor"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -11,6 +17,49 @@
 
 namespace triage {
 
+namespace {
+// DEPTH16 layout: bits 15-13 confidence, bits 12-0 range in millimeters
+constexpr uint16_t DEPTH16_RANGE_MASK = 0x1FFF;
+constexpr int DEPTH16_CONFIDENCE_SHIFT = 13;
+
+// Height histogram over camera y: -4m..+4m in 1cm bins
+constexpr float HEIGHT_HIST_MIN = -4.0f;
+constexpr float HEIGHT_HIST_BIN = 0.01f;
+constexpr int HEIGHT_HIST_BINS = 800;
+// Sampling caps (per axis) for body and floor histograms
+constexpr int MAX_BODY_SAMPLES = 64;
+constexpr int FLOOR_SAMPLES = 32;
+// Points this close to the floor count as "on the floor"
+constexpr float NEAR_FLOOR_METERS = 0.3f;
+// Bed scan: samples per axis over the whole zone (split across bands)
+constexpr int BED_ZONE_SAMPLES = 64;
+// Body sampling cap for bed occupancy (per axis)
+constexpr int MAX_OCCUPANCY_SAMPLES = 48;
+// Body points must rise this far above the mattress
+constexpr float BODY_ABOVE_BED_METERS = 0.05f;
+// Bed-relative height histogram: -0.5m..2.5m in 1cm bins
+constexpr float BED_HIST_MIN = -0.5f;
+constexpr int BED_HIST_BINS = 300;
+
+inline int heightBin(float y) {
+    int bin = static_cast<int>((y - HEIGHT_HIST_MIN) / HEIGHT_HIST_BIN);
+    return std::max(0, std::min(bin, HEIGHT_HIST_BINS - 1));
+}
+
+// Value at percentile p (0-1) by cumulative scan - no sort
+float histogramPercentile(const uint32_t* hist, uint32_t total, float p) {
+    uint32_t target = static_cast<uint32_t>(p * total);
+    uint32_t cumulative = 0;
+    for (int i = 0; i < HEIGHT_HIST_BINS; i++) {
+        cumulative += hist[i];
+        if (cumulative > target) {
+            return HEIGHT_HIST_MIN + (i + 0.5f) * HEIGHT_HIST_BIN;
+        }
+    }
+    return HEIGHT_HIST_MIN + HEIGHT_HIST_BINS * HEIGHT_HIST_BIN;
+}
+}
+
 DepthProcessor::DepthProcessor() = default;
 
 DepthProcessor::~DepthProcessor() = default;
@@ -21,26 +70,90 @@ void DepthProcessor::init(int width, int height) {
     principal_x_ = width / 2.0f;
     principal_y_ = height / 2.0f;
 
-    // Pre-allocate depth map
+    // Pre-allocate depth planes
     depth_map_.resize(width * height);
+    confidence_map_.resize(width * height);
 
     initialized_ = true;
     LOGI("DepthProcessor initialized: %dx%d", width, height);
 }
 
-void DepthProcessor::updateDepthMap(const uint16_t* depth_data, int width, int height) {
+void DepthProcessor::updateDepthMap(const DepthView& depth) {
     if (!initialized_) {
-        init(width, height);
+        init(depth.width, depth.height);
     }
 
-    if (width != width_ || height != height_) {
+    if (depth.width != width_ || depth.height != height_) {
         LOGE("Depth frame size mismatch: expected %dx%d, got %dx%d",
-             width_, height_, width, height);
+             width_, height_, depth.width, depth.height);
         return;
     }
 
-    // Copy depth data
-    std::copy(depth_data, depth_data + (width * height), depth_map_.begin());
+    // One run over the whole plane when packed, else one per row
+    const size_t count = static_cast<size_t>(width_) * height_;
+    size_t valid = 0;
+    if (depth.isPacked()) {
+        valid = decodeDepth16(depth.data, count, 0);
+    } else {
+        for (int y = 0; y < height_; y++) {
+            valid += decodeDepth16(depth.row(y), width_, static_cast<size_t>(y) * width_);
+        }
+    }
+    valid_fraction_ = count > 0 ? static_cast<float>(valid) / count : 0.0f;
+}
+
+size_t DepthProcessor::decodeDepth16(const uint16_t* src, size_t count, size_t dst_offset) {
+    uint16_t* range = depth_map_.data() + dst_offset;
+    uint8_t* confidence = confidence_map_.data() + dst_offset;
+    const uint16_t min_level = min_confidence_level_;
+    size_t valid = 0;
+    size_t i = 0;
+
+    // Confidence code 0 means 100%, codes 1-7 mean 0/7..6/7, so
+    // level = (code - 1) & 7 maps it onto 0-7 with 7 = most confident.
+#if defined(__ARM_NEON)
+    const uint16x8_t range_mask = vdupq_n_u16(DEPTH16_RANGE_MASK);
+    const uint16x8_t one = vdupq_n_u16(1);
+    const uint16x8_t seven = vdupq_n_u16(7);
+    const uint16x8_t floor_v = vdupq_n_u16(min_level);
+    const uint16x8_t zero = vdupq_n_u16(0);
+    uint32x4_t valid_v = vdupq_n_u32(0);
+
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t raw = vld1q_u16(src + i);
+        uint16x8_t r = vandq_u16(raw, range_mask);
+        uint16x8_t level = vandq_u16(vsubq_u16(vshrq_n_u16(raw, DEPTH16_CONFIDENCE_SHIFT), one), seven);
+        uint16x8_t keep = vandq_u16(vcgeq_u16(level, floor_v), vcgtq_u16(r, zero));
+        r = vandq_u16(r, keep);
+
+        vst1q_u16(range + i, r);
+        vst1_u8(confidence + i, vmovn_u16(level));
+        // keep lanes are 0xFFFF; shift to 1 and accumulate
+        valid_v = vpadalq_u16(valid_v, vshrq_n_u16(keep, 15));
+    }
+    valid += vgetq_lane_u32(valid_v, 0) + vgetq_lane_u32(valid_v, 1) +
+             vgetq_lane_u32(valid_v, 2) + vgetq_lane_u32(valid_v, 3);
+#endif
+
+    // Scalar tail (and the whole frame on non-NEON builds; branch-free so
+    // the compiler can auto-vectorize it)
+    for (; i < count; i++) {
+        uint16_t raw = src[i];
+        uint16_t r = raw & DEPTH16_RANGE_MASK;
+        uint16_t level = static_cast<uint16_t>((raw >> DEPTH16_CONFIDENCE_SHIFT) - 1) & 7;
+        bool keep = level >= min_level && r != 0;
+        range[i] = keep ? r : 0;
+        confidence[i] = static_cast<uint8_t>(level);
+        valid += keep;
+    }
+
+    return valid;
+}
+
+void DepthProcessor::setConfidenceFloor(float min_confidence) {
+    min_confidence = std::max(0.0f, std::min(1.0f, min_confidence));
+    min_confidence_level_ = static_cast<uint16_t>(std::ceil(min_confidence * 7.0f - 1e-4f));
+    LOGI("Depth confidence floor: %.2f (level %d/7)", min_confidence, min_confidence_level_);
 }
 
 float DepthProcessor::getDepthAt(int x, int y) const {
@@ -48,16 +161,20 @@ float DepthProcessor::getDepthAt(int x, int y) const {
         return -1.0f;
     }
 
-    int idx = y * width_ + x;
-    uint16_t raw_depth = depth_map_[idx];
-
-    // Invalid depth values (0 or max)
-    if (raw_depth == 0 || raw_depth == 0xFFFF) {
+    // Range plane is already decoded; 0 marks invalid or low confidence
+    uint16_t range_mm = depth_map_[y * width_ + x];
+    if (range_mm == 0) {
         return -1.0f;
     }
 
-    // DEPTH16 values are in millimeters
-    return raw_depth / 1000.0f;
+    return range_mm / 1000.0f;
+}
+
+float DepthProcessor::getConfidenceAt(int x, int y) const {
+    if (!initialized_ || x < 0 || x >= width_ || y < 0 || y >= height_) {
+        return -1.0f;
+    }
+    return confidence_map_[y * width_ + x] / 7.0f;
 }
 
 float DepthProcessor::getDepthAtNormalized(float norm_x, float norm_y) const {
@@ -85,35 +202,41 @@ DepthStats DepthProcessor::calculateStats(const BoundingBox& bbox) const {
     x2 = std::max(0, std::min(x2, width_ - 1));
     y2 = std::max(0, std::min(y2, height_ - 1));
 
-    std::vector<float> valid_depths;
-
+    // Work on the range plane in integer millimeters: min / max / mean in
+    // the CPU-dispatched kernel, then the valid samples for the median
+    const int box_w = x2 - x1 + 1;
+    const auto depth_range_stats = simdKernels().depth_range_stats;
+    DepthRangeStats range;
     for (int y = y1; y <= y2; y++) {
-        for (int x = x1; x <= x2; x++) {
-            float depth = getDepthAt(x, y);
-            if (depth > 0) {
-                valid_depths.push_back(depth);
-            }
-            stats.total_pixels++;
-        }
+        depth_range_stats(depth_map_.data() + y * width_ + x1, box_w, range);
     }
 
-    stats.valid_pixels = static_cast<int>(valid_depths.size());
+    stats.total_pixels = box_w * (y2 - y1 + 1);
+    stats.valid_pixels = static_cast<int>(range.count);
 
-    if (valid_depths.empty()) {
+    if (range.count == 0) {
         return stats;
     }
 
-    // Calculate statistics
-    stats.min_meters = *std::min_element(valid_depths.begin(), valid_depths.end());
-    stats.max_meters = *std::max_element(valid_depths.begin(), valid_depths.end());
+    stats.min_meters = range.min / 1000.0f;
+    stats.max_meters = range.max / 1000.0f;
+    stats.mean_meters = range.sum / 1000.0f / range.count;
 
-    float sum = std::accumulate(valid_depths.begin(), valid_depths.end(), 0.0f);
-    stats.mean_meters = sum / valid_depths.size();
+    std::vector<uint16_t> valid_depths;
+    valid_depths.reserve(range.count);
+    for (int y = y1; y <= y2; y++) {
+        const uint16_t* row = depth_map_.data() + y * width_;
+        for (int x = x1; x <= x2; x++) {
+            if (row[x] != 0) {
+                valid_depths.push_back(row[x]);
+            }
+        }
+    }
 
     // Median
     size_t mid = valid_depths.size() / 2;
     std::nth_element(valid_depths.begin(), valid_depths.begin() + mid, valid_depths.end());
-    stats.median_meters = valid_depths[mid];
+    stats.median_meters = valid_depths[mid] / 1000.0f;
 
     return stats;
 }
@@ -175,7 +298,7 @@ DepthFallResult DepthProcessor::detectFall(
     int rgb_width,
     int rgb_height
 ) {
-    DepthFallResult result = {false, 0, 0, 0, 0};
+    DepthFallResult result = {};
 
     if (!initialized_ || depth_map_.empty()) {
         return result;
@@ -198,15 +321,42 @@ DepthFallResult DepthProcessor::detectFall(
     result.vertical_drop_meters = calculateVerticalDrop();
     result.drop_velocity_ms = calculateDropVelocity();
 
+    // Head height from the body point distribution - the box center can sit
+    // on a blanket and stay put while the head drops
+    updateFloorEstimate();
+    BodyHeightFeatures body = computeBodyHeight(person_bbox);
+    float head_velocity = 0.0f;
+    float total_head_drop = 0.0f;
+    if (body.valid) {
+        result.head_height_meters = body.head_height_meters;
+        result.near_floor_fraction = body.near_floor_fraction;
+        result.body_extent_meters = body.body_extent_meters;
+        updateHeadHistory(body.head_height_meters, getCurrentTimeMs(),
+                          result.head_drop_meters, head_velocity, total_head_drop);
+    }
+
     // Fall detection logic
     bool rapid_drop = result.vertical_drop_meters > fall_drop_threshold_;
     bool high_velocity = result.drop_velocity_ms > fall_velocity_threshold_;
-
-    if (rapid_drop && high_velocity) {
+    bool head_fall = result.head_drop_meters > fall_drop_threshold_ &&
+                     head_velocity > fall_velocity_threshold_;
+    // Low, flat and mostly near the floor - lying on the floor, not in bed
+    bool on_floor = body.valid && floor_valid_ &&
+                    body.head_height_meters < 0.6f &&
+                    body.near_floor_fraction > 0.5f;
+
+    if ((rapid_drop && high_velocity) || head_fall) {
+        result.fall_detected = true;
+        result.confidence = (head_fall && on_floor) ? 0.95f : 0.9f;
+        LOGI("FALL DETECTED: drop=%.2fm, velocity=%.2fm/s, head drop=%.2fm (%.2fm/s), near floor=%.2f",
+             result.vertical_drop_meters, result.drop_velocity_ms,
+             result.head_drop_meters, head_velocity, result.near_floor_fraction);
+    } else if (on_floor && total_head_drop > fall_drop_threshold_) {
+        // Slower descent that ended on the floor (slid out of bed / chair)
         result.fall_detected = true;
-        result.confidence = 0.9f;
-        LOGI("FALL DETECTED: drop=%.2fm, velocity=%.2fm/s",
-             result.vertical_drop_meters, result.drop_velocity_ms);
+        result.confidence = 0.7f;
+        LOGI("FALL DETECTED (slow): head drop=%.2fm over %llds window, near floor=%.2f",
+             total_head_drop, (long long)(head_window_ms_ / 1000), result.near_floor_fraction);
     } else if (rapid_drop) {
         // Just drop, low velocity (might be sitting down)
         result.fall_detected = false;
@@ -216,8 +366,8 @@ DepthFallResult DepthProcessor::detectFall(
         result.confidence = 0.0f;
     }
 
-    // Store last position
-    last_position_ = current_pos;
+    // last_position_ is left to analyzeMotion, which measures motion
+    // against it (called after this on the same box it would read 0)
     last_distance_ = current_pos.z;
 
     return result;
@@ -260,15 +410,308 @@ DepthMotionResult DepthProcessor::analyzeMotion(
     return result;
 }
 
+float DepthProcessor::estimateLateralTilt(const BoundingBox& person_bbox) const {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    if (!initialized_ || depth_map_.empty()) {
+        return nan;
+    }
+
+    int x1 = std::max(0, static_cast<int>(person_bbox.x * width_));
+    int x2 = std::min(width_ - 1, static_cast<int>((person_bbox.x + person_bbox.width) * width_));
+    // Torso band: middle 40% of the box height
+    int y1 = std::max(0, static_cast<int>((person_bbox.y + person_bbox.height * 0.3f) * height_));
+    int y2 = std::min(height_ - 1, static_cast<int>((person_bbox.y + person_bbox.height * 0.7f) * height_));
+
+    int box_w = x2 - x1;
+    if (box_w < 6 || y2 <= y1) {
+        return nan;
+    }
+
+    // At most ~16x16 samples per side
+    const int max_samples = 16;
+    int third = box_w / 3;
+    int step_x = std::max(1, third / max_samples);
+    int step_y = std::max(1, (y2 - y1) / max_samples);
+
+    auto meanDepth = [&](int from_x, int to_x, int& count) {
+        uint32_t sum_mm = 0;
+        count = 0;
+        for (int y = y1; y <= y2; y += step_y) {
+            const uint16_t* row = depth_map_.data() + y * width_;
+            for (int x = from_x; x < to_x; x += step_x) {
+                if (row[x] != 0) {
+                    sum_mm += row[x];
+                    count++;
+                }
+            }
+        }
+        return count > 0 ? sum_mm / 1000.0f / count : 0.0f;
+    };
+
+    int left_count = 0, right_count = 0;
+    float left = meanDepth(x1, x1 + third, left_count);
+    float right = meanDepth(x2 - third, x2, right_count);
+
+    const int min_samples = 8;
+    if (left_count < min_samples || right_count < min_samples) {
+        return nan;
+    }
+
+    // Physical body width at the torso depth (pinhole model)
+    float mid_depth = (left + right) / 2;
+    float width_meters = box_w * mid_depth / focal_length_x_;
+    if (width_meters <= 0.05f) {
+        return nan;
+    }
+
+    return (right - left) / width_meters;
+}
+
+BodyHeightFeatures DepthProcessor::computeBodyHeight(const BoundingBox& person_bbox) const {
+    BodyHeightFeatures features = {};
+
+    if (!initialized_ || depth_map_.empty() || !floor_valid_) {
+        return features;
+    }
+
+    int x1 = std::max(0, static_cast<int>(person_bbox.x * width_));
+    int y1 = std::max(0, static_cast<int>(person_bbox.y * height_));
+    int x2 = std::min(width_ - 1, static_cast<int>((person_bbox.x + person_bbox.width) * width_));
+    int y2 = std::min(height_ - 1, static_cast<int>((person_bbox.y + person_bbox.height) * height_));
+    if (x2 <= x1 || y2 <= y1) {
+        return features;
+    }
+
+    int step_x = std::max(1, (x2 - x1 + 1) / MAX_BODY_SAMPLES);
+    int step_y = std::max(1, (y2 - y1 + 1) / MAX_BODY_SAMPLES);
+
+    uint32_t hist[HEIGHT_HIST_BINS] = {0};
+    uint32_t total = 0;
+    uint32_t near_floor = 0;
+    const float near_floor_y = floor_y_ - NEAR_FLOOR_METERS;
+    const float inv_fy = 1.0f / focal_length_y_;
+
+    for (int v = y1; v <= y2; v += step_y) {
+        const uint16_t* row = depth_map_.data() + v * width_;
+        // Same ray angle for the whole row: y = (v - cy) * z / fy
+        const float ray_y = (v - principal_y_) * inv_fy;
+        for (int u = x1; u <= x2; u += step_x) {
+            uint16_t mm = row[u];
+            if (mm == 0) continue;
+            float y = ray_y * (mm * 0.001f);
+            hist[heightBin(y)]++;
+            near_floor += (y >= near_floor_y);
+            total++;
+        }
+    }
+
+    const uint32_t min_points = 32;
+    if (total < min_points) {
+        return features;
+    }
+
+    // Camera y points down: low percentile = top of the body
+    float top_y = histogramPercentile(hist, total, 0.05f);
+    float bottom_y = histogramPercentile(hist, total, 0.95f);
+
+    features.valid = true;
+    features.head_height_meters = floor_y_ - top_y;
+    features.body_extent_meters = bottom_y - top_y;
+    features.near_floor_fraction = static_cast<float>(near_floor) / total;
+    features.points = static_cast<int>(total);
+    return features;
+}
+
+void DepthProcessor::updateBedSurface(const BoundingBox* person_bbox, bool patient_still) {
+    if (!initialized_ || depth_map_.empty()) {
+        return;
+    }
+    // A moving patient deforms the mattress - only learn from still scenes
+    if (person_bbox != nullptr && !patient_still) {
+        return;
+    }
+
+    // Bed zone (sphere) projected to a pixel rectangle
+    if (bed_center_.z <= bed_radius_ * 0.5f) {
+        return;
+    }
+    float near_z = std::max(bed_center_.z - bed_radius_, 0.3f);
+    float u0 = focal_length_x_ * bed_center_.x / bed_center_.z + principal_x_;
+    float v0 = focal_length_y_ * bed_center_.y / bed_center_.z + principal_y_;
+    float ru = focal_length_x_ * bed_radius_ / near_z;
+    float rv = focal_length_y_ * bed_radius_ / near_z;
+    int x1 = std::max(0, static_cast<int>(u0 - ru));
+    int x2 = std::min(width_ - 1, static_cast<int>(u0 + ru));
+    int y1 = std::max(0, static_cast<int>(v0 - rv));
+    int y2 = std::min(height_ - 1, static_cast<int>(v0 + rv));
+    if (x2 <= x1 || y2 <= y1) {
+        return;
+    }
+
+    // Person box padded by 10% (normalized) so limbs at the edges are skipped
+    float px1 = 2.0f, px2 = -1.0f, py1 = 2.0f, py2 = -1.0f;
+    if (person_bbox != nullptr) {
+        float pad_x = person_bbox->width * 0.1f;
+        float pad_y = person_bbox->height * 0.1f;
+        px1 = (person_bbox->x - pad_x) * width_;
+        px2 = (person_bbox->x + person_bbox->width + pad_x) * width_;
+        py1 = (person_bbox->y - pad_y) * height_;
+        py2 = (person_bbox->y + person_bbox->height + pad_y) * height_;
+    }
+
+    int step_x = std::max(1, (x2 - x1 + 1) / BED_ZONE_SAMPLES);
+    int step_y = std::max(1, (y2 - y1 + 1) / BED_ZONE_SAMPLES);
+    const float radius_sq = bed_radius_ * bed_radius_;
+
+    // This frame's band: every BED_SCAN_BANDS-th sampled row
+    for (int v = y1 + bed_scan_band_ * step_y; v <= y2; v += step_y * BED_SCAN_BANDS) {
+        const uint16_t* row = depth_map_.data() + v * width_;
+        const float ray_y = (v - principal_y_) / focal_length_y_;
+        bool row_in_person = v >= py1 && v <= py2;
+        for (int u = x1; u <= x2; u += step_x) {
+            if (row[u] == 0) continue;
+            if (row_in_person && u >= px1 && u <= px2) continue;
+
+            float z = row[u] * 0.001f;
+            float x = (u - principal_x_) * z / focal_length_x_;
+            float y = ray_y * z;
+            float dx = x - bed_center_.x, dy = y - bed_center_.y, dz = z - bed_center_.z;
+            if (dx * dx + dy * dy + dz * dz > radius_sq) continue;
+
+            bed_surface_.addPoint(x, y, z);
+        }
+    }
+    bed_scan_band_ = (bed_scan_band_ + 1) % BED_SCAN_BANDS;
+
+    // Fold in a full scan at a time so every band carries equal weight
+    if (bed_scan_band_ == 0) {
+        bed_surface_.commit();
+    }
+}
+
+BedOccupancy DepthProcessor::measureBedOccupancy(const BoundingBox& person_bbox) const {
+    BedOccupancy occupancy = {};
+
+    if (!initialized_ || depth_map_.empty() || !bed_surface_.hasPlane()) {
+        return occupancy;
+    }
+
+    int x1 = std::max(0, static_cast<int>(person_bbox.x * width_));
+    int y1 = std::max(0, static_cast<int>(person_bbox.y * height_));
+    int x2 = std::min(width_ - 1, static_cast<int>((person_bbox.x + person_bbox.width) * width_));
+    int y2 = std::min(height_ - 1, static_cast<int>((person_bbox.y + person_bbox.height) * height_));
+    if (x2 <= x1 || y2 <= y1) {
+        return occupancy;
+    }
+
+    int step_x = std::max(1, (x2 - x1 + 1) / MAX_OCCUPANCY_SAMPLES);
+    int step_y = std::max(1, (y2 - y1 + 1) / MAX_OCCUPANCY_SAMPLES);
+
+    uint32_t hist[BED_HIST_BINS] = {0};
+    uint32_t total = 0;
+    uint32_t over_edge = 0;
+
+    for (int v = y1; v <= y2; v += step_y) {
+        const uint16_t* row = depth_map_.data() + v * width_;
+        const float ray_y = (v - principal_y_) / focal_length_y_;
+        for (int u = x1; u <= x2; u += step_x) {
+            if (row[u] == 0) continue;
+
+            float z = row[u] * 0.001f;
+            float x = (u - principal_x_) * z / focal_length_x_;
+            float y = ray_y * z;
+            float height = bed_surface_.heightAbove(x, y, z);
+            bool over_bed = bed_surface_.isOverBed(x, z);
+
+            // Body = above the mattress, or hanging past the edge below
+            // mattress level but clear of the floor
+            bool body = height > BODY_ABOVE_BED_METERS ||
+                        (!over_bed && height < -BODY_ABOVE_BED_METERS &&
+                         floor_valid_ && floor_y_ - y > 0.1f);
+            if (!body) continue;
+
+            int bin = static_cast<int>((height - BED_HIST_MIN) / HEIGHT_HIST_BIN);
+            hist[std::max(0, std::min(bin, BED_HIST_BINS - 1))]++;
+            over_edge += !over_bed;
+            total++;
+        }
+    }
+
+    const uint32_t min_points = 32;
+    if (total < min_points) {
+        return occupancy;
+    }
+
+    uint32_t target = static_cast<uint32_t>(0.9f * total);
+    uint32_t cumulative = 0;
+    int bin = 0;
+    for (; bin < BED_HIST_BINS; bin++) {
+        cumulative += hist[bin];
+        if (cumulative > target) break;
+    }
+
+    occupancy.valid = true;
+    occupancy.height_above_bed_meters = BED_HIST_MIN + (bin + 0.5f) * HEIGHT_HIST_BIN;
+    occupancy.over_edge_fraction = static_cast<float>(over_edge) / total;
+    occupancy.points = static_cast<int>(total);
+    return occupancy;
+}
+
+void DepthProcessor::setFloorLevel(float floor_y) {
+    floor_y_ = floor_y;
+    floor_valid_ = true;
+    floor_fixed_ = true;
+    LOGI("Floor level fixed at y=%.2fm", floor_y);
+}
+
+float DepthProcessor::getFloorLevel() const {
+    return floor_valid_ ? floor_y_ : std::numeric_limits<float>::quiet_NaN();
+}
+
 void DepthProcessor::setBedRegion(const Position3D& center, float radius_meters) {
     bed_center_ = center;
     bed_radius_ = radius_meters;
+    // Surface points from the old zone no longer apply
+    bed_surface_.reset();
+    bed_scan_band_ = 0;
     LOGI("Bed region set: center=(%.2f, %.2f, %.2f), radius=%.2fm",
          center.x, center.y, center.z, radius_meters);
 }
 
+bool DepthProcessor::setBedRegionFromBox(const BoundingBox& bed_bbox, int rgb_width, int rgb_height) {
+    if (!initialized_ || depth_map_.empty()) {
+        return false;
+    }
+
+    Position3D center = estimate3DPosition(bed_bbox, rgb_width, rgb_height);
+    if (center.z <= 0.0f) {
+        return false;
+    }
+
+    // Box extent at the bed's depth; the half-diagonal plus a margin for
+    // a patient sitting up or lying at the edge
+    float width_m = bed_bbox.width * width_ * center.z / focal_length_x_;
+    float height_m = bed_bbox.height * height_ * center.z / focal_length_y_;
+    float radius = 0.5f * std::sqrt(width_m * width_m + height_m * height_m) + 0.2f;
+    setBedRegion(center, std::max(0.8f, std::min(radius, 2.0f)));
+    return true;
+}
+
+void DepthProcessor::invalidateCalibration() {
+    floor_valid_ = false;
+    floor_fixed_ = false;
+    floor_y_ = 0.0f;
+    bed_surface_.reset();
+    bed_scan_band_ = 0;
+    position_history_.clear();
+    head_history_.clear();
+    LOGI("Depth calibration invalidated - re-estimating floor and bed surface");
+}
+
 void DepthProcessor::reset() {
     position_history_.clear();
+    head_history_.clear();
     last_position_ = {0, 0, 0};
     last_distance_ = 0;
     LOGI("DepthProcessor state reset");
@@ -281,12 +724,17 @@ float DepthProcessor::medianDepthInRegion(int x1, int y1, int x2, int y2) const
     x2 = std::min(width_ - 1, x2);
     y2 = std::min(height_ - 1, y2);
 
-    std::vector<float> depths;
+    if (x2 < x1 || y2 < y1) {
+        return -1.0f;
+    }
+
+    std::vector<uint16_t> depths;
+    depths.reserve(static_cast<size_t>(x2 - x1 + 1) * (y2 - y1 + 1));
     for (int y = y1; y <= y2; y++) {
+        const uint16_t* row = depth_map_.data() + y * width_;
         for (int x = x1; x <= x2; x++) {
-            float d = getDepthAt(x, y);
-            if (d > 0) {
-                depths.push_back(d);
+            if (row[x] != 0) {
+                depths.push_back(row[x]);
             }
         }
     }
@@ -297,7 +745,7 @@ float DepthProcessor::medianDepthInRegion(int x1, int y1, int x2, int y2) const
 
     size_t mid = depths.size() / 2;
     std::nth_element(depths.begin(), depths.begin() + mid, depths.end());
-    return depths[mid];
+    return depths[mid] / 1000.0f;
 }
 
 void DepthProcessor::updatePositionHistory(const Position3D& pos) {
@@ -317,6 +765,66 @@ void DepthProcessor::updatePositionHistory(const Position3D& pos) {
     }
 }
 
+void DepthProcessor::updateFloorEstimate() {
+    if (floor_fixed_) {
+        return;
+    }
+
+    // Lowest surfaces in the scene: 98th percentile of y over a coarse grid
+    uint32_t hist[HEIGHT_HIST_BINS] = {0};
+    uint32_t total = 0;
+    int step_x = std::max(1, width_ / FLOOR_SAMPLES);
+    int step_y = std::max(1, height_ / FLOOR_SAMPLES);
+
+    for (int v = 0; v < height_; v += step_y) {
+        const uint16_t* row = depth_map_.data() + v * width_;
+        const float ray_y = (v - principal_y_) / focal_length_y_;
+        for (int u = 0; u < width_; u += step_x) {
+            if (row[u] == 0) continue;
+            hist[heightBin(ray_y * (row[u] * 0.001f))]++;
+            total++;
+        }
+    }
+
+    if (total < FLOOR_SAMPLES * 4) {
+        return;
+    }
+
+    float candidate = histogramPercentile(hist, total, 0.98f);
+    if (!floor_valid_) {
+        floor_y_ = candidate;
+        floor_valid_ = true;
+    } else {
+        // Slow EMA - people walking through must not move the floor
+        floor_y_ += 0.02f * (candidate - floor_y_);
+    }
+}
+
+void DepthProcessor::updateHeadHistory(float head_height, int64_t now_ms, float& fast_drop,
+                                       float& fast_velocity, float& total_drop) {
+    head_history_.push_back({head_height, now_ms});
+    while (!head_history_.empty() && now_ms - head_history_.front().timestamp_ms > head_window_ms_) {
+        head_history_.pop_front();
+    }
+
+    // Highest head position over the long window and over the fall window
+    float max_total = head_height;
+    float max_fast = head_height;
+    int64_t max_fast_ms = now_ms;
+    for (const auto& sample : head_history_) {
+        max_total = std::max(max_total, sample.head_height);
+        if (now_ms - sample.timestamp_ms <= fall_time_window_ms_ && sample.head_height > max_fast) {
+            max_fast = sample.head_height;
+            max_fast_ms = sample.timestamp_ms;
+        }
+    }
+
+    total_drop = max_total - head_height;
+    fast_drop = max_fast - head_height;
+    int64_t dt_ms = now_ms - max_fast_ms;
+    fast_velocity = dt_ms > 0 ? fast_drop / (dt_ms / 1000.0f) : 0.0f;
+}
+
 float DepthProcessor::calculateVerticalDrop() const {
     if (position_history_.size() < 2) {
         return 0.0f;
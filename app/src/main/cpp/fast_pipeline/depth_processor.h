@@ -1,5 +1,7 @@
 #pragma once
 
+#include "bed_surface_estimator.h"
+#include "image_view.h"
 #include <vector>
 #include <cstdint>
 #include <deque>
@@ -35,6 +37,28 @@ struct DepthStats {
     int total_pixels;
 };
 
+/**
+ * Height distribution of the deprojected points inside the person box.
+ * Heights are along the camera's up axis (-y), relative to the floor level.
+ */
+struct BodyHeightFeatures {
+    bool valid;
+    float head_height_meters;     // 95th percentile height (head/shoulders)
+    float body_extent_meters;     // 5th-95th percentile height span
+    float near_floor_fraction;    // Fraction of points within 0.3m of the floor
+    int points;                   // Deprojected points used
+};
+
+/**
+ * Patient position relative to the mattress surface
+ */
+struct BedOccupancy {
+    bool valid;                   // Bed surface known and enough body points
+    float height_above_bed_meters;   // 90th percentile body height above the mattress
+    float over_edge_fraction;     // Fraction of body points past the bed extent
+    int points;                   // Body points used
+};
+
 /**
  * Result of depth-enhanced fall detection
  */
@@ -44,6 +68,10 @@ struct DepthFallResult {
     float drop_velocity_ms;       // Speed of descent (m/s)
     float current_height_meters;  // Current height above floor
     float confidence;             // 0.0-1.0
+    float head_height_meters;     // Top-percentile body height above floor
+    float head_drop_meters;       // Head drop over the recent window
+    float near_floor_fraction;    // Fraction of body points near the floor
+    float body_extent_meters;     // Vertical body extent
 };
 
 /**
@@ -78,11 +106,23 @@ public:
 
     /**
      * Update with new depth frame
-     * @param depth_data DEPTH16 data (uint16_t, values in millimeters)
-     * @param width Frame width
-     * @param height Frame height
+     *
+     * Decodes DEPTH16 into a range plane (millimeters, 0 = invalid) and a
+     * confidence plane. Samples below the confidence floor are dropped here,
+     * so every stats/median routine only sees the clean range plane.
+     * @param depth DEPTH16 plane (top 3 bits confidence, low 13 bits range
+     *        in mm), any row stride
+     */
+    void updateDepthMap(const DepthView& depth);
+
+    /**
+     * Minimum sample confidence to keep (0-1, default 1/7), inclusive.
+     * DEPTH16 confidence is quantized to levels 0/7..7/7; 0 keeps every
+     * sample, including those the sensor marked as 0% confident, and the
+     * default 1/7 drops only those.
      */
-    void updateDepthMap(const uint16_t* depth_data, int width, int height);
+    void setConfidenceFloor(float min_confidence);
+    float getConfidenceFloor() const { return min_confidence_level_ / 7.0f; }
 
     /**
      * Get depth value at pixel coordinates
@@ -90,6 +130,17 @@ public:
      */
     float getDepthAt(int x, int y) const;
 
+    /**
+     * Get sample confidence at pixel coordinates
+     * @return Confidence 0-1, or -1 if out of bounds
+     */
+    float getConfidenceAt(int x, int y) const;
+
+    /**
+     * Fraction of samples in the last frame that passed the confidence floor
+     */
+    float getValidFraction() const { return valid_fraction_; }
+
     /**
      * Get depth at normalized coordinates (0-1)
      */
@@ -133,6 +184,61 @@ public:
         int rgb_height
     );
 
+    /**
+     * Height features from the body point distribution.
+     *
+     * Deprojects a capped grid of samples inside the box (at most 64x64) and
+     * bins their heights in a fixed 1 cm histogram, so percentiles need no
+     * sort. Cost is bounded regardless of box or sensor resolution.
+     * @param person_bbox Person bounding box (normalized coords)
+     */
+    BodyHeightFeatures computeBodyHeight(const BoundingBox& person_bbox) const;
+
+    /**
+     * Feed the bed-surface estimate with one band of the bed zone.
+     *
+     * Call every frame; the zone is scanned in BED_SCAN_BANDS interleaved
+     * row bands (one per call), so each call costs at most ~1k samples.
+     * Only updates while the bed is empty or the patient is still; points
+     * inside the (padded) person box are skipped.
+     * @param person_bbox Person box, or nullptr if nobody is detected
+     * @param patient_still Whether the scene is currently still
+     */
+    void updateBedSurface(const BoundingBox* person_bbox, bool patient_still);
+
+    /**
+     * Height above the mattress and fraction past the bed edge for the
+     * points inside the person box (at most 48x48 samples)
+     */
+    BedOccupancy measureBedOccupancy(const BoundingBox& person_bbox) const;
+
+    /**
+     * Whether a mattress plane has been estimated
+     */
+    bool hasBedSurface() const { return bed_surface_.hasPlane(); }
+
+    /**
+     * Fix the floor level instead of estimating it from the scene
+     * @param floor_y Floor position along the camera y axis (meters, down is positive)
+     */
+    void setFloorLevel(float floor_y);
+
+    /**
+     * Current floor level along the camera y axis, or NaN if unknown
+     */
+    float getFloorLevel() const;
+
+    /**
+     * Signed depth tilt across the person box (lying orientation cue)
+     *
+     * Compares mean depth of the left and right thirds of the torso band.
+     * Sampling is capped, so cost is constant regardless of box size.
+     * @param person_bbox Person bounding box (normalized coords)
+     * @return (right - left) depth difference per meter of body width,
+     *         or NaN if there is not enough valid depth
+     */
+    float estimateLateralTilt(const BoundingBox& person_bbox) const;
+
     /**
      * Configure bed region for proximity detection
      * @param center 3D position of bed center
@@ -140,6 +246,14 @@ public:
      */
     void setBedRegion(const Position3D& center, float radius_meters);
 
+    /**
+     * Configure the bed region from a detected bed box: center at the
+     * box's depth, radius from its metric half-diagonal (clamped 0.8-2 m)
+     * @param bed_bbox Bed bounding box (normalized coords)
+     * @return false if there is no valid depth in the box
+     */
+    bool setBedRegionFromBox(const BoundingBox& bed_bbox, int rgb_width, int rgb_height);
+
     /**
      * Get average distance to person (last measurement)
      */
@@ -150,6 +264,21 @@ public:
      */
     bool hasDepthData() const { return initialized_ && !depth_map_.empty(); }
 
+    /**
+     * Decoded range plane (mm, 0 = invalid), row-major width x height
+     */
+    const uint16_t* getRangePlane() const { return depth_map_.data(); }
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+
+    /**
+     * Drop geometry learned for the current camera pose (floor level,
+     * mattress plane, position and head-height history) so it is
+     * re-estimated from the next frames. Call when the camera has moved.
+     * A fixed floor level is released too - it no longer matches the view.
+     */
+    void invalidateCalibration();
+
     /**
      * Reset state (call when patient changes)
      */
@@ -160,8 +289,11 @@ private:
     int width_ = 0;
     int height_ = 0;
 
-    // Current depth map
-    std::vector<uint16_t> depth_map_;
+    // Decoded depth planes
+    std::vector<uint16_t> depth_map_;        // Range in mm, 0 = invalid/low confidence
+    std::vector<uint8_t> confidence_map_;    // Confidence level 0-7 (7 = 100%)
+    uint16_t min_confidence_level_ = 1;      // Drop samples below this level
+    float valid_fraction_ = 0.0f;
 
     // Temporal tracking for fall detection
     struct PositionSample {
@@ -171,6 +303,19 @@ private:
     std::deque<PositionSample> position_history_;
     static const size_t MAX_HISTORY_SIZE = 30;  // ~1 second at 30fps
 
+    // Head height history (longer window catches slow slides to the floor)
+    struct HeightSample {
+        float head_height;
+        int64_t timestamp_ms;
+    };
+    std::deque<HeightSample> head_history_;
+    int64_t head_window_ms_ = 3000;
+
+    // Floor level along camera y (estimated from the scene unless fixed)
+    float floor_y_ = 0.0f;
+    bool floor_valid_ = false;
+    bool floor_fixed_ = false;
+
     // Fall detection thresholds
     float fall_drop_threshold_ = 0.5f;     // 0.5m drop = fall
     float fall_velocity_threshold_ = 1.5f;  // 1.5 m/s = fall speed
@@ -180,6 +325,11 @@ private:
     Position3D bed_center_ = {0, 0, 2.0f};  // Default: 2m from camera
     float bed_radius_ = 1.5f;                // 1.5m radius
 
+    // Mattress plane, scanned in interleaved row bands
+    BedSurfaceEstimator bed_surface_;
+    static const int BED_SCAN_BANDS = 4;
+    int bed_scan_band_ = 0;
+
     // Camera intrinsics (approximate for typical ToF sensor)
     float focal_length_x_ = 500.0f;
     float focal_length_y_ = 500.0f;
@@ -188,11 +338,15 @@ private:
 
     // Last measurements
     float last_distance_ = 0.0f;
-    Position3D last_position_ = {0, 0, 0};
+    Position3D last_position_ = {0, 0, 0};   // Previous analyzeMotion position
 
     // Helper functions
     float medianDepthInRegion(int x1, int y1, int x2, int y2) const;
+    size_t decodeDepth16(const uint16_t* src, size_t count, size_t dst_offset);
     void updatePositionHistory(const Position3D& pos);
+    void updateFloorEstimate();
+    void updateHeadHistory(float head_height, int64_t now_ms, float& fast_drop,
+                           float& fast_velocity, float& total_drop);
     float calculateVerticalDrop() const;
     float calculateDropVelocity() const;
     int64_t getCurrentTimeMs() const;
@@ -0,0 +1,171 @@
+#include "duty_cycle_controller.h"
+#include <android/log.h>
+#include <algorithm>
+
+#define LOG_TAG "DutyCycle"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+static_assert(sizeof(DutyCycleStats::ms_in_mode) / sizeof(int64_t) == DutyCycleController::NUM_MODES,
+              "one time counter per mode");
+
+namespace {
+// A frame a little early is still admitted (camera timestamps jitter)
+constexpr float PACING_SLACK = 0.9f;
+
+// NaN (not measured) never crosses a threshold
+bool above(float value, float threshold) {
+    return !std::isnan(value) && value >= threshold;
+}
+}
+
+const char* dutyModeName(DutyMode mode) {
+    switch (mode) {
+        case DutyMode::FULL:
+            return "full";
+        case DutyMode::MOTION_ONLY:
+            return "motion_only";
+        default:
+            return "depth_only";
+    }
+}
+
+DutyCycleController::DutyCycleController() {
+}
+
+DutyCycleController::~DutyCycleController() {
+}
+
+void DutyCycleController::init(const DutyCycleConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    config_.idle_fps = std::max(config_.idle_fps, 0.1f);
+    LOGI("Duty cycling initialized (idle after %llds, %.1f fps idle)",
+         (long long)(config_.idle_after_ms / 1000), config_.idle_fps);
+}
+
+void DutyCycleController::setEnabled(bool enabled, int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (enabled == enabled_) return;
+    enabled_ = enabled;
+    if (!enabled && mode_ != DutyMode::FULL) {
+        last_wake_reason_ = "disabled";
+        switchTo(DutyMode::FULL, now_ms);
+    }
+    LOGI("Duty cycling %s", enabled ? "enabled" : "disabled");
+}
+
+bool DutyCycleController::isEnabled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return enabled_;
+}
+
+DutyMode DutyCycleController::getMode() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mode_;
+}
+
+bool DutyCycleController::admitFrame(int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (mode_ != DutyMode::FULL && last_admit_ms_ >= 0 &&
+        (now_ms - last_admit_ms_) < PACING_SLACK * 1000.0f / config_.idle_fps) {
+        frames_skipped_++;
+        return false;
+    }
+    last_admit_ms_ = now_ms;
+    frames_processed_++;
+    return true;
+}
+
+DutyMode DutyCycleController::update(const DutyCycleSignals& signals, bool depth_ready,
+                                     int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (mode_since_ms_ < 0) {
+        mode_since_ms_ = now_ms;
+    }
+
+    if (mode_ == DutyMode::FULL) {
+        if (!std::isnan(signals.height_above_bed)) {
+            bed_height_ = signals.height_above_bed;
+        }
+        // A wake is followed by a spell at full rate, so a patient who
+        // stirs and settles is seen properly before the next idle
+        if (enabled_ && !signals.alert && signals.still_ms >= config_.idle_after_ms &&
+            now_ms - mode_since_ms_ >= config_.wake_hold_ms) {
+            idle_entries_++;
+            switchTo(depth_ready ? DutyMode::DEPTH_ONLY : DutyMode::MOTION_ONLY, now_ms);
+        }
+        return mode_;
+    }
+
+    const char* reason = wakeReason(signals);
+    if (reason) {
+        wakes_++;
+        last_wake_reason_ = reason;
+        switchTo(DutyMode::FULL, now_ms);
+    } else if (mode_ == DutyMode::DEPTH_ONLY && !depth_ready) {
+        // Depth stream stopped: keep watching with the camera
+        switchTo(DutyMode::MOTION_ONLY, now_ms);
+    }
+    return mode_;
+}
+
+const char* DutyCycleController::wakeReason(const DutyCycleSignals& signals) const {
+    if (signals.alert) return "alert";
+    if (above(signals.motion_cells, config_.wake_motion_cells)) return "motion";
+    if (signals.lighting_change) return "lighting";
+    if (above(signals.depth_motion, config_.wake_depth_motion)) return "depth_motion";
+    if (above(signals.head_drop_meters, config_.wake_head_drop)) return "head_drop";
+    if (above(signals.over_bed_edge, config_.wake_over_edge)) return "bed_edge";
+    if (!std::isnan(bed_height_) &&
+        above(signals.height_above_bed - bed_height_, config_.wake_sit_up)) return "sit_up";
+    return nullptr;
+}
+
+DutyCycleStats DutyCycleController::getStats(int64_t now_ms) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DutyCycleStats stats;
+    stats.mode = mode_;
+    stats.enabled = enabled_;
+    stats.idle_entries = idle_entries_;
+    stats.wakes = wakes_;
+    stats.frames_processed = frames_processed_;
+    stats.frames_skipped = frames_skipped_;
+    for (int i = 0; i < NUM_MODES; i++) {
+        stats.ms_in_mode[i] = ms_in_mode_[i];
+    }
+    if (mode_since_ms_ >= 0) {
+        stats.ms_in_mode[static_cast<int>(mode_)] += std::max<int64_t>(0, now_ms - mode_since_ms_);
+    }
+    stats.last_wake_reason = last_wake_reason_;
+    return stats;
+}
+
+void DutyCycleController::reset(int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    mode_ = DutyMode::FULL;
+    mode_since_ms_ = now_ms;
+    std::fill(ms_in_mode_, ms_in_mode_ + NUM_MODES, 0);
+    idle_entries_ = 0;
+    wakes_ = 0;
+    last_wake_reason_ = "";
+    bed_height_ = NAN;
+    last_admit_ms_ = -1;
+    frames_processed_ = 0;
+    frames_skipped_ = 0;
+}
+
+void DutyCycleController::switchTo(DutyMode mode, int64_t now_ms) {
+    if (mode_since_ms_ >= 0) {
+        ms_in_mode_[static_cast<int>(mode_)] += std::max<int64_t>(0, now_ms - mode_since_ms_);
+    }
+    mode_since_ms_ = now_ms;
+
+    LOGI("Mode %s -> %s%s%s", dutyModeName(mode_), dutyModeName(mode),
+         mode == DutyMode::FULL ? " on " : "",
+         mode == DutyMode::FULL ? last_wake_reason_ : "");
+    mode_ = mode;
+}
+
+} // namespace triage
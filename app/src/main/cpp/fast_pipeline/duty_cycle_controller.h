@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+
+namespace triage {
+
+/**
+ * What the fast pipeline runs on an admitted frame
+ */
+enum class DutyMode {
+    FULL = 0,            // Detection, pose, motion and depth at the camera rate
+    MOTION_ONLY = 1,     // RGB frame differencing at the idle rate; YOLO idle
+    DEPTH_ONLY = 2       // Depth motion and fall precursors at the idle rate; YOLO idle
+};
+
+/**
+ * Mode name as reported in JSON ("full", "motion_only", "depth_only")
+ */
+const char* dutyModeName(DutyMode mode);
+
+/**
+ * Duty cycling thresholds
+ */
+struct DutyCycleConfig {
+    int64_t idle_after_ms = 300000;      // Continuous stillness before idling
+    int64_t wake_hold_ms = 30000;        // Full rate kept after a wake at the least
+    float idle_fps = 2.0f;               // Frame rate while idle
+    float wake_motion_cells = 0.03f;     // Active motion-grid cells that wake (2 of 64)
+    float wake_depth_motion = 0.5f;      // Depth motion level that wakes (~5 cm per frame)
+    float wake_head_drop = 0.15f;        // Head drop (m) that wakes
+    float wake_sit_up = 0.20f;           // Rise above the bed (m) since idling that wakes
+    float wake_over_edge = 0.20f;        // Body fraction past the bed edge that wakes
+};
+
+/**
+ * One frame's inputs. NaN marks a signal not measured this frame.
+ */
+struct DutyCycleSignals {
+    int64_t still_ms = 0;                // Continuous stillness (motion analyzer)
+    bool alert = false;                  // Fall or other alarm raised: never idle
+    float motion_cells = NAN;            // Fraction of active motion-grid cells
+    bool lighting_change = false;        // Global brightness jump (lights on)
+    float depth_motion = NAN;            // Depth motion level (0-1)
+    float head_drop_meters = NAN;        // Head drop over the recent window
+    float height_above_bed = NAN;        // Patient height above the mattress
+    float over_bed_edge = NAN;           // Body fraction past the bed extent
+};
+
+/**
+ * Duty cycling statistics
+ */
+struct DutyCycleStats {
+    DutyMode mode;
+    bool enabled;
+    uint32_t idle_entries;
+    uint32_t wakes;
+    uint64_t frames_processed;
+    uint64_t frames_skipped;             // Over the idle rate
+    int64_t ms_in_mode[3];               // Time spent in each mode
+    const char* last_wake_reason;        // "" before the first wake
+};
+
+/**
+ * Drops the fast pipeline to a low-rate watch while a patient lies still
+ * (typically asleep at night) and returns to full rate on the frame that
+ * shows activity.
+ *
+ * After idle_after_ms of continuous stillness the controller enters
+ * DEPTH_ONLY when depth and a person box are available (ToF works in the
+ * dark), else MOTION_ONLY, and admits frames at idle_fps. YOLO and pose
+ * are not run while idle; the weights stay loaded so a wake costs no
+ * reload.
+ *
+ * Every idle frame is checked for a wake: a motion or depth spike, a
+ * lighting change, or a fall precursor (head drop, sitting up from the
+ * mattress, body over the bed edge). The caller runs the full pipeline on
+ * that same frame.
+ */
+class DutyCycleController {
+public:
+    static const int NUM_MODES = 3;
+
+    DutyCycleController();
+    ~DutyCycleController();
+
+    void init(const DutyCycleConfig& config = DutyCycleConfig());
+
+    /**
+     * Allow idling (disabling wakes at once)
+     */
+    void setEnabled(bool enabled, int64_t now_ms);
+    bool isEnabled() const;
+
+    DutyMode getMode() const;
+    bool isIdle() const { return getMode() != DutyMode::FULL; }
+
+    /**
+     * Frame pacing at the idle rate (every frame is admitted at full rate)
+     * @return true if a frame arriving at now_ms should be processed
+     */
+    bool admitFrame(int64_t now_ms);
+
+    /**
+     * Feed an admitted frame's signals
+     * @param depth_ready Depth map and a person box to measure it on
+     * @return Mode for the rest of this frame: FULL after a wake
+     */
+    DutyMode update(const DutyCycleSignals& signals, bool depth_ready, int64_t now_ms);
+
+    DutyCycleStats getStats(int64_t now_ms) const;
+
+    void reset(int64_t now_ms);
+
+private:
+    mutable std::mutex mutex_;
+    DutyCycleConfig config_;
+    bool enabled_ = false;
+
+    DutyMode mode_ = DutyMode::FULL;
+    int64_t mode_since_ms_ = -1;
+    int64_t ms_in_mode_[NUM_MODES] = {};
+    uint32_t idle_entries_ = 0;
+    uint32_t wakes_ = 0;
+    const char* last_wake_reason_ = "";
+
+    // Last full-rate reading, the reference for the sit-up precursor
+    float bed_height_ = NAN;
+
+    int64_t last_admit_ms_ = -1;
+    uint64_t frames_processed_ = 0;
+    uint64_t frames_skipped_ = 0;
+
+    const char* wakeReason(const DutyCycleSignals& signals) const;
+    void switchTo(DutyMode mode, int64_t now_ms);
+};
+
+} // namespace triage
@@ -0,0 +1,234 @@
+#include "frame_synchronizer.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#define LOG_TAG "FrameSynchronizer"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+FrameSynchronizer::FrameSynchronizer() {
+    init();
+}
+
+FrameSynchronizer::~FrameSynchronizer() {
+}
+
+void FrameSynchronizer::init(int64_t tolerance_ns, int capacity) {
+    tolerance_ns_ = std::max<int64_t>(tolerance_ns, 0);
+    capacity_ = std::max(capacity, 1);
+    rgb_.slots.assign(capacity_, Slot());
+    depth_.slots.assign(capacity_, Slot());
+    reset();
+}
+
+bool FrameSynchronizer::submitRgb(const uint8_t* rgba, int width, int height, int row_stride,
+                                  int64_t timestamp_ns, SyncedPair& out) {
+    if (rgba == nullptr || width <= 0 || height <= 0 || row_stride < width * 4) {
+        LOGE("Invalid RGB frame %dx%d (stride %d)", width, height, row_stride);
+        return false;
+    }
+    rgb_frames_++;
+
+    // Out-of-order timestamps break the sorted ring - start over
+    if (timestamp_ns <= last_rgb_ns_) {
+        dropOldest(rgb_, rgb_.count, dropped_rgb_);
+    }
+    last_rgb_ns_ = timestamp_ns;
+
+    int idx = findNearest(depth_, timestamp_ns);
+    if (idx < 0) {
+        // Buffer until a depth frame arrives; drop ones no depth can match anymore
+        prune(rgb_, last_depth_ns_ - tolerance_ns_, dropped_rgb_);
+        Slot& slot = push(rgb_, timestamp_ns, dropped_rgb_);
+        storeRows(slot, rgba, width, height, row_stride, 4);
+        return false;
+    }
+
+    // Matched on arrival: hand the caller's pixels straight through
+    const uint8_t* pixels = rgba;
+    if (row_stride != width * 4) {
+        storeRows(scratch_, rgba, width, height, row_stride, 4);
+        pixels = scratch_.data.data();
+    }
+
+    const Slot& d = depth_.at(idx);
+    out.rgba = pixels;
+    out.rgb_width = width;
+    out.rgb_height = height;
+    out.rgb_timestamp_ns = timestamp_ns;
+    out.depth = reinterpret_cast<const uint16_t*>(d.data.data());
+    out.depth_width = d.width;
+    out.depth_height = d.height;
+    out.depth_timestamp_ns = d.timestamp_ns;
+    out.delta_ns = std::llabs(timestamp_ns - d.timestamp_ns);
+
+    // Older depth frames can no longer be closest to a later RGB frame
+    dropOldest(depth_, idx, dropped_depth_);
+    consumeOldest(depth_);
+    recordPair(out.delta_ns);
+    return true;
+}
+
+bool FrameSynchronizer::submitDepth(const uint16_t* depth, int width, int height, int row_stride,
+                                    int64_t timestamp_ns, SyncedPair& out) {
+    if (depth == nullptr || width <= 0 || height <= 0 || row_stride < width * 2) {
+        LOGE("Invalid depth frame %dx%d (stride %d)", width, height, row_stride);
+        return false;
+    }
+    depth_frames_++;
+
+    if (timestamp_ns <= last_depth_ns_) {
+        dropOldest(depth_, depth_.count, dropped_depth_);
+    }
+    last_depth_ns_ = timestamp_ns;
+
+    int idx = findNearest(rgb_, timestamp_ns);
+    if (idx < 0) {
+        prune(depth_, last_rgb_ns_ - tolerance_ns_, dropped_depth_);
+        Slot& slot = push(depth_, timestamp_ns, dropped_depth_);
+        storeRows(slot, reinterpret_cast<const uint8_t*>(depth), width, height, row_stride, 2);
+        return false;
+    }
+
+    const uint16_t* samples = depth;
+    if (row_stride != width * 2) {
+        storeRows(scratch_, reinterpret_cast<const uint8_t*>(depth), width, height, row_stride, 2);
+        samples = reinterpret_cast<const uint16_t*>(scratch_.data.data());
+    }
+
+    const Slot& r = rgb_.at(idx);
+    out.rgba = r.data.data();
+    out.rgb_width = r.width;
+    out.rgb_height = r.height;
+    out.rgb_timestamp_ns = r.timestamp_ns;
+    out.depth = samples;
+    out.depth_width = width;
+    out.depth_height = height;
+    out.depth_timestamp_ns = timestamp_ns;
+    out.delta_ns = std::llabs(timestamp_ns - r.timestamp_ns);
+
+    // Older RGB frames can no longer be closest to a later depth frame
+    dropOldest(rgb_, idx, dropped_rgb_);
+    consumeOldest(rgb_);
+    recordPair(out.delta_ns);
+    return true;
+}
+
+SyncStats FrameSynchronizer::getStats() const {
+    SyncStats stats = {};
+    stats.rgb_frames = rgb_frames_;
+    stats.depth_frames = depth_frames_;
+    stats.synced_pairs = synced_pairs_;
+    stats.dropped_rgb = dropped_rgb_;
+    stats.dropped_depth = dropped_depth_;
+    stats.mean_delta_ms = synced_pairs_ > 0 ? static_cast<float>(delta_sum_ms_ / synced_pairs_) : 0.0f;
+    stats.rgb_buffered = rgb_.count;
+    stats.depth_buffered = depth_.count;
+    return stats;
+}
+
+void FrameSynchronizer::reset() {
+    rgb_.head = rgb_.count = 0;
+    depth_.head = depth_.count = 0;
+    last_rgb_ns_ = 0;
+    last_depth_ns_ = 0;
+    rgb_frames_ = 0;
+    depth_frames_ = 0;
+    synced_pairs_ = 0;
+    dropped_rgb_ = 0;
+    dropped_depth_ = 0;
+    delta_sum_ms_ = 0.0;
+}
+
+int FrameSynchronizer::findNearest(const Ring& ring, int64_t timestamp_ns) const {
+    if (ring.count == 0) {
+        return -1;
+    }
+
+    // First frame at or after timestamp (binary search over the sorted ring)
+    int lo = 0, hi = ring.count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (ring.at(mid).timestamp_ns < timestamp_ns) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    int best = -1;
+    int64_t best_delta = tolerance_ns_ + 1;
+    for (int i = std::max(lo - 1, 0); i <= std::min(lo, ring.count - 1); i++) {
+        int64_t delta = std::llabs(ring.at(i).timestamp_ns - timestamp_ns);
+        if (delta < best_delta) {
+            best = i;
+            best_delta = delta;
+        }
+    }
+    return best;
+}
+
+void FrameSynchronizer::dropOldest(Ring& ring, int n, uint64_t& dropped) {
+    n = std::min(n, ring.count);
+    ring.count -= n;
+    dropped += n;
+}
+
+// Released slots keep their storage until the ring wraps onto them, so a
+// pair handed out stays valid until the next submit
+void FrameSynchronizer::consumeOldest(Ring& ring) {
+    if (ring.count > 0) ring.count--;
+}
+
+void FrameSynchronizer::prune(Ring& ring, int64_t before_ns, uint64_t& dropped) {
+    int n = 0;
+    while (n < ring.count && ring.at(n).timestamp_ns < before_ns) {
+        n++;
+    }
+    dropOldest(ring, n, dropped);
+}
+
+FrameSynchronizer::Slot& FrameSynchronizer::push(Ring& ring, int64_t timestamp_ns, uint64_t& dropped) {
+    if (ring.count == capacity_) {
+        dropOldest(ring, 1, dropped);
+    }
+    Slot& slot = ring.slots[ring.head];
+    slot.timestamp_ns = timestamp_ns;
+    ring.head = (ring.head + 1) % capacity_;
+    ring.count++;
+    return slot;
+}
+
+void FrameSynchronizer::storeRows(Slot& slot, const uint8_t* src, int width, int height,
+                                  int row_stride, int bytes_per_pixel) {
+    size_t row_bytes = static_cast<size_t>(width) * bytes_per_pixel;
+    slot.width = width;
+    slot.height = height;
+    slot.data.resize(row_bytes * height);  // No reallocation once sized
+
+    if (static_cast<size_t>(row_stride) == row_bytes) {
+        memcpy(slot.data.data(), src, row_bytes * height);
+        return;
+    }
+    for (int y = 0; y < height; y++) {
+        memcpy(slot.data.data() + y * row_bytes, src + static_cast<size_t>(y) * row_stride, row_bytes);
+    }
+}
+
+void FrameSynchronizer::recordPair(int64_t delta_ns) {
+    synced_pairs_++;
+    delta_sum_ms_ += delta_ns / 1e6;
+
+    if (synced_pairs_ % 300 == 0) {
+        LOGI("Sync stats: pairs=%llu, rgb=%llu, depth=%llu, dropped=%llu/%llu, mean delta=%.1fms",
+             (unsigned long long)synced_pairs_, (unsigned long long)rgb_frames_,
+             (unsigned long long)depth_frames_, (unsigned long long)dropped_rgb_,
+             (unsigned long long)dropped_depth_, delta_sum_ms_ / synced_pairs_);
+    }
+}
+
+} // namespace triage
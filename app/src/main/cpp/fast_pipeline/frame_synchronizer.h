@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace triage {
+
+/**
+ * A matched RGB + depth pair.
+ *
+ * Pointers are valid until the next submit call on the synchronizer.
+ */
+struct SyncedPair {
+    const uint8_t* rgba;         // RGBA, tightly packed
+    int rgb_width;
+    int rgb_height;
+    int64_t rgb_timestamp_ns;
+
+    const uint16_t* depth;       // DEPTH16, tightly packed
+    int depth_width;
+    int depth_height;
+    int64_t depth_timestamp_ns;
+
+    int64_t delta_ns;            // |rgb - depth|
+};
+
+/**
+ * Synchronizer statistics
+ */
+struct SyncStats {
+    uint64_t rgb_frames;
+    uint64_t depth_frames;
+    uint64_t synced_pairs;
+    uint64_t dropped_rgb;        // Evicted or pruned without a match
+    uint64_t dropped_depth;
+    float mean_delta_ms;         // Mean |rgb - depth| of matched pairs
+    int rgb_buffered;
+    int depth_buffered;
+};
+
+/**
+ * Matches RGB and depth frames by timestamp.
+ *
+ * Each stream has a fixed-capacity ring of preallocated slots kept in
+ * timestamp order (camera timestamps are monotonic per stream), so the
+ * nearest frame of the other stream is found by binary search in O(log n).
+ * A packed frame that matches on arrival is passed through without a copy;
+ * an unmatched frame is copied once into a slot whose storage is reused,
+ * so steady-state operation does not allocate.
+ */
+class FrameSynchronizer {
+public:
+    FrameSynchronizer();
+    ~FrameSynchronizer();
+
+    /**
+     * Configure matching
+     * @param tolerance_ns Maximum |rgb - depth| for a pair (default one frame @ 30fps)
+     * @param capacity Frames buffered per stream
+     */
+    void init(int64_t tolerance_ns = 33000000, int capacity = 8);
+
+    /**
+     * Submit an RGBA frame
+     * @param row_stride Bytes per row (>= width * 4)
+     * @param out Matched pair if a depth frame was within tolerance
+     * @return true if out holds a new pair
+     */
+    bool submitRgb(const uint8_t* rgba, int width, int height, int row_stride,
+                   int64_t timestamp_ns, SyncedPair& out);
+
+    /**
+     * Submit a DEPTH16 frame
+     * @param row_stride Bytes per row (>= width * 2)
+     * @param out Matched pair if an RGB frame was within tolerance
+     * @return true if out holds a new pair
+     */
+    bool submitDepth(const uint16_t* depth, int width, int height, int row_stride,
+                     int64_t timestamp_ns, SyncedPair& out);
+
+    SyncStats getStats() const;
+
+    int64_t getToleranceNs() const { return tolerance_ns_; }
+
+    /**
+     * Drop all buffered frames and statistics
+     */
+    void reset();
+
+private:
+    struct Slot {
+        int64_t timestamp_ns = 0;
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> data;   // Packed pixels (storage reused)
+    };
+
+    // Timestamp-ordered ring: logical index 0 is the oldest frame
+    struct Ring {
+        std::vector<Slot> slots;
+        int head = 0;                // Next write position
+        int count = 0;
+
+        Slot& at(int i) { return slots[(head - count + i + slots.size()) % slots.size()]; }
+        const Slot& at(int i) const { return slots[(head - count + i + slots.size()) % slots.size()]; }
+    };
+
+    int64_t tolerance_ns_ = 33000000;
+    int capacity_ = 8;
+
+    Ring rgb_;
+    Ring depth_;
+    Slot scratch_;               // Packs padded rows of a frame matched on arrival
+
+    // Latest timestamp seen per stream (for pruning)
+    int64_t last_rgb_ns_ = 0;
+    int64_t last_depth_ns_ = 0;
+
+    uint64_t rgb_frames_ = 0;
+    uint64_t depth_frames_ = 0;
+    uint64_t synced_pairs_ = 0;
+    uint64_t dropped_rgb_ = 0;
+    uint64_t dropped_depth_ = 0;
+    double delta_sum_ms_ = 0.0;
+
+    int findNearest(const Ring& ring, int64_t timestamp_ns) const;
+    void dropOldest(Ring& ring, int n, uint64_t& dropped);
+    void consumeOldest(Ring& ring);
+    void prune(Ring& ring, int64_t before_ns, uint64_t& dropped);
+    Slot& push(Ring& ring, int64_t timestamp_ns, uint64_t& dropped);
+    void storeRows(Slot& slot, const uint8_t* src, int width, int height,
+                   int row_stride, int bytes_per_pixel);
+    void recordPair(int64_t delta_ns);
+};
+
+} // namespace triage
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace triage {
+
+/**
+ * Pixel layouts of Bitmaps and camera frames
+ */
+enum class PixelFormat {
+    RGBA_8888 = 0,   // Bitmap ARGB_8888 (R, G, B, A in memory)
+    RGB_888 = 1,     // Packed RGB
+    BGRA_8888 = 2,   // B, G, R, A in memory
+    RGB_565 = 3,     // Bitmap RGB_565 (16-bit little-endian, R in the top bits)
+    NV21 = 4         // Camera YUV 4:2:0: Y plane + interleaved V/U plane
+};
+
+/**
+ * Bytes per pixel of the main plane (the Y plane for NV21)
+ */
+inline int bytesPerPixel(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::RGB_888: return 3;
+        case PixelFormat::RGB_565: return 2;
+        case PixelFormat::NV21: return 1;
+        default: return 4;
+    }
+}
+
+/**
+ * Non-owning view of an image with row padding.
+ *
+ * Rows are stride bytes apart (>= width * bytesPerPixel), so Bitmaps
+ * and camera planes are used as they come, without repacking. crop()
+ * returns a sub-view of the same memory. NV21 views also carry the
+ * half-resolution V/U plane.
+ */
+struct ImageView {
+    const uint8_t* data = nullptr;
+    int width = 0;
+    int height = 0;
+    int stride = 0;                              // Bytes per row
+    PixelFormat format = PixelFormat::RGBA_8888;
+    const uint8_t* chroma = nullptr;             // NV21 V/U plane
+    int chroma_stride = 0;
+
+    ImageView() = default;
+
+    ImageView(const uint8_t* data, int width, int height, int stride,
+              PixelFormat format = PixelFormat::RGBA_8888)
+        : data(data), width(width), height(height), stride(stride), format(format) {}
+
+    /**
+     * NV21 frame from its two planes
+     * @param vu Interleaved V/U samples, one pair per 2x2 block
+     */
+    static ImageView nv21(const uint8_t* y, int width, int height, int y_stride,
+                          const uint8_t* vu, int vu_stride) {
+        ImageView view(y, width, height, y_stride, PixelFormat::NV21);
+        view.chroma = vu;
+        view.chroma_stride = vu_stride;
+        return view;
+    }
+
+    /**
+     * View of tightly packed rows
+     */
+    static ImageView packed(const uint8_t* data, int width, int height,
+                            PixelFormat format = PixelFormat::RGBA_8888) {
+        return ImageView(data, width, height, width * bytesPerPixel(format), format);
+    }
+
+    int bpp() const { return bytesPerPixel(format); }
+    bool empty() const { return data == nullptr || width <= 0 || height <= 0; }
+    bool isPacked() const { return stride == width * bpp(); }
+
+    const uint8_t* row(int y) const { return data + static_cast<ptrdiff_t>(y) * stride; }
+    const uint8_t* pixel(int x, int y) const { return row(y) + x * bpp(); }
+
+    /**
+     * V/U row covering image row y (NV21 only)
+     */
+    const uint8_t* chromaRow(int y) const {
+        return chroma + static_cast<ptrdiff_t>(y / 2) * chroma_stride;
+    }
+
+    /**
+     * Sub-view of a region, clamped to the image (no copy). NV21 crops
+     * start on even coordinates so they share the 2x2 chroma blocks.
+     */
+    ImageView crop(int x, int y, int w, int h) const {
+        if (format == PixelFormat::NV21) {
+            w += x & 1;
+            h += y & 1;
+            x &= ~1;
+            y &= ~1;
+        }
+        x = std::max(0, std::min(x, width));
+        y = std::max(0, std::min(y, height));
+        w = std::max(0, std::min(w, width - x));
+        h = std::max(0, std::min(h, height - y));
+        ImageView view(data ? pixel(x, y) : nullptr, w, h, stride, format);
+        if (chroma) {
+            view.chroma = chromaRow(y) + x;
+            view.chroma_stride = chroma_stride;
+        }
+        return view;
+    }
+};
+
+/**
+ * Non-owning view of a DEPTH16 plane with row padding (stride in bytes,
+ * as reported by android.media.Image.Plane.getRowStride())
+ */
+struct DepthView {
+    const uint16_t* data = nullptr;
+    int width = 0;
+    int height = 0;
+    int stride = 0;                              // Bytes per row
+
+    DepthView() = default;
+
+    DepthView(const uint16_t* data, int width, int height, int stride)
+        : data(data), width(width), height(height), stride(stride) {}
+
+    static DepthView packed(const uint16_t* data, int width, int height) {
+        return DepthView(data, width, height, width * static_cast<int>(sizeof(uint16_t)));
+    }
+
+    bool empty() const { return data == nullptr || width <= 0 || height <= 0; }
+    bool isPacked() const { return stride == width * static_cast<int>(sizeof(uint16_t)); }
+
+    const uint16_t* row(int y) const {
+        return reinterpret_cast<const uint16_t*>(
+            reinterpret_cast<const uint8_t*>(data) + static_cast<ptrdiff_t>(y) * stride);
+    }
+
+    /**
+     * Sub-view of a region, clamped to the plane (no copy)
+     */
+    DepthView crop(int x, int y, int w, int h) const {
+        x = std::max(0, std::min(x, width));
+        y = std::max(0, std::min(y, height));
+        w = std::max(0, std::min(w, width - x));
+        h = std::max(0, std::min(h, height - y));
+        return DepthView(data ? row(y) + x : nullptr, w, h, stride);
+    }
+};
+
+} // namespace triage
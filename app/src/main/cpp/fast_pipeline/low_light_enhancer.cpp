@@ -0,0 +1,135 @@
+#include "low_light_enhancer.h"
+#include "pixel_kernels.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cmath>
+
+#define LOG_TAG "LowLightEnhancer"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+namespace {
+// Histogram subsample grid (~3000 pixels whatever the frame size)
+constexpr int SAMPLE_COLS = 64;
+constexpr int SAMPLE_ROWS = 48;
+// Enhancement stops this far above the start threshold
+constexpr float DARK_HYSTERESIS = 20.0f;
+// Gamma lifts the mean luma to this fraction of full scale
+constexpr float TARGET_MEAN = 0.45f;
+constexpr float MIN_GAMMA = 0.3f;
+// Equalization: bin clip (x mean bin height) and weight against gamma
+constexpr float CLIP_LIMIT = 3.0f;
+constexpr float EQ_WEIGHT = 0.4f;
+// Step towards each new curve (1 = jump)
+constexpr float CURVE_ALPHA = 0.5f;
+}
+
+LowLightEnhancer::LowLightEnhancer() {
+    setIdentity();
+}
+
+LowLightEnhancer::~LowLightEnhancer() {
+}
+
+void LowLightEnhancer::init(int refresh_frames, float dark_luma) {
+    refresh_frames_ = std::max(1, refresh_frames);
+    dark_luma_ = dark_luma;
+    reset();
+    LOGI("Low-light enhancer initialized (refresh=%d frames, dark below %.0f)",
+         refresh_frames_, dark_luma_);
+}
+
+void LowLightEnhancer::update(const ImageView& image) {
+    if (--frames_until_refresh_ > 0) {
+        return;
+    }
+    frames_until_refresh_ = refresh_frames_;
+
+    // Subsampled luma histogram
+    const int step_x = std::max(1, image.width / SAMPLE_COLS);
+    const int step_y = std::max(1, image.height / SAMPLE_ROWS);
+    const int cols = sampleCount(image.width, step_x / 2, step_x);
+    const int rows = sampleCount(image.height, step_y / 2, step_y);
+    samples_.resize(static_cast<size_t>(cols) * rows);
+    if (samples_.empty() ||
+        !sampleLuma(image, step_x / 2, step_y / 2, step_x, step_y, cols, rows, samples_.data())) {
+        return;
+    }
+
+    std::array<uint32_t, 256> hist{};
+    uint64_t luma_sum = 0;
+    for (uint8_t luma : samples_) {
+        hist[luma]++;
+        luma_sum += luma;
+    }
+    const uint32_t total = static_cast<uint32_t>(samples_.size());
+    mean_luma_ = static_cast<float>(luma_sum) / total;
+
+    const bool was_active = active_;
+    active_ = mean_luma_ < (active_ ? dark_luma_ + DARK_HYSTERESIS : dark_luma_);
+    if (active_ != was_active) {
+        LOGI("Low-light enhancement %s (mean luma %.1f)", active_ ? "on" : "off", mean_luma_);
+    }
+    if (!active_) {
+        setIdentity();
+        return;
+    }
+
+    std::array<float, 256> target;
+    buildCurve(hist, total, target);
+    for (int i = 0; i < 256; i++) {
+        curve_[i] += CURVE_ALPHA * (target[i] - curve_[i]);
+        lut_[i] = static_cast<uint8_t>(std::lround(std::max(0.0f, std::min(curve_[i], 255.0f))));
+    }
+}
+
+void LowLightEnhancer::buildCurve(const std::array<uint32_t, 256>& hist, uint32_t total,
+                                  std::array<float, 256>& curve) {
+    // Adaptive gamma: mean luma maps to TARGET_MEAN
+    const float mean = std::max(mean_luma_, 1.0f) / 255.0f;
+    gamma_ = std::max(MIN_GAMMA, std::min(std::log(TARGET_MEAN) / std::log(mean), 1.0f));
+
+    // Contrast-limited equalization: clip tall bins, spread the excess evenly
+    const float clip = CLIP_LIMIT * total / 256.0f;
+    float excess = 0.0f;
+    for (uint32_t count : hist) {
+        excess += std::max(0.0f, count - clip);
+    }
+    const float spread = excess / 256.0f;
+
+    float cdf = 0.0f;
+    float cdf_min = -1.0f;
+    std::array<float, 256> eq;
+    for (int i = 0; i < 256; i++) {
+        cdf += std::min(static_cast<float>(hist[i]), clip) + spread;
+        if (cdf_min < 0.0f) {
+            cdf_min = cdf;       // Darkest level stays black
+        }
+        eq[i] = cdf;
+    }
+    const float range = std::max(static_cast<float>(total) - cdf_min, 1.0f);
+
+    for (int i = 0; i < 256; i++) {
+        float g = 255.0f * std::pow(i / 255.0f, gamma_);
+        float e = 255.0f * (eq[i] - cdf_min) / range;
+        curve[i] = (1.0f - EQ_WEIGHT) * g + EQ_WEIGHT * e;
+    }
+}
+
+void LowLightEnhancer::setIdentity() {
+    gamma_ = 1.0f;
+    for (int i = 0; i < 256; i++) {
+        curve_[i] = static_cast<float>(i);
+        lut_[i] = static_cast<uint8_t>(i);
+    }
+}
+
+void LowLightEnhancer::reset() {
+    frames_until_refresh_ = 0;
+    active_ = false;
+    mean_luma_ = 128.0f;
+    setIdentity();
+}
+
+} // namespace triage
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "image_view.h"
+
+namespace triage {
+
+/**
+ * Brightens dark frames ahead of detection.
+ *
+ * Every few frames a luma histogram is taken from a subsample of the
+ * frame. If the scene is dark, a 256-entry tone curve is built from it:
+ * an adaptive gamma that lifts the mean luma towards mid-gray, blended
+ * with a contrast-limited histogram equalization (global CLAHE without
+ * tiles). The curve is eased towards each new estimate so detection
+ * input does not flicker as the estimate updates.
+ *
+ * The curve is an 8-bit table; the detector looks it up while it
+ * normalizes the model input, so no extra pass over the frame is made.
+ */
+class LowLightEnhancer {
+public:
+    LowLightEnhancer();
+    ~LowLightEnhancer();
+
+    /**
+     * @param refresh_frames Rebuild the curve every this many frames
+     * @param dark_luma Mean luma (0-255) below which enhancement starts;
+     *        it stops again above dark_luma + 20
+     */
+    void init(int refresh_frames = 15, float dark_luma = 60.0f);
+
+    /**
+     * Feed one frame; rebuilds the curve when due
+     * @param image View in any PixelFormat
+     */
+    void update(const ImageView& image);
+
+    /**
+     * Scene is dark enough for the curve to be applied
+     */
+    bool isActive() const { return active_; }
+
+    /**
+     * Tone curve, indexed by 8-bit channel value (identity when inactive)
+     */
+    const std::array<uint8_t, 256>& getLut() const { return lut_; }
+
+    float getMeanLuma() const { return mean_luma_; }
+    float getGamma() const { return gamma_; }
+
+    void reset();
+
+private:
+    int refresh_frames_ = 15;
+    float dark_luma_ = 60.0f;
+
+    int frames_until_refresh_ = 0;
+    bool active_ = false;
+    float mean_luma_ = 128.0f;
+    float gamma_ = 1.0f;
+
+    std::array<float, 256> curve_{};     // Eased curve (0-255)
+    std::array<uint8_t, 256> lut_{};
+    std::vector<uint8_t> samples_;       // Luma subsample of the frame
+
+    void buildCurve(const std::array<uint32_t, 256>& hist, uint32_t total,
+                    std::array<float, 256>& curve);
+    void setIdentity();
+};
+
+} // namespace triage
@@ -1,4 +1,6 @@
 #include "motion_analyzer.h"
+#include "pixel_kernels.h"
+#include "simd_kernels.h"
 #include <android/log.h>
 #include <cmath>
 #include <numeric>
@@ -25,22 +27,37 @@ void MotionAnalyzer::init(float stillness_threshold, int history_frames) {
          stillness_threshold, history_frames);
 }
 
-MotionState MotionAnalyzer::analyze(const uint8_t* pixels, int width, int height) {
+MotionState MotionAnalyzer::analyze(const ImageView& image) {
     MotionState state;
     state.motion_level = 0.0f;
     state.is_still = true;
+    state.active_cell_fraction = 0.0f;
+    state.lighting_change = false;
 
     auto now = std::chrono::system_clock::now();
     int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()).count();
 
-    // First frame - just store it
-    if (prev_frame_.empty() || prev_width_ != width || prev_height_ != height) {
-        int size = width * height * 4; // RGBA
-        prev_frame_.resize(size);
-        std::copy(pixels, pixels + size, prev_frame_.begin());
-        prev_width_ = width;
-        prev_height_ = height;
+    // Luma grid of this frame, decoded once whatever the pixel format
+    const int step = luma_step_;
+    const int cols = sampleCount(image.width, 0, step);
+    const int rows = sampleCount(image.height, 0, step);
+    cur_luma_.resize(static_cast<size_t>(cols) * rows);
+    if (!sampleLuma(image, 0, 0, step, step, cols, rows, cur_luma_.data())) {
+        state.last_motion_timestamp = last_motion_time_;
+        state.stillness_duration = 0;
+        return state;
+    }
+
+    // First frame (or new size / stride) - just store it
+    if (prev_luma_.empty() || frame_width_ != image.width || frame_height_ != image.height ||
+        grid_step_ != step) {
+        frame_width_ = image.width;
+        frame_height_ = image.height;
+        luma_cols_ = cols;
+        luma_rows_ = rows;
+        grid_step_ = step;
+        prev_luma_.swap(cur_luma_);
 
         state.last_motion_timestamp = now_ms;
         state.stillness_duration = 0;
@@ -51,7 +68,8 @@ MotionState MotionAnalyzer::analyze(const uint8_t* pixels, int width, int height
     }
 
     // Calculate motion between frames
-    float frame_diff = calculateFrameDifference(pixels, prev_frame_.data(), width, height);
+    float frame_diff = calculateFrameDifference(cur_luma_.data(), prev_luma_.data());
+    updateMotionHistory(now_ms);
 
     // Update motion history
     motion_history_.push_back(frame_diff);
@@ -73,57 +91,376 @@ MotionState MotionAnalyzer::analyze(const uint8_t* pixels, int width, int height
         stillness_start_time_ = now_ms;
     }
 
-    // Store current frame for next comparison
-    std::copy(pixels, pixels + width * height * 4, prev_frame_.begin());
+    // Keep this frame's luma for the next comparison
+    prev_luma_.swap(cur_luma_);
 
     // Build state
     state.motion_level = current_motion_level_;
     state.last_motion_timestamp = last_motion_time_;
     state.stillness_duration = now_ms - stillness_start_time_;
     state.is_still = !is_motion;
+    state.active_cell_fraction = active_cell_fraction_;
+    state.lighting_change = lighting_change_;
+
+    if (lighting_change_) {
+        LOGI("Lighting change compensated (gain=%.2f, offset=%.1f)", luma_gain_, luma_offset_);
+    }
 
     return state;
 }
 
+namespace {
+// Smallest photometric change worth compensating (histogram noise below)
+constexpr float GAIN_EPSILON = 0.04f;
+constexpr float OFFSET_EPSILON = 3.0f;
+// Change large enough to report as a lighting event
+constexpr float LIGHTING_GAIN = 0.15f;
+constexpr float LIGHTING_OFFSET = 12.0f;
+// Plausible gain range (very dark frames have almost no spread)
+constexpr float MIN_GAIN = 0.25f;
+constexpr float MAX_GAIN = 4.0f;
+
+/**
+ * Luma level (0-255) below which a fraction of the histogram lies,
+ * interpolated within the bin
+ */
+float histogramPercentile(const std::array<uint32_t, MotionAnalyzer::LUMA_BINS>& hist,
+                          uint32_t total, float fraction) {
+    const float bin_width = 256.0f / MotionAnalyzer::LUMA_BINS;
+    float target = fraction * total;
+    uint32_t below = 0;
+    for (int i = 0; i < MotionAnalyzer::LUMA_BINS; i++) {
+        if (below + hist[i] >= target && hist[i] > 0) {
+            return (i + (target - below) / hist[i]) * bin_width;
+        }
+        below += hist[i];
+    }
+    return 255.0f;
+}
+}
+
 float MotionAnalyzer::calculateFrameDifference(const uint8_t* current,
-                                                const uint8_t* previous,
-                                                int width, int height) {
-    // Downsample for efficiency
-    int step = 4; // Check every 4th pixel
-    int sample_count = 0;
-    float total_diff = 0.0f;
+                                                const uint8_t* previous) {
+    const int width = frame_width_;
+    const int height = frame_height_;
+    const int step = grid_step_;
+
+    // Everything is gathered in one pass: per-cell |diff| sums (the motion
+    // measure), luma moments (to test the photometric fit) and both
+    // histograms (for the fit itself)
+    std::fill(fine_moments_.begin(), fine_moments_.end(), CellMoments{});
+    hist_cur_.fill(0);
+    hist_prev_.fill(0);
+
+    // Moments are summed per column a grid row at a time (CPU-dispatched
+    // kernel) and folded into the MHI cells when a cell row is complete
+    const size_t cols = static_cast<size_t>(luma_cols_);
+    column_moments_.assign(cols * 6, 0);
+    const MomentColumns columns = {
+        column_moments_.data(), column_moments_.data() + cols,
+        column_moments_.data() + cols * 2, column_moments_.data() + cols * 3,
+        column_moments_.data() + cols * 4, column_moments_.data() + cols * 5
+    };
+    const auto accumulate_moments = simdKernels().accumulate_moments;
+    uint32_t rows_in_cell = 0;
+
+    for (int gy = 0; gy < luma_rows_; gy++) {
+        const int cell_y = gy * step * MHI_H / height;
+        const uint8_t* cur_row = current + static_cast<size_t>(gy) * luma_cols_;
+        const uint8_t* prev_row = previous + static_cast<size_t>(gy) * luma_cols_;
+
+        accumulate_moments(cur_row, prev_row, luma_cols_, columns);
+        rows_in_cell++;
+        for (int gx = 0; gx < luma_cols_; gx++) {
+            hist_cur_[cur_row[gx] * LUMA_BINS / 256]++;
+            hist_prev_[prev_row[gx] * LUMA_BINS / 256]++;
+        }
 
-    for (int y = 0; y < height; y += step) {
-        for (int x = 0; x < width; x += step) {
-            int idx = (y * width + x) * 4;
+        if (gy + 1 < luma_rows_ && (gy + 1) * step * MHI_H / height == cell_y) {
+            continue;
+        }
+        CellMoments* cell_row = fine_moments_.data() + cell_y * MHI_W;
+        for (int gx = 0; gx < luma_cols_; gx++) {
+            CellMoments& m = cell_row[gx * step * MHI_W / width];
+            m.sum_cur += columns.sum_cur[gx];
+            m.sum_prev += columns.sum_prev[gx];
+            m.sq_cur += columns.sq_cur[gx];
+            m.sq_prev += columns.sq_prev[gx];
+            m.cross += columns.cross[gx];
+            m.abs_residual += columns.abs_diff[gx];
+            m.n += rows_in_cell;
+        }
+        std::fill(column_moments_.begin(), column_moments_.end(), 0);
+        rows_in_cell = 0;
+    }
 
-            // Calculate luminance difference
-            float curr_lum = 0.299f * current[idx] + 0.587f * current[idx+1] + 0.114f * current[idx+2];
-            float prev_lum = 0.299f * previous[idx] + 0.587f * previous[idx+1] + 0.114f * previous[idx+2];
+    // Motion grid cells are whole blocks of MHI cells
+    std::fill(cell_moments_.begin(), cell_moments_.end(), CellMoments{});
+    for (int fy = 0; fy < MHI_H; fy++) {
+        for (int fx = 0; fx < MHI_W; fx++) {
+            const CellMoments& f = fine_moments_[fy * MHI_W + fx];
+            CellMoments& m = cell_moments_[(fy * GRID_SIZE / MHI_H) * GRID_SIZE + fx * GRID_SIZE / MHI_W];
+            m.sum_cur += f.sum_cur;
+            m.sum_prev += f.sum_prev;
+            m.sq_cur += f.sq_cur;
+            m.sq_prev += f.sq_prev;
+            m.cross += f.cross;
+            m.abs_residual += f.abs_residual;
+            m.n += f.n;
+        }
+    }
 
-            float diff = std::abs(curr_lum - prev_lum) / 255.0f;
-            total_diff += diff;
-            sample_count++;
+    // Global gain / offset from the histograms; tiny changes are left
+    // alone so histogram noise cannot mask real motion
+    float gain, offset;
+    estimatePhotometricChange(gain, offset);
+    bool compensate = std::fabs(gain - 1.0f) > GAIN_EPSILON || std::fabs(offset) > OFFSET_EPSILON;
+
+    // A real lighting change fits most cells better; a person moving
+    // skews the histograms too, but then the fit only helps a minority
+    if (compensate) {
+        int cells = 0, improved = 0;
+        for (const auto& m : cell_moments_) {
+            if (m.n == 0) continue;
+            cells++;
+            if (cellResidual(m, gain, offset) < cellResidual(m, 1.0, 0.0)) {
+                improved++;
+            }
         }
+        compensate = improved * 2 > cells;
+    }
+    if (!compensate) {
+        gain = 1.0f;
+        offset = 0.0f;
+    }
+    luma_gain_ = gain;
+    luma_offset_ = offset;
+    lighting_change_ = compensate &&
+        (std::fabs(gain - 1.0f) > LIGHTING_GAIN || std::fabs(offset) > LIGHTING_OFFSET);
+    if (compensate) {
+        accumulateCompensatedResidual(current, previous, gain, offset);
     }
 
+    // Mean absolute residual: a person moving changes a small share of a
+    // cell's samples by a lot, which an RMS would weight up
+    double total_abs = 0.0;
+    uint64_t sample_count = 0;
+    int active_cells = 0;
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        const CellMoments& m = cell_moments_[i];
+        if (m.n == 0) {
+            cell_motion_[i] = 0.0f;
+            continue;
+        }
+        total_abs += m.abs_residual;
+        sample_count += m.n;
+
+        cell_motion_[i] = static_cast<float>(m.abs_residual / m.n) / 255.0f;
+        if (cell_motion_[i] > cell_threshold_) {
+            active_cells++;
+        }
+    }
+    active_cell_fraction_ = static_cast<float>(active_cells) / (GRID_SIZE * GRID_SIZE);
+
     if (sample_count == 0) return 0.0f;
 
     // Normalize to 0-1 range
-    float avg_diff = total_diff / sample_count;
+    float avg_diff = static_cast<float>(total_abs / sample_count) / 255.0f;
 
     // Apply sensitivity curve (small changes amplified)
     return std::min(1.0f, avg_diff * 5.0f);
 }
 
+double MotionAnalyzer::cellResidual(const CellMoments& m, double gain, double offset) {
+    // Sum of squared cur - (gain * prev + offset), expanded in the moments
+    const double g = gain, o = offset;
+    double sq = static_cast<double>(m.sq_cur) - 2.0 * g * m.cross - 2.0 * o * m.sum_cur +
+                g * g * m.sq_prev + 2.0 * g * o * m.sum_prev + o * o * m.n;
+    return std::max(sq, 0.0);
+}
+
+void MotionAnalyzer::accumulateCompensatedResidual(const uint8_t* current, const uint8_t* previous,
+                                                   float gain, float offset) {
+    // Second pass, only on frames whose lighting fit was accepted: the
+    // absolute residual has no closed form in the moments. The prediction
+    // saturates like the sensor does, so highlights clipped by lights
+    // switching on are not read as motion.
+    for (auto& f : fine_moments_) f.abs_residual = 0.0;
+    for (auto& m : cell_moments_) m.abs_residual = 0.0;
+
+    const int step = grid_step_;
+    for (int gy = 0; gy < luma_rows_; gy++) {
+        const int cell_y = gy * step * MHI_H / frame_height_;
+        const uint8_t* cur_row = current + static_cast<size_t>(gy) * luma_cols_;
+        const uint8_t* prev_row = previous + static_cast<size_t>(gy) * luma_cols_;
+        CellMoments* cell_row = fine_moments_.data() + cell_y * MHI_W;
+        for (int gx = 0; gx < luma_cols_; gx++) {
+            cell_row[gx * step * MHI_W / frame_width_].abs_residual +=
+                std::fabs(cur_row[gx] - std::min(std::max(gain * prev_row[gx] + offset, 0.0f), 255.0f));
+        }
+    }
+
+    for (int fy = 0; fy < MHI_H; fy++) {
+        for (int fx = 0; fx < MHI_W; fx++) {
+            cell_moments_[(fy * GRID_SIZE / MHI_H) * GRID_SIZE + fx * GRID_SIZE / MHI_W].abs_residual +=
+                fine_moments_[fy * MHI_W + fx].abs_residual;
+        }
+    }
+}
+
+void MotionAnalyzer::updateMotionHistory(int64_t now_ms) {
+    // Linear decay by elapsed time, in place
+    int64_t dt = last_mhi_ms_ > 0 ? now_ms - last_mhi_ms_ : 0;
+    last_mhi_ms_ = now_ms;
+    int decay = static_cast<int>(std::min<int64_t>(255, dt * 255 / std::max(1, mhi_duration_ms_)));
+    if (dt > 0) {
+        decay = std::max(decay, 1);
+    }
+
+    int moving = 0;
+    for (int i = 0; i < MHI_W * MHI_H; i++) {
+        const CellMoments& m = fine_moments_[i];
+        float level = m.n > 0 ? static_cast<float>(m.abs_residual / m.n) / 255.0f : 0.0f;
+        if (level > cell_threshold_) {
+            mhi_[i] = 255;
+            moving++;
+        } else {
+            mhi_[i] = mhi_[i] > decay ? static_cast<uint8_t>(mhi_[i] - decay) : 0;
+        }
+    }
+    frame_energy_ = static_cast<float>(moving) / (MHI_W * MHI_H);
+
+    // Direction from the MHI gradient: motion runs from old (low) to new
+    // (high) values. Only interior cells with recent history on all four
+    // sides, so the silhouette boundary does not count.
+    std::array<uint16_t, MotionFeatures::BINS> directions{};
+    for (int y = 1; y < MHI_H - 1; y++) {
+        for (int x = 1; x < MHI_W - 1; x++) {
+            const uint8_t* c = &mhi_[y * MHI_W + x];
+            if (c[0] == 0 || c[-1] == 0 || c[1] == 0 || c[-MHI_W] == 0 || c[MHI_W] == 0) continue;
+
+            int gx = c[1] - c[-1];
+            int gy = c[-MHI_W] - c[MHI_W];       // y up
+            if (gx == 0 && gy == 0) continue;
+
+            float angle = std::atan2(static_cast<float>(gy), static_cast<float>(gx));
+            int bin = static_cast<int>(std::lround(angle / (2.0f * static_cast<float>(M_PI)) *
+                                                   MotionFeatures::BINS));
+            directions[(bin + MotionFeatures::BINS) % MotionFeatures::BINS]++;
+        }
+    }
+
+    // Energy bin edges (per-frame moving fraction)
+    static const float ENERGY_EDGES[MotionFeatures::BINS - 1] = {
+        0.01f, 0.02f, 0.05f, 0.1f, 0.2f, 0.35f, 0.5f
+    };
+    uint8_t energy_bin = 0;
+    while (energy_bin < MotionFeatures::BINS - 1 && frame_energy_ >= ENERGY_EDGES[energy_bin]) {
+        energy_bin++;
+    }
+
+    // Slide the window, keeping running sums
+    direction_window_.push_back(directions);
+    energy_bin_window_.push_back(energy_bin);
+    energy_window_.push_back(frame_energy_);
+    for (int b = 0; b < MotionFeatures::BINS; b++) {
+        direction_sum_[b] += directions[b];
+    }
+    energy_bin_count_[energy_bin]++;
+    energy_sum_ += frame_energy_;
+
+    while (static_cast<int>(energy_window_.size()) > window_frames_) {
+        for (int b = 0; b < MotionFeatures::BINS; b++) {
+            direction_sum_[b] -= direction_window_.front()[b];
+        }
+        energy_bin_count_[energy_bin_window_.front()]--;
+        energy_sum_ -= energy_window_.front();
+        direction_window_.pop_front();
+        energy_bin_window_.pop_front();
+        energy_window_.pop_front();
+    }
+}
+
+MotionFeatures MotionAnalyzer::getMotionFeatures() const {
+    MotionFeatures f = {};
+    f.energy = frame_energy_;
+    f.frames = static_cast<int>(energy_window_.size());
+    if (f.frames > 0) {
+        f.mean_energy = std::max(0.0f, energy_sum_) / f.frames;
+        for (int b = 0; b < MotionFeatures::BINS; b++) {
+            f.energy_hist[b] = static_cast<float>(energy_bin_count_[b]) / f.frames;
+        }
+    }
+
+    uint32_t direction_total = 0;
+    for (uint32_t count : direction_sum_) direction_total += count;
+    if (direction_total > 0) {
+        for (int b = 0; b < MotionFeatures::BINS; b++) {
+            f.direction_hist[b] = static_cast<float>(direction_sum_[b]) / direction_total;
+        }
+    }
+
+    // Recency-weighted location of motion
+    float total = 0.0f, edge = 0.0f, sx = 0.0f, sy = 0.0f;
+    for (int y = 0; y < MHI_H; y++) {
+        for (int x = 0; x < MHI_W; x++) {
+            float w = mhi_[y * MHI_W + x];
+            if (w == 0.0f) continue;
+            total += w;
+            sx += w * (x + 0.5f);
+            sy += w * (y + 0.5f);
+            if (x < 2 || x >= MHI_W - 2 || y < 2 || y >= MHI_H - 2) {
+                edge += w;
+            }
+        }
+    }
+    if (total > 0.0f) {
+        f.edge_fraction = edge / total;
+        f.centroid_x = sx / total / MHI_W;
+        f.centroid_y = sy / total / MHI_H;
+    }
+    return f;
+}
+
+void MotionAnalyzer::setMotionHistoryConfig(int duration_ms, int window_frames) {
+    mhi_duration_ms_ = std::max(100, duration_ms);
+    window_frames_ = std::max(1, window_frames);
+}
+
+void MotionAnalyzer::estimatePhotometricChange(float& gain, float& offset) const {
+    gain = 1.0f;
+    offset = 0.0f;
+
+    uint32_t total = 0;
+    for (uint32_t count : hist_cur_) total += count;
+    if (total == 0) return;
+
+    // Robust spread and center: a person moving shifts only a small part
+    // of either histogram. The spread is taken from the lower half, which
+    // stays linear when lights switching on clip the highlights.
+    float cur_lo = histogramPercentile(hist_cur_, total, 0.1f);
+    float cur_mid = histogramPercentile(hist_cur_, total, 0.5f);
+    float prev_lo = histogramPercentile(hist_prev_, total, 0.1f);
+    float prev_mid = histogramPercentile(hist_prev_, total, 0.5f);
+
+    float prev_spread = prev_mid - prev_lo;
+    if (prev_spread > 1.0f) {
+        gain = std::max(MIN_GAIN, std::min((cur_mid - cur_lo) / prev_spread, MAX_GAIN));
+    }
+    offset = cur_mid - gain * prev_mid;
+}
+
 float MotionAnalyzer::calculateOpticalFlowMagnitude(const uint8_t* current,
-                                                     const uint8_t* previous,
-                                                     int width, int height) {
-    // Simplified optical flow using block matching
+                                                     const uint8_t* previous) const {
+    const int width = luma_cols_;
+    const int height = luma_rows_;
+
+    // Simplified optical flow using block matching on the luma grids
+    // (16 px blocks, +-8 px search in frame pixels)
     // For production, consider using a proper optical flow algorithm
 
-    int block_size = 16;
-    int search_range = 8;
+    int block_size = std::max(1, 16 / grid_step_);
+    int search_range = std::max(1, 8 / grid_step_);
     float total_magnitude = 0.0f;
     int block_count = 0;
 
@@ -133,16 +470,15 @@ float MotionAnalyzer::calculateOpticalFlowMagnitude(const uint8_t* current,
             float best_match = 1e9f;
             int best_dx = 0, best_dy = 0;
 
-            for (int dy = -search_range; dy <= search_range; dy += 2) {
-                for (int dx = -search_range; dx <= search_range; dx += 2) {
+            for (int dy = -search_range; dy <= search_range; dy++) {
+                for (int dx = -search_range; dx <= search_range; dx++) {
                     float sad = 0; // Sum of absolute differences
 
-                    for (int py = 0; py < block_size; py += 2) {
-                        for (int px = 0; px < block_size; px += 2) {
-                            int curr_idx = ((by + py) * width + (bx + px)) * 4;
-                            int prev_idx = ((by + py + dy) * width + (bx + px + dx)) * 4;
-
-                            sad += std::abs((int)current[curr_idx] - (int)previous[prev_idx]);
+                    for (int py = 0; py < block_size; py++) {
+                        const uint8_t* c = current + (by + py) * width + bx;
+                        const uint8_t* p = previous + (by + py + dy) * width + bx + dx;
+                        for (int px = 0; px < block_size; px++) {
+                            sad += std::abs((int)c[px] - (int)p[px]);
                         }
                     }
 
@@ -178,12 +514,29 @@ bool MotionAnalyzer::shouldAlertStillness(int threshold_seconds) const {
 }
 
 void MotionAnalyzer::reset() {
-    prev_frame_.clear();
-    prev_width_ = 0;
-    prev_height_ = 0;
+    prev_luma_.clear();
+    frame_width_ = 0;
+    frame_height_ = 0;
     motion_history_.clear();
     current_motion_level_ = 0.0f;
 
+    cell_motion_.assign(GRID_SIZE * GRID_SIZE, 0.0f);
+    active_cell_fraction_ = 0.0f;
+    cell_moments_.assign(GRID_SIZE * GRID_SIZE, CellMoments{});
+    fine_moments_.assign(MHI_W * MHI_H, CellMoments{});
+    mhi_.fill(0);
+    last_mhi_ms_ = 0;
+    frame_energy_ = 0.0f;
+    direction_window_.clear();
+    energy_bin_window_.clear();
+    energy_window_.clear();
+    direction_sum_.fill(0);
+    energy_bin_count_.fill(0);
+    energy_sum_ = 0.0f;
+    luma_gain_ = 1.0f;
+    luma_offset_ = 0.0f;
+    lighting_change_ = false;
+
     auto now = std::chrono::system_clock::now();
     int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()).count();
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <chrono>
+#include <cstdint>
 #include <deque>
 
+#include "image_view.h"
+
 namespace triage {
 
 struct MotionState {
@@ -11,6 +15,26 @@ struct MotionState {
     int64_t last_motion_timestamp; // ms since epoch
     int64_t stillness_duration;   // ms of continuous stillness
     bool is_still;
+    float active_cell_fraction;   // Fraction of grid cells with motion this frame
+    bool lighting_change;         // Global brightness jump compensated this frame
+};
+
+/**
+ * Sliding-window motion features from the motion history image (inputs
+ * for a small activity classifier: agitation, repositioning, bed exit,
+ * caregiver interaction)
+ */
+struct MotionFeatures {
+    static const int BINS = 8;
+
+    float energy;                 // Fraction of MHI cells moving this frame
+    float mean_energy;            // Mean per-frame energy over the window
+    float energy_hist[BINS];      // Window distribution of per-frame energy (sums to 1)
+    float direction_hist[BINS];   // Window motion direction from MHI gradients, 45 deg
+                                  // bins from +x counter-clockwise (y up), sums to 1
+    float edge_fraction;          // Share of recent motion in the outer ring of cells
+    float centroid_x, centroid_y; // Recency-weighted motion centroid (0-1)
+    int frames;                   // Frames in the window
 };
 
 class MotionAnalyzer {
@@ -27,18 +51,50 @@ public:
 
     /**
      * Analyze motion between current and previous frame
-     * @param pixels Current frame RGBA data
-     * @param width Frame width
-     * @param height Frame height
+     * @param image Current frame in any PixelFormat (any row stride, may be a crop)
      * @return Current motion state
      */
-    MotionState analyze(const uint8_t* pixels, int width, int height);
+    MotionState analyze(const ImageView& image);
 
     /**
      * Get current motion level (0.0-1.0)
      */
     float getMotionLevel() const { return current_motion_level_; }
 
+    /**
+     * Per-cell motion (GRID_SIZE x GRID_SIZE, row-major, 0-1) from the last frame
+     */
+    const std::vector<float>& getCellMotion() const { return cell_motion_; }
+
+    /**
+     * Fraction of grid cells above the cell motion threshold in the last frame
+     */
+    float getActiveCellFraction() const { return active_cell_fraction_; }
+
+    /**
+     * Sliding-window motion-energy and direction features
+     */
+    MotionFeatures getMotionFeatures() const;
+
+    /**
+     * @param duration_ms Time for an MHI cell to decay from 255 to 0
+     * @param window_frames Frames in the feature window
+     */
+    void setMotionHistoryConfig(int duration_ms, int window_frames);
+
+    /**
+     * Whether the last frame was a lighting event (lights switched,
+     * exposure step) rather than motion
+     */
+    bool isLightingChange() const { return lighting_change_; }
+
+    /**
+     * Global photometric fit of the last frame: current luma ~= gain *
+     * previous luma + offset (1 / 0 when no compensation was applied)
+     */
+    float getLumaGain() const { return luma_gain_; }
+    float getLumaOffset() const { return luma_offset_; }
+
     /**
      * Get seconds since last significant motion
      */
@@ -50,33 +106,98 @@ public:
      */
     bool shouldAlertStillness(int threshold_seconds) const;
 
+    /**
+     * Luma sampling stride in pixels (coarser = cheaper). A change takes
+     * effect on the next frame, which starts a new comparison.
+     */
+    void setSampleStep(int step) { luma_step_ = step < 1 ? 1 : step; }
+    int getSampleStep() const { return luma_step_; }
+
     /**
      * Reset motion history (e.g., when starting new session)
      */
     void reset();
 
+    static const int GRID_SIZE = 8;
+    static const int LUMA_BINS = 64;
+    static const int MHI_W = 32;                 // 4 x GRID_SIZE
+    static const int MHI_H = 24;                 // 3 x GRID_SIZE
+
+    /**
+     * Motion history image: MHI_W x MHI_H, row-major. 255 = moving this
+     * frame, decaying linearly to 0 over the history duration.
+     */
+    const std::array<uint8_t, MHI_W * MHI_H>& getMotionHistory() const { return mhi_; }
+
 private:
     bool initialized_ = false;
     float stillness_threshold_ = 0.05f;
     int history_frames_ = 30;
 
-    // Previous frame for comparison
-    std::vector<uint8_t> prev_frame_;
-    int prev_width_ = 0;
-    int prev_height_ = 0;
+    // Luma sampled every luma_step_ pixels; the previous frame's grid is
+    // all that is kept between frames
+    static const int DEFAULT_LUMA_STEP = 4;
+    int luma_step_ = DEFAULT_LUMA_STEP;
+    std::vector<uint8_t> cur_luma_;
+    std::vector<uint8_t> prev_luma_;
+    int luma_cols_ = 0;
+    int luma_rows_ = 0;
+    int grid_step_ = DEFAULT_LUMA_STEP;   // Stride the stored grids were sampled at
+    int frame_width_ = 0;
+    int frame_height_ = 0;
 
     // Motion history
     std::deque<float> motion_history_;
     float current_motion_level_ = 0.0f;
 
+    // Coarse motion grid (actigraphy-style counts)
+    std::vector<float> cell_motion_;
+    float cell_threshold_ = 0.03f;   // Mean luma diff (0-1) for an "active" cell
+    float active_cell_fraction_ = 0.0f;
+
+    // Per-cell |diff| sums and luma moments (photometric normalization) and
+    // both frames' luma histograms, all gathered in the differencing pass
+    struct CellMoments {
+        uint64_t sum_cur, sum_prev;
+        uint64_t sq_cur, sq_prev, cross;
+        double abs_residual;             // Sum of |cur - (gain * prev + offset)|
+        uint32_t n;
+    };
+    std::vector<CellMoments> cell_moments_;
+    std::vector<CellMoments> fine_moments_;      // MHI_W x MHI_H, summed into cell_moments_
+    std::vector<uint32_t> column_moments_;       // 6 x luma columns, one cell row at a time
+    std::array<uint32_t, LUMA_BINS> hist_cur_{};
+    std::array<uint32_t, LUMA_BINS> hist_prev_{};
+    float luma_gain_ = 1.0f;
+    float luma_offset_ = 0.0f;           // Luma levels (0-255)
+    bool lighting_change_ = false;
+
+    // Motion history image (per-cell recency, decayed in place)
+    std::array<uint8_t, MHI_W * MHI_H> mhi_{};
+    int64_t last_mhi_ms_ = 0;
+    int mhi_duration_ms_ = 1500;
+    float frame_energy_ = 0.0f;
+
+    // Sliding feature window with running sums
+    int window_frames_ = 150;
+    std::deque<std::array<uint16_t, MotionFeatures::BINS>> direction_window_;
+    std::deque<uint8_t> energy_bin_window_;
+    std::deque<float> energy_window_;
+    std::array<uint32_t, MotionFeatures::BINS> direction_sum_{};
+    std::array<uint32_t, MotionFeatures::BINS> energy_bin_count_{};
+    float energy_sum_ = 0.0f;
+
     // Timing
     int64_t last_motion_time_ = 0;
     int64_t stillness_start_time_ = 0;
 
-    float calculateFrameDifference(const uint8_t* current, const uint8_t* previous,
-                                    int width, int height);
-    float calculateOpticalFlowMagnitude(const uint8_t* current, const uint8_t* previous,
-                                         int width, int height);
+    float calculateFrameDifference(const uint8_t* current, const uint8_t* previous);
+    void estimatePhotometricChange(float& gain, float& offset) const;
+    void accumulateCompensatedResidual(const uint8_t* current, const uint8_t* previous,
+                                       float gain, float offset);
+    void updateMotionHistory(int64_t now_ms);
+    static double cellResidual(const CellMoments& m, double gain, double offset);
+    float calculateOpticalFlowMagnitude(const uint8_t* current, const uint8_t* previous) const;
 };
 
 } // namespace triage
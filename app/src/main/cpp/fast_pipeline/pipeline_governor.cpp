@@ -0,0 +1,316 @@
+#include "pipeline_governor.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+
+#define LOG_TAG "PipelineGovernor"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+const GovernorLevel PipelineGovernor::LEVELS[NUM_LEVELS] = {
+    // name        fps  yolo  motion  vlm
+    {"nominal",     0,  640,  4,      4},
+    {"warm",       15,  512,  4,      3},
+    {"hot",        10,  416,  8,      2},
+    {"critical",    5,  320,  8,      1},
+};
+
+static_assert(sizeof(GovernorStats::ms_at_level) / sizeof(int64_t) == PipelineGovernor::NUM_LEVELS,
+              "one time counter per level");
+
+namespace {
+// Thermal headroom that enters each level (index 0 unused). 1.0 is where
+// the platform starts throttling, so the ladder steps in ahead of it.
+constexpr float HEADROOM_ENTER[PipelineGovernor::NUM_LEVELS] = {0.0f, 0.70f, 0.85f, 0.95f};
+constexpr float HEADROOM_MARGIN = 0.05f;
+// Battery charge (on battery power) at or below which each level applies;
+// any discharge is at least level 1
+constexpr float BATTERY_ENTER[PipelineGovernor::NUM_LEVELS] = {0.0f, 100.0f, 50.0f, 20.0f};
+constexpr float BATTERY_MARGIN = 5.0f;
+// A frame a little early is still admitted (camera timestamps jitter)
+constexpr float PACING_SLACK = 0.9f;
+
+int thermalStateLevel(ThermalState state) {
+    switch (state) {
+        case ThermalState::NONE:
+        case ThermalState::LIGHT:
+            return 0;
+        case ThermalState::MODERATE:
+            return 1;
+        case ThermalState::SEVERE:
+            return 2;
+        default:
+            return 3;
+    }
+}
+}
+
+PipelineGovernor::PipelineGovernor() {
+}
+
+PipelineGovernor::~PipelineGovernor() {
+}
+
+void PipelineGovernor::init(int64_t relax_hold_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    relax_hold_ms_ = std::max<int64_t>(relax_hold_ms, 0);
+    LOGI("Pipeline governor initialized (relax hold %lldms)", (long long)relax_hold_ms_);
+}
+
+bool PipelineGovernor::setThermalHeadroom(float headroom, int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sample_.thermal_headroom = headroom;
+    return evaluate(now_ms);
+}
+
+bool PipelineGovernor::setThermalState(ThermalState state, int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sample_.thermal_state = state;
+    return evaluate(now_ms);
+}
+
+bool PipelineGovernor::setBattery(float percent, bool charging, int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sample_.battery_percent = std::max(0.0f, std::min(percent, 100.0f));
+    sample_.charging = charging;
+    return evaluate(now_ms);
+}
+
+bool PipelineGovernor::setPowerSample(const PowerSample& sample, int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sample_ = sample;
+    sample_.battery_percent = std::max(0.0f, std::min(sample_.battery_percent, 100.0f));
+    return evaluate(now_ms);
+}
+
+bool PipelineGovernor::update(int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evaluate(now_ms);
+}
+
+bool PipelineGovernor::admitFrame(int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int max_fps = LEVELS[level_].max_fps;
+    if (max_fps > 0 && last_admit_ms_ >= 0 &&
+        (now_ms - last_admit_ms_) < PACING_SLACK * 1000.0f / max_fps) {
+        frames_skipped_++;
+        return false;
+    }
+    last_admit_ms_ = now_ms;
+    frames_admitted_++;
+    return true;
+}
+
+int PipelineGovernor::getLevel() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return level_;
+}
+
+GovernorStats PipelineGovernor::getStats(int64_t now_ms) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    GovernorStats stats;
+    stats.level = level_;
+    stats.demand = demand(false);
+    stats.level_changes = level_changes_;
+    stats.frames_admitted = frames_admitted_;
+    stats.frames_skipped = frames_skipped_;
+    for (int i = 0; i < NUM_LEVELS; i++) {
+        stats.ms_at_level[i] = ms_at_level_[i];
+    }
+    if (level_since_ms_ >= 0) {
+        stats.ms_at_level[level_] += std::max<int64_t>(0, now_ms - level_since_ms_);
+    }
+    stats.sample = sample_;
+    return stats;
+}
+
+void PipelineGovernor::reset(int64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sample_ = PowerSample();
+    level_ = 0;
+    relax_since_ms_ = -1;
+    level_since_ms_ = now_ms;
+    std::fill(ms_at_level_, ms_at_level_ + NUM_LEVELS, 0);
+    level_changes_ = 0;
+    last_admit_ms_ = -1;
+    frames_admitted_ = 0;
+    frames_skipped_ = 0;
+}
+
+int PipelineGovernor::demand(bool relaxing) const {
+    // Relaxing asks whether the inputs are clear of each level's entry
+    // point by the margin, so a reading hovering on a threshold holds
+    const float headroom_margin = relaxing ? HEADROOM_MARGIN : 0.0f;
+    const float battery_margin = relaxing ? BATTERY_MARGIN : 0.0f;
+    int level = thermalStateLevel(sample_.thermal_state);
+
+    if (!std::isnan(sample_.thermal_headroom)) {
+        for (int i = 1; i < NUM_LEVELS; i++) {
+            if (sample_.thermal_headroom >= HEADROOM_ENTER[i] - headroom_margin) {
+                level = std::max(level, i);
+            }
+        }
+    }
+    if (!sample_.charging) {
+        for (int i = 1; i < NUM_LEVELS; i++) {
+            if (sample_.battery_percent <= BATTERY_ENTER[i] + battery_margin) {
+                level = std::max(level, i);
+            }
+        }
+    }
+    return level;
+}
+
+bool PipelineGovernor::evaluate(int64_t now_ms) {
+    if (level_since_ms_ < 0) {
+        level_since_ms_ = now_ms;
+    }
+
+    const int raise = demand(false);
+    if (raise > level_) {
+        switchTo(raise, now_ms);
+        relax_since_ms_ = -1;
+        return true;
+    }
+
+    if (demand(true) >= level_) {
+        relax_since_ms_ = -1;
+        return false;
+    }
+    if (relax_since_ms_ < 0) {
+        relax_since_ms_ = now_ms;
+    }
+    if (now_ms - relax_since_ms_ < relax_hold_ms_) {
+        return false;
+    }
+    // One level per hold, so a cooler level proves itself before the next
+    switchTo(level_ - 1, now_ms);
+    relax_since_ms_ = now_ms;
+    return true;
+}
+
+void PipelineGovernor::switchTo(int level, int64_t now_ms) {
+    ms_at_level_[level_] += std::max<int64_t>(0, now_ms - level_since_ms_);
+    level_since_ms_ = now_ms;
+
+    LOGI("Level %s -> %s (headroom %.2f, thermal %d, battery %.0f%%%s)",
+         LEVELS[level_].name, LEVELS[level].name, sample_.thermal_headroom,
+         static_cast<int>(sample_.thermal_state), sample_.battery_percent,
+         sample_.charging ? " charging" : "");
+    level_ = level;
+    level_changes_++;
+}
+
+namespace {
+
+bool readFile(const std::string& path, char* buf, size_t size) {
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) {
+        return false;
+    }
+    size_t n = fread(buf, 1, size - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    // Trim the trailing newline sysfs attributes end with
+    while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' ')) {
+        buf[--n] = '\0';
+    }
+    return n > 0;
+}
+
+bool readLong(const std::string& path, long& out) {
+    char buf[64];
+    return readFile(path, buf, sizeof(buf)) && sscanf(buf, "%ld", &out) == 1;
+}
+
+/**
+ * Hottest zone's temperature as a fraction of its lowest passive or
+ * critical trip point (the same scale as getThermalHeadroom)
+ */
+bool readThermalHeadroom(const std::string& dir, float& headroom) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) {
+        return false;
+    }
+    bool found = false;
+    while (dirent* entry = readdir(d)) {
+        if (strncmp(entry->d_name, "thermal_zone", 12) != 0) {
+            continue;
+        }
+        const std::string zone = dir + "/" + entry->d_name;
+        long temp = 0;
+        if (!readLong(zone + "/temp", temp)) {
+            continue;
+        }
+        long trip = 0;
+        for (int i = 0; ; i++) {
+            char type[32];
+            long trip_temp = 0;
+            const std::string prefix = zone + "/trip_point_" + std::to_string(i);
+            if (!readFile(prefix + "_type", type, sizeof(type))) {
+                break;
+            }
+            if ((strcmp(type, "passive") == 0 || strcmp(type, "critical") == 0) &&
+                readLong(prefix + "_temp", trip_temp) && trip_temp > 0 &&
+                (trip == 0 || trip_temp < trip)) {
+                trip = trip_temp;
+            }
+        }
+        if (trip > 0) {
+            const float h = static_cast<float>(temp) / trip;
+            headroom = found ? std::max(headroom, h) : h;
+            found = true;
+        }
+    }
+    closedir(d);
+    return found;
+}
+
+bool readBattery(const std::string& dir, float& percent, bool& charging) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) {
+        return false;
+    }
+    bool found = false;
+    while (dirent* entry = readdir(d)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        const std::string supply = dir + "/" + entry->d_name;
+        char type[32];
+        long capacity = 0;
+        if (!readFile(supply + "/type", type, sizeof(type)) || strcmp(type, "Battery") != 0 ||
+            !readLong(supply + "/capacity", capacity)) {
+            continue;
+        }
+        char status[32];
+        percent = static_cast<float>(capacity);
+        charging = !readFile(supply + "/status", status, sizeof(status)) ||
+                   strcmp(status, "Discharging") != 0;
+        found = true;
+        break;
+    }
+    closedir(d);
+    return found;
+}
+
+} // namespace
+
+bool readSysfsPowerSample(PowerSample& out, const std::string& root) {
+    PowerSample sample;
+    const bool thermal = readThermalHeadroom(root + "/thermal", sample.thermal_headroom);
+    const bool battery = readBattery(root + "/power_supply", sample.battery_percent, sample.charging);
+    if (thermal) {
+        out.thermal_headroom = sample.thermal_headroom;
+    }
+    if (battery) {
+        out.battery_percent = sample.battery_percent;
+        out.charging = sample.charging;
+    }
+    return thermal || battery;
+}
+
+} // namespace triage
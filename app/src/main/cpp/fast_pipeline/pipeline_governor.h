@@ -0,0 +1,147 @@
+#pragma once
+
+#include "resolution_governor.h"
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace triage {
+
+/**
+ * Thermal and power inputs, as reported by the app
+ * (or read from sysfs on a Linux host by readSysfsPowerSample)
+ */
+struct PowerSample {
+    float thermal_headroom = NAN;        // PowerManager.getThermalHeadroom(): 1.0 = throttling
+                                         // starts; NaN = not reported
+    ThermalState thermal_state = ThermalState::NONE;
+    float battery_percent = 100.0f;      // 0-100
+    bool charging = true;                // On external power
+};
+
+/**
+ * Settings applied at one governor level
+ */
+struct GovernorLevel {
+    const char* name;
+    int max_fps;                 // Frames admitted per second (0 = every frame)
+    int yolo_max_input;          // Largest YOLO input size
+    int motion_step;             // Motion luma sampling stride in pixels
+    int vlm_threads;             // llama.cpp threads
+};
+
+/**
+ * Governor statistics
+ */
+struct GovernorStats {
+    int level;
+    int demand;                  // Level the current inputs ask for
+    uint32_t level_changes;
+    uint64_t frames_admitted;
+    uint64_t frames_skipped;     // Over the level's frame rate
+    int64_t ms_at_level[4];      // Time spent at each level
+    PowerSample sample;
+};
+
+/**
+ * Steps the pipelines down a fixed ladder as the device heats up or runs
+ * on a draining battery, so throughput degrades in planned steps instead
+ * of at the kernel's throttling cliffs.
+ *
+ * Each input maps to a level: thermal headroom by threshold, thermal
+ * status by severity, and battery by charge when not on external power.
+ * The governor runs at the highest of the three.
+ *
+ * A hotter level is taken at once. A cooler one only after the inputs
+ * have stayed below the current level's entry point, less a margin, for
+ * a hold period, and then one level at a time.
+ */
+class PipelineGovernor {
+public:
+    static const int NUM_LEVELS = 4;
+    static const GovernorLevel LEVELS[NUM_LEVELS];
+
+    PipelineGovernor();
+    ~PipelineGovernor();
+
+    /**
+     * @param relax_hold_ms Time the inputs must allow a cooler level before stepping down
+     */
+    void init(int64_t relax_hold_ms = 60000);
+
+    /**
+     * @param headroom PowerManager.getThermalHeadroom() (NaN if unavailable)
+     * @return true if the level changed
+     */
+    bool setThermalHeadroom(float headroom, int64_t now_ms);
+
+    /**
+     * Thermal status from PowerManager (MODERATE and up raise the level)
+     * @return true if the level changed
+     */
+    bool setThermalState(ThermalState state, int64_t now_ms);
+
+    /**
+     * Battery inputs
+     * @param percent Charge 0-100
+     * @param charging On external power (battery level then ignored)
+     * @return true if the level changed
+     */
+    bool setBattery(float percent, bool charging, int64_t now_ms);
+
+    /**
+     * Replace all inputs at once (e.g. from readSysfsPowerSample)
+     * @return true if the level changed
+     */
+    bool setPowerSample(const PowerSample& sample, int64_t now_ms);
+
+    /**
+     * Re-evaluate the current inputs (releases a level once its hold has passed)
+     * @return true if the level changed
+     */
+    bool update(int64_t now_ms);
+
+    /**
+     * Frame pacing at the current level's frame rate
+     * @return true if a frame arriving at now_ms should be processed
+     */
+    bool admitFrame(int64_t now_ms);
+
+    int getLevel() const;
+    const GovernorLevel& getSettings() const { return LEVELS[getLevel()]; }
+
+    GovernorStats getStats(int64_t now_ms) const;
+
+    void reset(int64_t now_ms);
+
+private:
+    mutable std::mutex mutex_;
+    int64_t relax_hold_ms_ = 60000;
+
+    PowerSample sample_;
+    int level_ = 0;
+    int64_t relax_since_ms_ = -1;        // Inputs first allowed a cooler level
+    int64_t level_since_ms_ = -1;
+    int64_t ms_at_level_[NUM_LEVELS] = {};
+    uint32_t level_changes_ = 0;
+
+    int64_t last_admit_ms_ = -1;
+    uint64_t frames_admitted_ = 0;
+    uint64_t frames_skipped_ = 0;
+
+    int demand(bool relaxing) const;
+    bool evaluate(int64_t now_ms);
+    void switchTo(int level, int64_t now_ms);
+};
+
+/**
+ * Update a sample from Linux sysfs: hottest thermal zone against its
+ * lowest passive/critical trip point, and the first battery supply.
+ * Inputs sysfs does not expose (and the thermal status) are left as they are.
+ * @param root sysfs class directory (a fake tree in tests)
+ * @return false if no thermal zone or battery was found
+ */
+bool readSysfsPowerSample(PowerSample& out, const std::string& root = "/sys/class");
+
+} // namespace triage
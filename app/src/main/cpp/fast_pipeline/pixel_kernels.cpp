@@ -0,0 +1,209 @@
+#include "pixel_kernels.h"
+#include "simd_kernels.h"
+#include "thread_pool.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#define LOG_TAG "PixelKernels"
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+namespace {
+
+// Bilinear weights in 1/256 steps
+constexpr int WEIGHT_BITS = 8;
+constexpr int WEIGHT_ONE = 1 << WEIGHT_BITS;
+
+// Smallest row bands handed to the thread pool (a band re-resamples its
+// first source rows, so resize bands are kept larger)
+constexpr int RESIZE_ROWS_PER_TASK = 32;
+constexpr int CONVERT_ROWS_PER_TASK = 16;
+
+inline const uint8_t* chromaRowOf(const ImageView& image, int y) {
+    return image.chroma ? image.chromaRow(y) : nullptr;
+}
+
+template <PixelFormat Format>
+void sampleLumaImpl(const ImageView& image, int x0, int y0, int step_x, int step_y,
+                    int cols, int rows, uint8_t* out) {
+    using Layout = PixelLayout<Format>;
+    for (int r = 0; r < rows; r++) {
+        const int y = y0 + r * step_y;
+        const uint8_t* row = image.row(y);
+        const uint8_t* vu = chromaRowOf(image, y);
+        uint8_t* dst = out + static_cast<size_t>(r) * cols;
+        for (int c = 0; c < cols; c++) {
+            dst[c] = Layout::luma(row, vu, x0 + c * step_x);
+        }
+    }
+}
+
+/**
+ * 4-byte formats go through the CPU-dispatched luma kernel
+ */
+void sampleLumaRgbx(const ImageView& image, int x0, int y0, int step_x, int step_y,
+                    int cols, int rows, int red_offset, uint8_t* out) {
+    const auto luma_rgbx = simdKernels().luma_rgbx;
+    for (int r = 0; r < rows; r++) {
+        const uint8_t* row = image.row(y0 + r * step_y) + x0 * 4;
+        luma_rgbx(row, step_x, cols, red_offset, out + static_cast<size_t>(r) * cols);
+    }
+}
+
+template <>
+void sampleLumaImpl<PixelFormat::RGBA_8888>(const ImageView& image, int x0, int y0, int step_x,
+                                            int step_y, int cols, int rows, uint8_t* out) {
+    sampleLumaRgbx(image, x0, y0, step_x, step_y, cols, rows, 0, out);
+}
+
+template <>
+void sampleLumaImpl<PixelFormat::BGRA_8888>(const ImageView& image, int x0, int y0, int step_x,
+                                            int step_y, int cols, int rows, uint8_t* out) {
+    sampleLumaRgbx(image, x0, y0, step_x, step_y, cols, rows, 2, out);
+}
+
+template <PixelFormat Format>
+void convertToRgbImpl(const ImageView& image, uint8_t* dst, int dst_stride) {
+    using Layout = PixelLayout<Format>;
+    ThreadPool::instance().parallelFor(0, image.height, CONVERT_ROWS_PER_TASK, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            const uint8_t* row = image.row(y);
+            const uint8_t* vu = chromaRowOf(image, y);
+            uint8_t* out = dst + static_cast<size_t>(y) * dst_stride;
+            for (int x = 0; x < image.width; x++) {
+                Layout::rgb(row, vu, x, out + x * 3);
+            }
+        }
+    });
+}
+
+template <>
+void convertToRgbImpl<PixelFormat::RGB_888>(const ImageView& image, uint8_t* dst, int dst_stride) {
+    const size_t row_bytes = static_cast<size_t>(image.width) * 3;
+    for (int y = 0; y < image.height; y++) {
+        memcpy(dst + static_cast<size_t>(y) * dst_stride, image.row(y), row_bytes);
+    }
+}
+
+/**
+ * Source index and weight of the second tap for each output coordinate
+ * (top-left aligned, as the float resize this replaces)
+ */
+void bilinearTaps(int src_size, int dst_size, std::vector<int>& i0, std::vector<int>& i1,
+                  std::vector<int>& w) {
+    const float ratio = static_cast<float>(src_size) / dst_size;
+    i0.resize(dst_size);
+    i1.resize(dst_size);
+    w.resize(dst_size);
+    for (int i = 0; i < dst_size; i++) {
+        float s = i * ratio;
+        i0[i] = std::min(static_cast<int>(s), src_size - 1);
+        i1[i] = std::min(i0[i] + 1, src_size - 1);
+        w[i] = static_cast<int>((s - i0[i]) * WEIGHT_ONE + 0.5f);
+    }
+}
+
+/**
+ * Horizontal bilinear pass over one source row, RGB in 8.8 fixed point
+ */
+template <PixelFormat Format>
+void resampleRow(const ImageView& image, int src_y, const std::vector<int>& x0,
+                 const std::vector<int>& x1, const std::vector<int>& wx, uint16_t* out) {
+    using Layout = PixelLayout<Format>;
+    const uint8_t* row = image.row(src_y);
+    const uint8_t* vu = chromaRowOf(image, src_y);
+    const int dst_width = static_cast<int>(wx.size());
+    for (int x = 0; x < dst_width; x++) {
+        uint8_t p0[3], p1[3];
+        Layout::rgb(row, vu, x0[x], p0);
+        Layout::rgb(row, vu, x1[x], p1);
+        const int d = wx[x];
+        const int c = WEIGHT_ONE - d;
+        for (int ch = 0; ch < 3; ch++) {
+            out[x * 3 + ch] = static_cast<uint16_t>(p0[ch] * c + p1[ch] * d);
+        }
+    }
+}
+
+template <PixelFormat Format>
+void resizeToRgbImpl(const ImageView& image, int dst_width, int dst_height, uint8_t* dst) {
+    std::vector<int> x0, x1, wx, y0, y1, wy;
+    bilinearTaps(image.width, dst_width, x0, x1, wx);
+    bilinearTaps(image.height, dst_height, y0, y1, wy);
+
+    const size_t row_values = static_cast<size_t>(dst_width) * 3;
+    const auto blend_rows = simdKernels().blend_rows;
+
+    // Bands of output rows on the shared pool. Within a band, horizontally
+    // resampled source rows are reused while consecutive output rows share
+    // them; the vertical blend is the dispatched kernel.
+    ThreadPool::instance().parallelFor(0, dst_height, RESIZE_ROWS_PER_TASK, [&](int begin, int end) {
+        std::vector<uint16_t> top(row_values), bottom(row_values);
+        int top_src = -1;
+        int bottom_src = -1;
+        for (int y = begin; y < end; y++) {
+            if (y0[y] != top_src) {
+                if (y0[y] == bottom_src) {
+                    top.swap(bottom);
+                    std::swap(top_src, bottom_src);
+                } else {
+                    resampleRow<Format>(image, y0[y], x0, x1, wx, top.data());
+                    top_src = y0[y];
+                }
+            }
+            if (y1[y] != bottom_src) {
+                resampleRow<Format>(image, y1[y], x0, x1, wx, bottom.data());
+                bottom_src = y1[y];
+            }
+            blend_rows(top.data(), bottom.data(), static_cast<int>(row_values), wy[y],
+                       dst + static_cast<size_t>(y) * row_values);
+        }
+    });
+}
+
+} // namespace
+
+bool sampleLuma(const ImageView& image, int x0, int y0, int step_x, int step_y,
+                int cols, int rows, uint8_t* out) {
+    if (image.empty() || step_x <= 0 || step_y <= 0) {
+        return false;
+    }
+    const bool ok = dispatchPixelFormat(image, [&](auto format) {
+        sampleLumaImpl<decltype(format)::value>(image, x0, y0, step_x, step_y, cols, rows, out);
+    });
+    if (!ok) {
+        LOGE("Unreadable pixel format %d", static_cast<int>(image.format));
+    }
+    return ok;
+}
+
+bool convertToRgb(const ImageView& image, uint8_t* dst, int dst_stride) {
+    if (image.empty() || dst_stride < image.width * 3) {
+        return false;
+    }
+    const bool ok = dispatchPixelFormat(image, [&](auto format) {
+        convertToRgbImpl<decltype(format)::value>(image, dst, dst_stride);
+    });
+    if (!ok) {
+        LOGE("Unreadable pixel format %d", static_cast<int>(image.format));
+    }
+    return ok;
+}
+
+bool resizeToRgb(const ImageView& image, int dst_width, int dst_height, uint8_t* dst) {
+    if (image.empty() || dst_width <= 0 || dst_height <= 0) {
+        return false;
+    }
+    const bool ok = dispatchPixelFormat(image, [&](auto format) {
+        resizeToRgbImpl<decltype(format)::value>(image, dst_width, dst_height, dst);
+    });
+    if (!ok) {
+        LOGE("Unreadable pixel format %d", static_cast<int>(image.format));
+    }
+    return ok;
+}
+
+} // namespace triage
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "image_view.h"
+
+namespace triage {
+
+/**
+ * Integer luma (BT.601, 8-bit weights)
+ */
+inline uint8_t lumaOf(int r, int g, int b) {
+    return static_cast<uint8_t>((77 * r + 150 * g + 29 * b) >> 8);
+}
+
+/**
+ * Pixel decoding for one format, fixed at compile time.
+ *
+ * luma() and rgb() read pixel x of a row; vu is the matching NV21
+ * chroma row (unused by the other formats). Kernels are instantiated
+ * per layout, so their inner loops carry no format branches.
+ */
+template <PixelFormat Format>
+struct PixelLayout;
+
+template <>
+struct PixelLayout<PixelFormat::RGBA_8888> {
+    static inline uint8_t luma(const uint8_t* row, const uint8_t*, int x) {
+        const uint8_t* p = row + x * 4;
+        return lumaOf(p[0], p[1], p[2]);
+    }
+    static inline void rgb(const uint8_t* row, const uint8_t*, int x, uint8_t* out) {
+        const uint8_t* p = row + x * 4;
+        out[0] = p[0]; out[1] = p[1]; out[2] = p[2];
+    }
+};
+
+template <>
+struct PixelLayout<PixelFormat::BGRA_8888> {
+    static inline uint8_t luma(const uint8_t* row, const uint8_t*, int x) {
+        const uint8_t* p = row + x * 4;
+        return lumaOf(p[2], p[1], p[0]);
+    }
+    static inline void rgb(const uint8_t* row, const uint8_t*, int x, uint8_t* out) {
+        const uint8_t* p = row + x * 4;
+        out[0] = p[2]; out[1] = p[1]; out[2] = p[0];
+    }
+};
+
+template <>
+struct PixelLayout<PixelFormat::RGB_888> {
+    static inline uint8_t luma(const uint8_t* row, const uint8_t*, int x) {
+        const uint8_t* p = row + x * 3;
+        return lumaOf(p[0], p[1], p[2]);
+    }
+    static inline void rgb(const uint8_t* row, const uint8_t*, int x, uint8_t* out) {
+        const uint8_t* p = row + x * 3;
+        out[0] = p[0]; out[1] = p[1]; out[2] = p[2];
+    }
+};
+
+template <>
+struct PixelLayout<PixelFormat::RGB_565> {
+    static inline void rgb(const uint8_t* row, const uint8_t*, int x, uint8_t* out) {
+        const int v = row[x * 2] | (row[x * 2 + 1] << 8);
+        const int r = v >> 11;
+        const int g = (v >> 5) & 0x3F;
+        const int b = v & 0x1F;
+        // Replicate the top bits so full scale maps to 255
+        out[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+        out[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+        out[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+    }
+    static inline uint8_t luma(const uint8_t* row, const uint8_t* vu, int x) {
+        uint8_t p[3];
+        rgb(row, vu, x, p);
+        return lumaOf(p[0], p[1], p[2]);
+    }
+};
+
+template <>
+struct PixelLayout<PixelFormat::NV21> {
+    static inline uint8_t luma(const uint8_t* row, const uint8_t*, int x) {
+        return row[x];
+    }
+    static inline void rgb(const uint8_t* row, const uint8_t* vu, int x, uint8_t* out) {
+        // Full-range BT.601 (camera JPEG range), 8-bit fixed point
+        const int y = row[x];
+        const int v = vu[x & ~1] - 128;
+        const int u = vu[(x & ~1) + 1] - 128;
+        out[0] = clampByte(y + ((359 * v) >> 8));
+        out[1] = clampByte(y - ((88 * u + 183 * v) >> 8));
+        out[2] = clampByte(y + ((454 * u) >> 8));
+    }
+
+private:
+    static inline uint8_t clampByte(int v) {
+        return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+    }
+};
+
+/**
+ * Call fn with the view's format as a compile-time constant - the one
+ * format switch of a kernel call
+ * @return false for an NV21 view without its chroma plane
+ */
+template <typename Fn>
+inline bool dispatchPixelFormat(const ImageView& image, Fn&& fn) {
+    switch (image.format) {
+        case PixelFormat::RGBA_8888:
+            fn(std::integral_constant<PixelFormat, PixelFormat::RGBA_8888>());
+            return true;
+        case PixelFormat::BGRA_8888:
+            fn(std::integral_constant<PixelFormat, PixelFormat::BGRA_8888>());
+            return true;
+        case PixelFormat::RGB_888:
+            fn(std::integral_constant<PixelFormat, PixelFormat::RGB_888>());
+            return true;
+        case PixelFormat::RGB_565:
+            fn(std::integral_constant<PixelFormat, PixelFormat::RGB_565>());
+            return true;
+        case PixelFormat::NV21:
+            if (image.chroma == nullptr) {
+                return false;
+            }
+            fn(std::integral_constant<PixelFormat, PixelFormat::NV21>());
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Sample luma on a regular grid: out[r * cols + c] is the luma of pixel
+ * (x0 + c * step_x, y0 + r * step_y). The grid must lie inside the image.
+ * @return false if the format cannot be read
+ */
+bool sampleLuma(const ImageView& image, int x0, int y0, int step_x, int step_y,
+                int cols, int rows, uint8_t* out);
+
+/**
+ * Samples that fit from offset along a side of length size
+ */
+inline int sampleCount(int size, int offset, int step) {
+    return size > offset ? (size - offset + step - 1) / step : 0;
+}
+
+/**
+ * Convert a view to RGB
+ * @param dst Output rows, dst_stride bytes apart (>= width * 3)
+ */
+bool convertToRgb(const ImageView& image, uint8_t* dst, int dst_stride);
+
+/**
+ * Bilinear resize straight to packed RGB, decoding each source pixel
+ * in place (no intermediate RGB copy of the frame)
+ * @param dst dst_width * dst_height * 3 bytes
+ */
+bool resizeToRgb(const ImageView& image, int dst_width, int dst_height, uint8_t* dst);
+
+} // namespace triage
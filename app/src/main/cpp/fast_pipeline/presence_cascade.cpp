@@ -0,0 +1,118 @@
+#include "presence_cascade.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cmath>
+
+#define LOG_TAG "PresenceCascade"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+PresenceCascade::PresenceCascade() {
+}
+
+PresenceCascade::~PresenceCascade() {
+}
+
+void PresenceCascade::init(int refresh_frames, float present_threshold, float max_shift) {
+    refresh_frames_ = std::max(1, refresh_frames);
+    present_threshold_ = present_threshold;
+    max_shift_ = max_shift;
+    reset();
+    frames_ = 0;
+    full_runs_ = 0;
+    stage_ms_total_ = 0.0;
+    full_ms_total_ = 0.0;
+    LOGI("Presence cascade initialized (refresh=%d frames, present=%.2f, shift=%.2f)",
+         refresh_frames_, present_threshold_, max_shift_);
+}
+
+void PresenceCascade::setRoi(float x1, float y1, float x2, float y2) {
+    x1 = std::max(0.0f, std::min(x1, 1.0f));
+    y1 = std::max(0.0f, std::min(y1, 1.0f));
+    x2 = std::max(0.0f, std::min(x2, 1.0f));
+    y2 = std::max(0.0f, std::min(y2, 1.0f));
+    if (x2 <= x1 || y2 <= y1) {
+        x1 = 0.0f; y1 = 0.0f; x2 = 1.0f; y2 = 1.0f;
+    }
+    roi_[0] = x1; roi_[1] = y1; roi_[2] = x2; roi_[3] = y2;
+    // Stage boxes are ROI-relative - old ones no longer compare
+    reset();
+}
+
+void PresenceCascade::getRoi(float& x1, float& y1, float& x2, float& y2) const {
+    x1 = roi_[0]; y1 = roi_[1]; x2 = roi_[2]; y2 = roi_[3];
+}
+
+bool PresenceCascade::needsFullRun(float stage_score, const PresenceBox& stage_box, float stage_ms) {
+    frames_++;
+    stage_ms_total_ += stage_ms;
+
+    if (!has_reference_ || frames_since_full_ + 1 >= refresh_frames_) {
+        return true;
+    }
+
+    bool present = stage_score >= present_threshold_;
+    bool absent = stage_score <= 0.0f;
+    if (!present && !absent) {
+        return true;  // Weak box - uncertain
+    }
+    if (present != reference_present_) {
+        return true;  // Presence flipped since the last full run
+    }
+
+    if (present) {
+        if (!reference_has_box_) {
+            return true;
+        }
+        float shift = std::max({std::fabs(stage_box.x1 - reference_box_.x1),
+                                std::fabs(stage_box.y1 - reference_box_.y1),
+                                std::fabs(stage_box.x2 - reference_box_.x2),
+                                std::fabs(stage_box.y2 - reference_box_.y2)});
+        if (shift > max_shift_) {
+            return true;  // Moved - pose / fall state may have changed
+        }
+    }
+
+    frames_since_full_++;
+    return false;
+}
+
+void PresenceCascade::recordFullRun(bool person_present, float stage_score,
+                                    const PresenceBox& stage_box, float full_ms) {
+    full_runs_++;
+    full_ms_total_ += full_ms;
+
+    has_reference_ = true;
+    reference_present_ = person_present;
+    // Keep the stage box only if the stage itself was confident, so the
+    // next frames compare like with like
+    reference_has_box_ = stage_score >= present_threshold_;
+    reference_box_ = stage_box;
+    frames_since_full_ = 0;
+}
+
+CascadeStats PresenceCascade::getStats() const {
+    CascadeStats stats = {};
+    stats.frames = frames_;
+    stats.full_runs = full_runs_;
+    if (frames_ > 0) {
+        stats.mean_stage_ms = static_cast<float>(stage_ms_total_ / frames_);
+        stats.avoided_fraction = 1.0f - static_cast<float>(full_runs_) / frames_;
+        stats.mean_frame_ms = static_cast<float>((stage_ms_total_ + full_ms_total_) / frames_);
+    }
+    if (full_runs_ > 0) {
+        stats.mean_full_ms = static_cast<float>(full_ms_total_ / full_runs_);
+    }
+    return stats;
+}
+
+void PresenceCascade::reset() {
+    has_reference_ = false;
+    reference_present_ = false;
+    reference_has_box_ = false;
+    reference_box_ = {};
+    frames_since_full_ = 0;
+}
+
+} // namespace triage
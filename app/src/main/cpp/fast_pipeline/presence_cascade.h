@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+
+namespace triage {
+
+/**
+ * Person box from the presence stage, normalized to the ROI (0-1)
+ */
+struct PresenceBox {
+    float x1, y1, x2, y2;
+};
+
+/**
+ * Running cost of the cascade (benchmark on recorded sessions)
+ */
+struct CascadeStats {
+    uint64_t frames;             // Frames seen by the cascade
+    uint64_t full_runs;          // Frames that ran the full detector
+    float mean_stage_ms;         // Presence stage cost per frame
+    float mean_full_ms;          // Full detector cost per run
+    float avoided_fraction;      // Full inferences avoided / frames
+    float mean_frame_ms;         // Stage + full cost averaged over all frames
+};
+
+/**
+ * Decides when the full detector can be skipped.
+ *
+ * A cheap presence stage runs on every frame over a fixed ROI (e.g. the
+ * bed; the whole frame by default). Its answer is trusted only when it is
+ * clear and agrees with the last full result:
+ * - present: a confident person box that has not moved or resized since
+ *   the last full run, and the last full run saw a person
+ * - absent: no person box, and the last full run saw nobody
+ * Anything else (low-confidence box, box moved, presence flipped) is
+ * uncertain and runs the full detector, as does a periodic refresh so
+ * cached pose / fall state never gets old.
+ */
+class PresenceCascade {
+public:
+    PresenceCascade();
+    ~PresenceCascade();
+
+    /**
+     * @param refresh_frames Run the full detector at least this often
+     * @param present_threshold Stage score above which presence is certain
+     * @param max_shift Box edge movement (fraction of the ROI) still
+     *        counted as the same position
+     */
+    void init(int refresh_frames = 15, float present_threshold = 0.5f, float max_shift = 0.08f);
+
+    /**
+     * Fixed ROI the stage looks at, normalized to the image (0-1)
+     */
+    void setRoi(float x1, float y1, float x2, float y2);
+    void getRoi(float& x1, float& y1, float& x2, float& y2) const;
+
+    /**
+     * Whether the full detector must run this frame
+     * @param stage_score Best person score from the stage (0 = none)
+     * @param stage_box Its box (ignored when the score is 0)
+     * @param stage_ms Stage cost this frame
+     */
+    bool needsFullRun(float stage_score, const PresenceBox& stage_box, float stage_ms);
+
+    /**
+     * Record a full run so later frames are compared against it
+     * @param person_present Full detector saw a person
+     */
+    void recordFullRun(bool person_present, float stage_score, const PresenceBox& stage_box,
+                       float full_ms);
+
+    CascadeStats getStats() const;
+
+    /**
+     * Forget the reference (next frame runs the full detector)
+     */
+    void reset();
+
+private:
+    int refresh_frames_ = 15;
+    float present_threshold_ = 0.5f;
+    float max_shift_ = 0.08f;
+    float roi_[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+
+    // Reference from the last full run
+    bool has_reference_ = false;
+    bool reference_present_ = false;
+    bool reference_has_box_ = false;
+    PresenceBox reference_box_ = {};
+    int frames_since_full_ = 0;
+
+    uint64_t frames_ = 0;
+    uint64_t full_runs_ = 0;
+    double stage_ms_total_ = 0.0;
+    double full_ms_total_ = 0.0;
+};
+
+} // namespace triage
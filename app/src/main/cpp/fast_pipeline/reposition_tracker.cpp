@@ -0,0 +1,244 @@
+#include "reposition_tracker.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cmath>
+
+#define LOG_TAG "RepositionTracker"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+namespace {
+// EMA weight for centroid / size / tilt smoothing (~5 frame time constant)
+constexpr float SMOOTHING_ALPHA = 0.2f;
+// Lower bound for body size so tiny boxes don't inflate displacement
+constexpr float MIN_BODY_SIZE = 0.05f;
+}
+
+RepositionTracker::RepositionTracker() {
+    reset();
+}
+
+RepositionTracker::~RepositionTracker() {
+}
+
+void RepositionTracker::init(int64_t confirm_ms,
+                             float displacement_threshold,
+                             int64_t absence_ms) {
+    confirm_ms_ = confirm_ms;
+    displacement_threshold_ = displacement_threshold;
+    absence_ms_ = absence_ms;
+    reset();
+    LOGI("Reposition tracker initialized (confirm=%lldms, displacement=%.2f, absence=%lldms)",
+         (long long)confirm_ms, displacement_threshold, (long long)absence_ms);
+}
+
+bool RepositionTracker::update(const RepositionInput& input) {
+    const int64_t now = input.timestamp_ms;
+
+    if (!input.person_present) {
+        // A long absence means the patient is out of bed - pressure is relieved
+        if (anchored_ && !left_view_ && now - last_seen_ms_ > absence_ms_) {
+            left_view_ = true;
+            LOGI("Patient out of view for %llds", (long long)((now - last_seen_ms_) / 1000));
+        }
+        candidate_reasons_ = 0;
+        return false;
+    }
+
+    float cx = input.bbox.x + input.bbox.width / 2;
+    float cy = input.bbox.y + input.bbox.height / 2;
+    float size = std::max(input.bbox.width, input.bbox.height);
+    bool has_tilt = std::isfinite(input.lateral_tilt);
+
+    if (!anchored_) {
+        smooth_cx_ = cx;
+        smooth_cy_ = cy;
+        smooth_size_ = size;
+        smooth_tilt_ = has_tilt ? input.lateral_tilt : 0.0f;
+        tilt_valid_ = has_tilt;
+        last_seen_ms_ = now;
+        LyingOrientation orientation = (input.pose == Pose::LYING && tilt_valid_)
+            ? classifyOrientation(smooth_tilt_) : LyingOrientation::UNKNOWN;
+        anchor(input, orientation);
+        anchor_time_ms_ = now;
+        return false;
+    }
+
+    last_seen_ms_ = now;
+
+    if (rebase_pending_) {
+        // Camera moved: same position, new image coordinates
+        rebase_pending_ = false;
+        smooth_cx_ = anchor_cx_ = cx;
+        smooth_cy_ = anchor_cy_ = cy;
+        smooth_size_ = size;
+        smooth_tilt_ = has_tilt ? input.lateral_tilt : 0.0f;
+        tilt_valid_ = has_tilt;
+        candidate_reasons_ = 0;
+        return false;
+    }
+
+    // Smooth observations so single-frame box jitter never counts
+    smooth_cx_ += SMOOTHING_ALPHA * (cx - smooth_cx_);
+    smooth_cy_ += SMOOTHING_ALPHA * (cy - smooth_cy_);
+    smooth_size_ += SMOOTHING_ALPHA * (size - smooth_size_);
+    if (has_tilt) {
+        smooth_tilt_ = tilt_valid_ ? smooth_tilt_ + SMOOTHING_ALPHA * (input.lateral_tilt - smooth_tilt_)
+                                   : input.lateral_tilt;
+        tilt_valid_ = true;
+    }
+
+    LyingOrientation orientation = LyingOrientation::UNKNOWN;
+    if (input.pose == Pose::LYING) {
+        orientation = tilt_valid_ ? classifyOrientation(smooth_tilt_) : anchor_orientation_;
+    }
+
+    // Returning after an absence always counts as a reposition
+    if (left_view_) {
+        left_view_ = false;
+        recordEvent(now, input.pose, orientation, REPOSITION_LEFT_VIEW);
+        anchor(input, orientation);
+        anchor_time_ms_ = now;
+        return true;
+    }
+
+    uint8_t reasons = 0;
+    if (input.pose != Pose::UNKNOWN && anchor_pose_ != Pose::UNKNOWN &&
+        input.pose != anchor_pose_) {
+        reasons |= REPOSITION_POSE_CHANGE;
+    }
+    if (orientation != LyingOrientation::UNKNOWN &&
+        anchor_orientation_ != LyingOrientation::UNKNOWN &&
+        orientation != anchor_orientation_) {
+        reasons |= REPOSITION_ORIENTATION_CHANGE;
+    }
+    float dx = smooth_cx_ - anchor_cx_;
+    float dy = smooth_cy_ - anchor_cy_;
+    float displacement = std::sqrt(dx * dx + dy * dy) / std::max(smooth_size_, MIN_BODY_SIZE);
+    if (displacement > displacement_threshold_) {
+        reasons |= REPOSITION_DISPLACEMENT;
+    }
+
+    if (reasons == 0) {
+        // Back to the anchored position - drop any pending change
+        candidate_reasons_ = 0;
+        if (anchor_pose_ == Pose::UNKNOWN && input.pose != Pose::UNKNOWN) {
+            anchor_pose_ = input.pose;
+        }
+        if (anchor_orientation_ == LyingOrientation::UNKNOWN) {
+            anchor_orientation_ = orientation;
+        }
+        return false;
+    }
+
+    // Start a new candidate if nothing is pending or the target changed
+    if (candidate_reasons_ == 0 || candidate_pose_ != input.pose ||
+        candidate_orientation_ != orientation) {
+        candidate_reasons_ = reasons;
+        candidate_since_ms_ = now;
+        candidate_pose_ = input.pose;
+        candidate_orientation_ = orientation;
+        return false;
+    }
+
+    candidate_reasons_ |= reasons;
+
+    if (now - candidate_since_ms_ < confirm_ms_) {
+        return false;
+    }
+
+    // The new position started when the candidate first appeared
+    recordEvent(candidate_since_ms_, input.pose, orientation, candidate_reasons_);
+    int64_t started = candidate_since_ms_;
+    anchor(input, orientation);
+    anchor_time_ms_ = started;
+    return true;
+}
+
+LyingOrientation RepositionTracker::classifyOrientation(float lateral_tilt) const {
+    bool currently_lateral = anchor_orientation_ == LyingOrientation::LEFT_LATERAL ||
+                             anchor_orientation_ == LyingOrientation::RIGHT_LATERAL;
+    float threshold = currently_lateral ? tilt_exit_ : tilt_enter_;
+
+    if (lateral_tilt > threshold) return LyingOrientation::RIGHT_LATERAL;
+    if (lateral_tilt < -threshold) return LyingOrientation::LEFT_LATERAL;
+    return LyingOrientation::SUPINE;
+}
+
+int64_t RepositionTracker::getMsSinceReposition(int64_t now_ms) const {
+    if (!anchored_ || left_view_) {
+        return 0;
+    }
+    return std::max<int64_t>(0, now_ms - anchor_time_ms_);
+}
+
+std::vector<RepositionEvent> RepositionTracker::getRecentEvents() const {
+    std::vector<RepositionEvent> out;
+    out.reserve(event_count_);
+
+    int start = (event_head_ - event_count_ + MAX_EVENTS) % MAX_EVENTS;
+    for (int i = 0; i < event_count_; i++) {
+        out.push_back(events_[(start + i) % MAX_EVENTS]);
+    }
+    return out;
+}
+
+void RepositionTracker::rebaseAnchor() {
+    if (anchored_) {
+        rebase_pending_ = true;
+        LOGI("Anchor rebase requested (camera moved)");
+    }
+}
+
+void RepositionTracker::reset() {
+    anchored_ = false;
+    rebase_pending_ = false;
+    anchor_time_ms_ = 0;
+    anchor_pose_ = Pose::UNKNOWN;
+    anchor_orientation_ = LyingOrientation::UNKNOWN;
+    anchor_cx_ = anchor_cy_ = 0.0f;
+    smooth_cx_ = smooth_cy_ = smooth_size_ = smooth_tilt_ = 0.0f;
+    tilt_valid_ = false;
+    candidate_reasons_ = 0;
+    candidate_since_ms_ = 0;
+    candidate_pose_ = Pose::UNKNOWN;
+    candidate_orientation_ = LyingOrientation::UNKNOWN;
+    last_seen_ms_ = 0;
+    left_view_ = false;
+    event_head_ = 0;
+    event_count_ = 0;
+    total_events_ = 0;
+}
+
+void RepositionTracker::anchor(const RepositionInput& input, LyingOrientation orientation) {
+    anchored_ = true;
+    anchor_pose_ = input.pose;
+    anchor_orientation_ = orientation;
+    anchor_cx_ = smooth_cx_;
+    anchor_cy_ = smooth_cy_;
+    candidate_reasons_ = 0;
+}
+
+void RepositionTracker::recordEvent(int64_t now_ms, Pose to_pose,
+                                    LyingOrientation to_orientation, uint8_t reasons) {
+    RepositionEvent& event = events_[event_head_];
+    event.timestamp_ms = now_ms;
+    event.held_ms = std::max<int64_t>(0, now_ms - anchor_time_ms_);
+    event.from_pose = anchor_pose_;
+    event.to_pose = to_pose;
+    event.from_orientation = anchor_orientation_;
+    event.to_orientation = to_orientation;
+    event.reasons = reasons;
+
+    event_head_ = (event_head_ + 1) % MAX_EVENTS;
+    event_count_ = std::min(event_count_ + 1, MAX_EVENTS);
+    total_events_++;
+
+    LOGI("Repositioning: pose %d -> %d, orientation %d -> %d, held %llds, reasons=0x%x",
+         static_cast<int>(event.from_pose), static_cast<int>(to_pose),
+         static_cast<int>(event.from_orientation), static_cast<int>(to_orientation),
+         (long long)(event.held_ms / 1000), reasons);
+}
+
+} // namespace triage
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "yolo_detector.h"
+#include "depth_processor.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace triage {
+
+/**
+ * Body orientation while lying (relative to the image axes)
+ */
+enum class LyingOrientation {
+    UNKNOWN = 0,
+    SUPINE = 1,
+    LEFT_LATERAL = 2,
+    RIGHT_LATERAL = 3
+};
+
+/**
+ * Why a repositioning event was recorded (bit flags)
+ */
+enum RepositionReason : uint8_t {
+    REPOSITION_POSE_CHANGE        = 1 << 0,  // e.g. lying -> sitting
+    REPOSITION_ORIENTATION_CHANGE = 1 << 1,  // e.g. supine -> left lateral
+    REPOSITION_DISPLACEMENT       = 1 << 2,  // Body centroid moved significantly
+    REPOSITION_LEFT_VIEW          = 1 << 3,  // Patient out of view (out of bed)
+};
+
+/**
+ * Per-frame input for repositioning tracking
+ */
+struct RepositionInput {
+    int64_t timestamp_ms;
+    bool person_present;
+    Pose pose;                   // Debounced pose (PoseEstimator::getCurrentPose)
+    BoundingBox bbox;            // Person box, normalized 0-1
+    float lateral_tilt;          // Signed tilt across the body, NaN if unknown
+};
+
+/**
+ * One completed repositioning
+ */
+struct RepositionEvent {
+    int64_t timestamp_ms;        // When the new position was confirmed
+    int64_t held_ms;             // How long the previous position was held
+    Pose from_pose;
+    Pose to_pose;
+    LyingOrientation from_orientation;
+    LyingOrientation to_orientation;
+    uint8_t reasons;             // RepositionReason bits
+};
+
+/**
+ * Tracks "time since last reposition" for pressure-injury prevention.
+ *
+ * Unlike PoseEstimator::getTimeInCurrentPose, a change only counts once it
+ * has been held for a confirmation period, so detector flicker does not
+ * reset the timer. Combines:
+ * - Pose state changes
+ * - Lateral orientation (from depth tilt across the body)
+ * - Sustained centroid / box displacement
+ *
+ * Each update is O(1); events are kept in a fixed-size ring.
+ */
+class RepositionTracker {
+public:
+    static const int MAX_EVENTS = 64;
+
+    RepositionTracker();
+    ~RepositionTracker();
+
+    /**
+     * Configure thresholds
+     * @param confirm_ms How long a new position must be held to count
+     * @param displacement_threshold Centroid shift (fraction of body size)
+     * @param absence_ms Absence after which the patient is treated as out of bed
+     */
+    void init(int64_t confirm_ms = 10000,
+              float displacement_threshold = 0.25f,
+              int64_t absence_ms = 120000);
+
+    /**
+     * Feed one frame
+     * @return true if a repositioning event was confirmed on this frame
+     */
+    bool update(const RepositionInput& input);
+
+    /**
+     * Milliseconds since the last confirmed repositioning
+     */
+    int64_t getMsSinceReposition(int64_t now_ms) const;
+
+    /**
+     * Current (confirmed) orientation
+     */
+    LyingOrientation getOrientation() const { return anchor_orientation_; }
+
+    /**
+     * Total events since reset (may exceed MAX_EVENTS)
+     */
+    uint32_t getEventCount() const { return total_events_; }
+
+    /**
+     * Most recent events, oldest first (at most MAX_EVENTS)
+     */
+    std::vector<RepositionEvent> getRecentEvents() const;
+
+    /**
+     * Map a signed depth tilt to an orientation (with hysteresis)
+     */
+    LyingOrientation classifyOrientation(float lateral_tilt) const;
+
+    /**
+     * Re-take the anchored position from the next frame without recording
+     * an event or restarting the timer (call when the camera has moved, so
+     * the view shift is not mistaken for a reposition)
+     */
+    void rebaseAnchor();
+
+    /**
+     * Reset state (call when patient changes)
+     */
+    void reset();
+
+private:
+    int64_t confirm_ms_ = 10000;
+    float displacement_threshold_ = 0.25f;
+    int64_t absence_ms_ = 120000;
+
+    // Lateral tilt thresholds (enter / exit lateral)
+    float tilt_enter_ = 0.35f;
+    float tilt_exit_ = 0.2f;
+
+    // Confirmed position the timer runs against
+    bool anchored_ = false;
+    int64_t anchor_time_ms_ = 0;
+    Pose anchor_pose_ = Pose::UNKNOWN;
+    LyingOrientation anchor_orientation_ = LyingOrientation::UNKNOWN;
+    float anchor_cx_ = 0.0f;
+    float anchor_cy_ = 0.0f;
+
+    bool rebase_pending_ = false;
+
+    // Smoothed observations
+    float smooth_cx_ = 0.0f;
+    float smooth_cy_ = 0.0f;
+    float smooth_size_ = 0.0f;
+    float smooth_tilt_ = 0.0f;
+    bool tilt_valid_ = false;
+
+    // Pending (unconfirmed) change
+    uint8_t candidate_reasons_ = 0;
+    int64_t candidate_since_ms_ = 0;
+    Pose candidate_pose_ = Pose::UNKNOWN;
+    LyingOrientation candidate_orientation_ = LyingOrientation::UNKNOWN;
+
+    // Absence tracking
+    int64_t last_seen_ms_ = 0;
+    bool left_view_ = false;
+
+    // Event ring buffer
+    std::array<RepositionEvent, MAX_EVENTS> events_;
+    int event_head_ = 0;
+    int event_count_ = 0;
+    uint32_t total_events_ = 0;
+
+    void anchor(const RepositionInput& input, LyingOrientation orientation);
+    void recordEvent(int64_t now_ms, Pose to_pose, LyingOrientation to_orientation,
+                     uint8_t reasons);
+};
+
+} // namespace triage
@@ -0,0 +1,150 @@
+#include "resolution_governor.h"
+#include <android/log.h>
+#include <algorithm>
+
+#define LOG_TAG "ResolutionGovernor"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+const int ResolutionGovernor::SIZES[NUM_SIZES] = {320, 416, 512, 640};
+
+namespace {
+// Rolling latency weight (~5 frame time constant)
+constexpr float LATENCY_ALPHA = 0.2f;
+// Person size smoothing (box jitter must not flip the size)
+constexpr float PERSON_ALPHA = 0.1f;
+// Person height at the model input that still detects reliably
+constexpr float MIN_PERSON_PIXELS = 160.0f;
+// Step down immediately above this fraction of the budget
+constexpr float OVERLOAD_FACTOR = 1.2f;
+// Step up only if the larger size is predicted below this fraction
+constexpr float HEADROOM_FACTOR = 0.95f;
+}
+
+ResolutionGovernor::ResolutionGovernor() {
+}
+
+ResolutionGovernor::~ResolutionGovernor() {
+}
+
+void ResolutionGovernor::init(float budget_ms, int hold_frames) {
+    budget_ms_ = budget_ms;
+    hold_frames_ = std::max(1, hold_frames);
+    reset();
+    LOGI("Resolution governor initialized (budget=%.1fms, hold=%d frames)", budget_ms, hold_frames_);
+}
+
+int ResolutionGovernor::update(int input_size, float latency_ms, float person_fraction) {
+    // A result from a different size than the current one (e.g. a tiled
+    // call) tells nothing about the current size
+    if (input_size != SIZES[current_]) {
+        return SIZES[current_];
+    }
+
+    latency_ema_ms_ = latency_valid_ ? latency_ema_ms_ + LATENCY_ALPHA * (latency_ms - latency_ema_ms_)
+                                     : latency_ms;
+    latency_valid_ = true;
+    person_fraction_ = person_fraction > 0.0f
+        ? (person_fraction_ > 0.0f ? person_fraction_ + PERSON_ALPHA * (person_fraction - person_fraction_)
+                                   : person_fraction)
+        : 0.0f;
+    frames_since_switch_++;
+
+    int target = std::min({personFloor(), ceiling(), latencyCap()});
+
+    if (target < current_) {
+        // Too hot, over the limit or over budget: drop straight away;
+        // otherwise wait out the hold
+        bool urgent = current_ > ceiling() || latency_ema_ms_ > budget_ms_ * OVERLOAD_FACTOR;
+        if (urgent || frames_since_switch_ >= hold_frames_) {
+            switchTo(target);
+        }
+    } else if (target > current_ && frames_since_switch_ >= hold_frames_) {
+        switchTo(current_ + 1);
+    }
+
+    return SIZES[current_];
+}
+
+void ResolutionGovernor::setSizeLimit(int max_size) {
+    limit_ = 0;
+    for (int i = 0; i < NUM_SIZES; i++) {
+        if (SIZES[i] <= max_size) {
+            limit_ = i;
+        }
+    }
+}
+
+void ResolutionGovernor::reset() {
+    current_ = NUM_SIZES - 1;
+    latency_ema_ms_ = 0.0f;
+    latency_valid_ = false;
+    person_fraction_ = 0.0f;
+    frames_since_switch_ = 0;
+    switches_ = 0;
+}
+
+int ResolutionGovernor::thermalCap() const {
+    switch (thermal_.load()) {
+        case ThermalState::NONE:
+        case ThermalState::LIGHT:
+            return NUM_SIZES - 1;
+        case ThermalState::MODERATE:
+            return 2;
+        case ThermalState::SEVERE:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+int ResolutionGovernor::personFloor() const {
+    if (person_fraction_ <= 0.0f) {
+        return NUM_SIZES - 1;  // Nobody seen - look at full size
+    }
+    for (int i = 0; i < NUM_SIZES; i++) {
+        if (SIZES[i] * person_fraction_ >= MIN_PERSON_PIXELS) {
+            return i;
+        }
+    }
+    return NUM_SIZES - 1;
+}
+
+int ResolutionGovernor::latencyCap() const {
+    if (!latency_valid_) {
+        return NUM_SIZES - 1;
+    }
+    // Cost scales with input area
+    const float current_area = static_cast<float>(SIZES[current_]) * SIZES[current_];
+    int cap = 0;
+    for (int i = 0; i < NUM_SIZES; i++) {
+        float predicted = latency_ema_ms_ * (static_cast<float>(SIZES[i]) * SIZES[i]) / current_area;
+        float limit = i > current_ ? budget_ms_ * HEADROOM_FACTOR : budget_ms_;
+        if (predicted <= limit) {
+            cap = i;
+        }
+    }
+    return cap;
+}
+
+void ResolutionGovernor::switchTo(int index) {
+    index = std::max(0, std::min(index, NUM_SIZES - 1));
+    if (index == current_) {
+        return;
+    }
+
+    // Carry the rolling latency over, scaled by area
+    float ratio = (static_cast<float>(SIZES[index]) * SIZES[index]) /
+                  (static_cast<float>(SIZES[current_]) * SIZES[current_]);
+    latency_ema_ms_ *= ratio;
+
+    LOGI("Input size %d -> %d (latency %.1fms, budget %.1fms, thermal %d, person %.2f)",
+         SIZES[current_], SIZES[index], latency_ema_ms_, budget_ms_,
+         static_cast<int>(thermal_.load()), person_fraction_);
+    current_ = index;
+    frames_since_switch_ = 0;
+    switches_++;
+}
+
+} // namespace triage
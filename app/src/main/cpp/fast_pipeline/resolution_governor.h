@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace triage {
+
+/**
+ * Thermal status reported by the app (values match
+ * android.os.PowerManager.THERMAL_STATUS_*)
+ */
+enum class ThermalState {
+    NONE = 0,
+    LIGHT = 1,
+    MODERATE = 2,
+    SEVERE = 3,
+    CRITICAL = 4,
+    EMERGENCY = 5,
+    SHUTDOWN = 6
+};
+
+/**
+ * Picks the YOLO input size per frame.
+ *
+ * The chosen size is the smallest of four limits:
+ * - Person size: a large, close person is still ~160 px tall at a low
+ *   input size, so there is no need for 640. With nobody in view the
+ *   full size is kept so a small or distant person is not missed.
+ * - Thermal: hotter states cap the size.
+ * - Size limit: a ceiling set from outside (the pipeline governor).
+ * - Latency: the size whose predicted inference time fits the budget.
+ *   Predictions scale the rolling latency at the current size by input
+ *   area, so they follow the device as it throttles.
+ *
+ * Steps down at once when over budget or too hot; steps up one size at a
+ * time after a hold period so the size does not oscillate.
+ */
+class ResolutionGovernor {
+public:
+    static const int NUM_SIZES = 4;
+    static const int SIZES[NUM_SIZES];           // 320, 416, 512, 640
+
+    ResolutionGovernor();
+    ~ResolutionGovernor();
+
+    /**
+     * @param budget_ms Target inference time per frame
+     * @param hold_frames Frames to wait before stepping up
+     */
+    void init(float budget_ms = 25.0f, int hold_frames = 15);
+
+    /**
+     * Input size for the next frame
+     */
+    int getInputSize() const { return SIZES[current_]; }
+
+    /**
+     * Record one inference and choose the next size
+     * @param input_size Size the inference ran at
+     * @param latency_ms Measured inference time
+     * @param person_fraction Largest person box side / image side (0 = none)
+     * @return Input size for the next frame
+     */
+    int update(int input_size, float latency_ms, float person_fraction);
+
+    void setThermalState(ThermalState state) { thermal_.store(state); }
+    ThermalState getThermalState() const { return thermal_.load(); }
+
+    /**
+     * Largest input size allowed (rounded down to one of SIZES)
+     */
+    void setSizeLimit(int max_size);
+    int getSizeLimit() const { return SIZES[limit_]; }
+
+    void setBudget(float budget_ms) { budget_ms_ = budget_ms; }
+    float getBudget() const { return budget_ms_; }
+
+    /**
+     * Rolling inference time at the current size
+     */
+    float getLatencyMs() const { return latency_ema_ms_; }
+
+    uint32_t getSwitchCount() const { return switches_; }
+
+    void reset();
+
+private:
+    float budget_ms_ = 25.0f;
+    int hold_frames_ = 15;
+    std::atomic<ThermalState> thermal_{ThermalState::NONE};  // Set from the PowerManager listener thread
+    int limit_ = NUM_SIZES - 1;
+
+    int current_ = NUM_SIZES - 1;
+    float latency_ema_ms_ = 0.0f;
+    bool latency_valid_ = false;
+    float person_fraction_ = 0.0f;
+    int frames_since_switch_ = 0;
+    uint32_t switches_ = 0;
+
+    int thermalCap() const;
+    int ceiling() const { return thermalCap() < limit_ ? thermalCap() : limit_; }
+    int personFloor() const;
+    int latencyCap() const;
+    void switchTo(int index);
+};
+
+} // namespace triage
@@ -0,0 +1,205 @@
+#include "scene_change_detector.h"
+#include "pixel_kernels.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#define LOG_TAG "SceneChangeDetector"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+namespace {
+// Samples averaged per grid cell (per axis)
+constexpr int CELL_SAMPLES = 4;
+// Depth histogram sampling grid and range
+constexpr int DEPTH_SAMPLES_X = 64;
+constexpr int DEPTH_SAMPLES_Y = 48;
+constexpr float DEPTH_BIN_MM = 250.0f;
+// Minimum valid depth fraction for the depth signature
+constexpr float MIN_DEPTH_VALID = 0.1f;
+// Consecutive signatures this similar mean the new view has settled
+constexpr float STABLE_SIMILARITY = 0.9f;
+}
+
+SceneChangeDetector::SceneChangeDetector() {
+}
+
+SceneChangeDetector::~SceneChangeDetector() {
+}
+
+void SceneChangeDetector::init(int64_t check_interval_ms, float edge_threshold,
+                               float depth_threshold, int confirm_checks) {
+    check_interval_ms_ = check_interval_ms;
+    edge_threshold_ = edge_threshold;
+    depth_threshold_ = depth_threshold;
+    confirm_checks_ = std::max(confirm_checks, 1);
+    resetReference();
+    LOGI("Scene change detector initialized (interval=%lldms, edge<%.2f, depth<%.2f, confirm=%d)",
+         (long long)check_interval_ms, edge_threshold, depth_threshold, confirm_checks_);
+}
+
+SceneChangeResult SceneChangeDetector::update(const ImageView& image, const DepthView& depth_mm,
+                                              int64_t timestamp_ms) {
+    SceneChangeResult result = {false, false, 1.0f, -1.0f, generation_};
+
+    if (image.data == nullptr || image.width < GRID_W || image.height < GRID_H) {
+        return result;
+    }
+    if (has_reference_ && timestamp_ms - last_check_ms_ < check_interval_ms_) {
+        return result;
+    }
+    last_check_ms_ = timestamp_ms;
+    result.checked = true;
+
+    Signature current;
+    computeSignature(image, depth_mm, current);
+
+    if (!has_reference_) {
+        reference_ = current;
+        previous_ = current;
+        has_reference_ = true;
+        has_previous_ = true;
+        return result;
+    }
+
+    result.edge_similarity = edgeSimilarity(reference_, current);
+    if (reference_.has_depth && current.has_depth) {
+        result.depth_similarity = depthSimilarity(reference_, current);
+    }
+
+    bool differs = result.edge_similarity < edge_threshold_ ||
+                   (result.depth_similarity >= 0.0f && result.depth_similarity < depth_threshold_);
+
+    if (!differs) {
+        mismatch_count_ = 0;
+    } else {
+        mismatch_count_++;
+        // The new view must also be steady - not a person crossing the frame
+        bool stable = has_previous_ && edgeSimilarity(previous_, current) > STABLE_SIMILARITY;
+
+        if (mismatch_count_ >= confirm_checks_ && stable) {
+            generation_++;
+            reference_ = current;
+            mismatch_count_ = 0;
+            result.changed = true;
+            result.generation = generation_;
+            LOGW("Scene change confirmed (edge=%.2f, depth=%.2f) - calibrations invalidated, generation %u",
+                 result.edge_similarity, result.depth_similarity, generation_);
+        }
+    }
+
+    previous_ = current;
+    has_previous_ = true;
+    return result;
+}
+
+void SceneChangeDetector::resetReference() {
+    has_reference_ = false;
+    has_previous_ = false;
+    mismatch_count_ = 0;
+    last_check_ms_ = 0;
+}
+
+void SceneChangeDetector::computeSignature(const ImageView& image, const DepthView& depth_mm,
+                                           Signature& out) const {
+    // Luma grid from a few samples per cell: one sampling pass over the
+    // covered area, then binned into cells
+    float grid[GRID_H][GRID_W];
+    const int cell_w = image.width / GRID_W;
+    const int cell_h = image.height / GRID_H;
+    const int step_x = std::max(1, cell_w / CELL_SAMPLES);
+    const int step_y = std::max(1, cell_h / CELL_SAMPLES);
+    const int cols = sampleCount(GRID_W * cell_w, 0, step_x);
+    const int rows = sampleCount(GRID_H * cell_h, 0, step_y);
+
+    std::vector<uint8_t> samples(static_cast<size_t>(cols) * rows);
+    int sums[GRID_H][GRID_W] = {};
+    int counts[GRID_H][GRID_W] = {};
+    if (sampleLuma(image, 0, 0, step_x, step_y, cols, rows, samples.data())) {
+        for (int r = 0; r < rows; r++) {
+            const int gy = r * step_y / cell_h;
+            const uint8_t* row = samples.data() + static_cast<size_t>(r) * cols;
+            for (int c = 0; c < cols; c++) {
+                const int gx = c * step_x / cell_w;
+                sums[gy][gx] += row[c];
+                counts[gy][gx]++;
+            }
+        }
+    }
+    for (int gy = 0; gy < GRID_H; gy++) {
+        for (int gx = 0; gx < GRID_W; gx++) {
+            grid[gy][gx] = counts[gy][gx] > 0 ? static_cast<float>(sums[gy][gx]) / counts[gy][gx] : 0.0f;
+        }
+    }
+
+    // Sobel gradient magnitude on the interior
+    float mean = 0.0f;
+    for (int y = 1; y < GRID_H - 1; y++) {
+        for (int x = 1; x < GRID_W - 1; x++) {
+            float gx = (grid[y - 1][x + 1] + 2 * grid[y][x + 1] + grid[y + 1][x + 1]) -
+                       (grid[y - 1][x - 1] + 2 * grid[y][x - 1] + grid[y + 1][x - 1]);
+            float gy = (grid[y + 1][x - 1] + 2 * grid[y + 1][x] + grid[y + 1][x + 1]) -
+                       (grid[y - 1][x - 1] + 2 * grid[y - 1][x] + grid[y - 1][x + 1]);
+            float magnitude = std::sqrt(gx * gx + gy * gy);
+            out.edges[(y - 1) * EDGE_W + (x - 1)] = magnitude;
+            mean += magnitude;
+        }
+    }
+
+    // Zero-mean, unit-norm so brightness and contrast changes cancel
+    mean /= out.edges.size();
+    float norm = 0.0f;
+    for (float& v : out.edges) {
+        v -= mean;
+        norm += v * v;
+    }
+    norm = std::sqrt(norm);
+    if (norm > 1e-6f) {
+        for (float& v : out.edges) v /= norm;
+    }
+
+    // Coarse depth histogram
+    out.depth.fill(0.0f);
+    out.has_depth = false;
+    if (!depth_mm.empty()) {
+        int dstep_x = std::max(1, depth_mm.width / DEPTH_SAMPLES_X);
+        int dstep_y = std::max(1, depth_mm.height / DEPTH_SAMPLES_Y);
+        int valid = 0;
+        int total = 0;
+        for (int y = 0; y < depth_mm.height; y += dstep_y) {
+            const uint16_t* row = depth_mm.row(y);
+            for (int x = 0; x < depth_mm.width; x += dstep_x) {
+                total++;
+                if (row[x] == 0) continue;
+                int bin = std::min(static_cast<int>(row[x] / DEPTH_BIN_MM), DEPTH_BINS - 1);
+                out.depth[bin] += 1.0f;
+                valid++;
+            }
+        }
+        if (total > 0 && valid >= total * MIN_DEPTH_VALID) {
+            for (float& v : out.depth) v /= valid;
+            out.has_depth = true;
+        }
+    }
+}
+
+float SceneChangeDetector::edgeSimilarity(const Signature& a, const Signature& b) {
+    float dot = 0.0f;
+    for (size_t i = 0; i < a.edges.size(); i++) {
+        dot += a.edges[i] * b.edges[i];
+    }
+    return dot;
+}
+
+float SceneChangeDetector::depthSimilarity(const Signature& a, const Signature& b) {
+    float intersection = 0.0f;
+    for (int i = 0; i < DEPTH_BINS; i++) {
+        intersection += std::min(a.depth[i], b.depth[i]);
+    }
+    return intersection;
+}
+
+} // namespace triage
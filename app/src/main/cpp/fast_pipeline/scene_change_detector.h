@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "image_view.h"
+
+namespace triage {
+
+/**
+ * Outcome of one scene-change check
+ */
+struct SceneChangeResult {
+    bool checked;                // A signature was compared this frame
+    bool changed;                // Camera moved - calibrations are stale
+    float edge_similarity;       // NCC of gradient signatures vs reference (-1..1)
+    float depth_similarity;      // Depth histogram intersection vs reference (0-1), -1 if n/a
+    uint32_t generation;         // Incremented on every confirmed change
+};
+
+/**
+ * Detects global scene changes (camera bumped or moved).
+ *
+ * At a low rate it builds a signature of the frame: gradient magnitudes of
+ * a 32x24 luma grid (mean-removed, so lighting changes cancel) and a coarse
+ * depth histogram. The signature is compared with a reference; a change is
+ * confirmed only when it persists for several checks and the new view is
+ * itself stable, so people walking through do not trigger it. On a
+ * confirmed change the reference is replaced and the generation counter
+ * increments - callers compare it to invalidate cached calibrations.
+ */
+class SceneChangeDetector {
+public:
+    static const int GRID_W = 32;
+    static const int GRID_H = 24;
+    static const int DEPTH_BINS = 32;            // 25cm bins over 0-8m
+
+    SceneChangeDetector();
+    ~SceneChangeDetector();
+
+    /**
+     * @param check_interval_ms Time between signature checks
+     * @param edge_threshold Edge similarity below which the view differs
+     * @param depth_threshold Depth similarity below which the view differs
+     * @param confirm_checks Consecutive differing checks needed to confirm
+     */
+    void init(int64_t check_interval_ms = 1000, float edge_threshold = 0.6f,
+              float depth_threshold = 0.7f, int confirm_checks = 3);
+
+    /**
+     * Check the scene if the interval has elapsed (cheap otherwise)
+     * @param image Frame in any PixelFormat
+     * @param depth_mm Range plane in mm (0 = invalid), or an empty view
+     * @param timestamp_ms Frame time
+     */
+    SceneChangeResult update(const ImageView& image, const DepthView& depth_mm,
+                             int64_t timestamp_ms);
+
+    uint32_t getGeneration() const { return generation_; }
+
+    /**
+     * A difference is being observed but not yet confirmed
+     */
+    bool isSettling() const { return mismatch_count_ > 0; }
+
+    /**
+     * Take the next signature as the new reference (e.g. after manual recalibration)
+     */
+    void resetReference();
+
+private:
+    static const int EDGE_W = GRID_W - 2;
+    static const int EDGE_H = GRID_H - 2;
+
+    struct Signature {
+        std::array<float, EDGE_W * EDGE_H> edges{};  // Zero-mean, unit-norm
+        std::array<float, DEPTH_BINS> depth{};       // Normalized histogram
+        bool has_depth = false;
+    };
+
+    int64_t check_interval_ms_ = 1000;
+    float edge_threshold_ = 0.6f;
+    float depth_threshold_ = 0.7f;
+    int confirm_checks_ = 3;
+
+    Signature reference_;
+    Signature previous_;
+    bool has_reference_ = false;
+    bool has_previous_ = false;
+    int64_t last_check_ms_ = 0;
+    int mismatch_count_ = 0;
+    uint32_t generation_ = 0;
+
+    void computeSignature(const ImageView& image, const DepthView& depth_mm,
+                          Signature& out) const;
+    static float edgeSimilarity(const Signature& a, const Signature& b);
+    static float depthSimilarity(const Signature& a, const Signature& b);
+};
+
+} // namespace triage
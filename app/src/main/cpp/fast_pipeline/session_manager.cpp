@@ -0,0 +1,401 @@
+#include "session_manager.h"
+#include "pixel_kernels.h"
+#include "thread_pool.h"
+#include <android/log.h>
+#include <algorithm>
+#include <chrono>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define LOG_TAG "SessionManager"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+namespace {
+int64_t steadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Most confident person detection as a normalized box
+bool findPersonBox(const std::vector<Detection>& detections, int width, int height,
+                   BoundingBox& out) {
+    const Detection* best = nullptr;
+    for (const auto& det : detections) {
+        if (det.class_id == 0 && (!best || det.confidence > best->confidence)) {
+            best = &det;
+        }
+    }
+    if (!best) return false;
+
+    out = {
+        best->x1 / static_cast<float>(width),
+        best->y1 / static_cast<float>(height),
+        (best->x2 - best->x1) / static_cast<float>(width),
+        (best->y2 - best->y1) / static_cast<float>(height)
+    };
+    return true;
+}
+}
+
+SessionManager::SessionManager() {
+}
+
+SessionManager::~SessionManager() {
+    cleanup();
+}
+
+bool SessionManager::init(const std::string& model_path, bool use_gpu) {
+    model_ = YoloModel::load(model_path, use_gpu);
+    if (!model_) {
+        LOGE("Failed to load shared YOLO model from: %s", model_path.c_str());
+        return false;
+    }
+    LOGI("Session manager initialized with shared model: %s", model_path.c_str());
+    return true;
+}
+
+bool SessionManager::init(std::shared_ptr<YoloModel> model) {
+    if (!model) {
+        LOGE("No shared model for session manager");
+        return false;
+    }
+    model_ = std::move(model);
+    LOGI("Session manager sharing model: %s", model_->model_path.c_str());
+    return true;
+}
+
+int SessionManager::addSession(const std::string& name, int priority) {
+    if (!model_) {
+        LOGE("Cannot add session '%s' - model not loaded", name.c_str());
+        return -1;
+    }
+
+    auto session = std::make_shared<CameraSession>();
+    if (!session->detector.init(model_)) {
+        return -1;
+    }
+    session->name = name;
+    session->priority = std::max(priority, 1);
+    session->motion.init(0.05f, 30);
+
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    session->id = next_session_id_++;
+    sessions_[session->id] = session;
+
+    LOGI("Added session %d '%s' (priority=%d, sessions=%zu)",
+         session->id, name.c_str(), session->priority, sessions_.size());
+    return session->id;
+}
+
+bool SessionManager::removeSession(int session_id) {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto it = sessions_.find(session_id);
+    if (it == sessions_.end()) {
+        return false;
+    }
+    // An in-flight runNext() keeps its own reference until it finishes
+    sessions_.erase(it);
+    LOGI("Removed session %d (sessions=%zu)", session_id, sessions_.size());
+    return true;
+}
+
+bool SessionManager::submitFrame(int session_id, const ImageView& image, int64_t timestamp_ms) {
+    auto session = findSession(session_id);
+    if (!session || image.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(session->frame_mutex);
+
+    // Motion is cheap - keep it continuous for every frame
+    session->last_motion = session->motion.analyze(image);
+
+    // The caller's buffer is released on return - keep a packed copy
+    // (NV21 is kept as RGB, so the copy is a single plane)
+    if (image.format == PixelFormat::NV21) {
+        session->pending_frame.resize(static_cast<size_t>(image.width) * image.height * 3);
+        if (!convertToRgb(image, session->pending_frame.data(), image.width * 3)) {
+            return false;
+        }
+        session->pending_format = PixelFormat::RGB_888;
+    } else {
+        const size_t row_bytes = static_cast<size_t>(image.width) * image.bpp();
+        session->pending_frame.resize(row_bytes * image.height);
+        for (int y = 0; y < image.height; y++) {
+            std::copy(image.row(y), image.row(y) + row_bytes,
+                      session->pending_frame.begin() + y * row_bytes);
+        }
+        session->pending_format = image.format;
+    }
+    session->pending_width = image.width;
+    session->pending_height = image.height;
+    session->pending_timestamp_ms = timestamp_ms;
+
+    if (session->has_pending) {
+        session->frames_skipped++;
+    }
+    session->has_pending = true;
+    session->frames_submitted++;
+    return true;
+}
+
+bool SessionManager::submitDepth(int session_id, const DepthView& depth) {
+    auto session = findSession(session_id);
+    if (!session || depth.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(session->frame_mutex);
+    session->depth.updateDepthMap(depth);
+    return true;
+}
+
+bool SessionManager::runNext(SessionResult& out) {
+    std::vector<SessionResult> results;
+    if (runBatch(1, results) == 0) {
+        return false;
+    }
+    out = results.front();
+    return true;
+}
+
+size_t SessionManager::runBatch(int max_streams, std::vector<SessionResult>& out) {
+    out.clear();
+
+    std::vector<ClaimedFrame> claimed;
+    for (auto& session : pickBatch(steadyNowMs(), std::max(max_streams, 1))) {
+        ClaimedFrame frame;
+        if (claim(session, frame)) {
+            claimed.push_back(std::move(frame));
+        }
+    }
+    if (claimed.empty()) {
+        return 0;
+    }
+
+    const int streams = static_cast<int>(claimed.size());
+    // Split the model's thread budget across concurrent extractors
+    const int total_threads = getThreadBudget();
+    const int threads_per_stream = std::max(1, total_threads / streams);
+    ThreadPool::ExternalThreads omp_threads(std::min(streams, total_threads) * threads_per_stream);
+
+    out.resize(claimed.size());
+    auto start = std::chrono::steady_clock::now();
+
+    // One extractor per stream, run side by side on OpenMP's pool (the one
+    // ncnn already uses). Preprocess, forward and decode all run per stream.
+#ifdef _OPENMP
+    // Let each stream's extractor fan out inside the outer parallel loop;
+    // the nesting limit is process-wide, so it is put back afterwards
+    const int saved_active_levels = omp_get_max_active_levels();
+    if (threads_per_stream > 1) {
+        omp_set_max_active_levels(std::max(saved_active_levels, 2));
+    }
+    #pragma omp parallel for num_threads(std::min(streams, total_threads)) schedule(dynamic, 1)
+#endif
+    for (int i = 0; i < streams; i++) {
+        out[i] = infer(claimed[i], threads_per_stream);
+    }
+#ifdef _OPENMP
+    omp_set_max_active_levels(saved_active_levels);
+#endif
+
+    auto end = std::chrono::steady_clock::now();
+    float batch_ms = std::chrono::duration<float, std::milli>(end - start).count();
+
+    for (int i = 0; i < streams; i++) {
+        release(claimed[i], out[i]);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        batches_run_++;
+        frames_batched_ += streams;
+        batch_time_ms_ += batch_ms;
+    }
+
+    if (streams > 1) {
+        LOGI("Batch of %d streams in %.1fms (%d threads/stream)", streams, batch_ms, threads_per_stream);
+    }
+    return claimed.size();
+}
+
+float SessionManager::getAggregateFps() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return batch_time_ms_ > 0 ? frames_batched_ * 1000.0f / batch_time_ms_ : 0.0f;
+}
+
+int SessionManager::getThreadBudget() const {
+#ifdef HAVE_NCNN
+    if (model_ && model_->opt.num_threads > 0) {
+        return model_->opt.num_threads;
+    }
+#endif
+    return 4;
+}
+
+bool SessionManager::claim(const std::shared_ptr<CameraSession>& session, ClaimedFrame& frame) {
+    // Take the pending frame by swapping buffers (no copy, no allocation)
+    std::lock_guard<std::mutex> lock(session->frame_mutex);
+    if (!session->has_pending || session->in_flight) {
+        return false;
+    }
+    session->infer_frame.swap(session->pending_frame);
+    session->has_pending = false;
+    session->in_flight = true;
+
+    frame.session = session;
+    frame.width = session->pending_width;
+    frame.height = session->pending_height;
+    frame.format = session->pending_format;
+    frame.timestamp_ms = session->pending_timestamp_ms;
+    frame.motion = session->last_motion;
+    // The analyzer is updated by submitFrame under this lock; infer runs without it
+    frame.seconds_since_motion = session->motion.getSecondsSinceMotion();
+    return true;
+}
+
+SessionResult SessionManager::infer(ClaimedFrame& frame, int num_threads) {
+    CameraSession& session = *frame.session;
+    auto start = std::chrono::steady_clock::now();
+
+    // Detector and pose state are only touched by the claiming thread
+    session.detector.setNumThreads(num_threads);
+    session.detector.setThermalState(static_cast<ThermalState>(thermal_state_.load()));
+    session.detector.setMaxInputSize(max_input_size_.load());
+    auto detections = session.detector.detect(
+        ImageView::packed(session.infer_frame.data(), frame.width, frame.height, frame.format));
+    session.pose.update(detections);
+
+    auto end = std::chrono::steady_clock::now();
+
+    SessionResult result = {};
+    result.session_id = session.id;
+    result.timestamp_ms = frame.timestamp_ms;
+    result.person_detected = session.detector.isPersonDetected();
+    result.fall_detected = session.detector.isFallDetected();
+    result.pose = session.pose.getCurrentPose();
+    result.motion_level = frame.motion.motion_level;
+    result.seconds_since_motion = frame.seconds_since_motion;
+    result.detection_count = detections.size();
+    result.inference_ms = std::chrono::duration<float, std::milli>(end - start).count();
+
+    // Depth on the person box; submitDepth replaces the map under frame_mutex
+    BoundingBox person_box;
+    if (findPersonBox(detections, frame.width, frame.height, person_box)) {
+        std::lock_guard<std::mutex> lock(session.frame_mutex);
+        if (session.depth.hasDepthData()) {
+            auto fall = session.depth.detectFall(person_box, frame.width, frame.height);
+            auto motion = session.depth.analyzeMotion(person_box, frame.width, frame.height);
+            result.depth_available = true;
+            result.depth_fall = fall.fall_detected;
+            result.fall_detected = result.fall_detected || fall.fall_detected;
+            result.fall_confidence = fall.confidence;
+            result.vertical_drop_meters = fall.vertical_drop_meters;
+            result.distance_meters = motion.distance_meters;
+            result.depth_motion_level = motion.depth_motion_level;
+        }
+    }
+    return result;
+}
+
+void SessionManager::release(ClaimedFrame& frame, const SessionResult& result) {
+    CameraSession& session = *frame.session;
+    std::lock_guard<std::mutex> lock(session.frame_mutex);
+    session.last_result = result;
+    session.last_inference_ms = steadyNowMs();
+    session.frames_inferred++;
+    session.in_flight = false;
+}
+
+bool SessionManager::getResult(int session_id, SessionResult& out) const {
+    auto session = findSession(session_id);
+    if (!session) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(session->frame_mutex);
+    out = session->last_result;
+    return true;
+}
+
+bool SessionManager::setPriority(int session_id, int priority) {
+    auto session = findSession(session_id);
+    if (!session) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(session->frame_mutex);
+    session->priority = std::max(priority, 1);
+    return true;
+}
+
+size_t SessionManager::getSessionCount() const {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    return sessions_.size();
+}
+
+void SessionManager::cleanup() {
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        sessions_.clear();
+    }
+    model_.reset();
+    LOGI("Session manager cleaned up");
+}
+
+std::vector<std::shared_ptr<CameraSession>> SessionManager::pickBatch(int64_t now_ms, int max_count) {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+
+    std::vector<std::shared_ptr<CameraSession>> picked;
+    if (sessions_.empty()) {
+        return picked;
+    }
+
+    if (policy_ == SchedulingPolicy::ROUND_ROBIN) {
+        // Sessions with a pending frame, starting after the last one served
+        auto it = sessions_.upper_bound(last_scheduled_id_);
+        for (size_t n = 0; n < sessions_.size() && static_cast<int>(picked.size()) < max_count;
+             n++, it++) {
+            if (it == sessions_.end()) it = sessions_.begin();
+            std::lock_guard<std::mutex> frame_lock(it->second->frame_mutex);
+            if (it->second->has_pending && !it->second->in_flight) {
+                picked.push_back(it->second);
+            }
+        }
+    } else {
+        // Weighted staleness: a priority-3 session waits a third as long
+        std::vector<std::pair<int64_t, std::shared_ptr<CameraSession>>> candidates;
+        for (auto& entry : sessions_) {
+            CameraSession& s = *entry.second;
+            std::lock_guard<std::mutex> frame_lock(s.frame_mutex);
+            if (!s.has_pending || s.in_flight) continue;
+
+            int64_t score = static_cast<int64_t>(s.priority) * (now_ms - s.last_inference_ms + 1);
+            candidates.emplace_back(score, entry.second);
+        }
+
+        size_t count = std::min(candidates.size(), static_cast<size_t>(max_count));
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                          [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (size_t i = 0; i < count; i++) {
+            picked.push_back(candidates[i].second);
+        }
+    }
+
+    if (!picked.empty()) {
+        last_scheduled_id_ = picked.back()->id;
+    }
+    return picked;
+}
+
+std::shared_ptr<CameraSession> SessionManager::findSession(int session_id) const {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto it = sessions_.find(session_id);
+    return it != sessions_.end() ? it->second : nullptr;
+}
+
+} // namespace triage
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "yolo_detector.h"
+#include "motion_analyzer.h"
+#include "pose_estimator.h"
+#include "depth_processor.h"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace triage {
+
+/**
+ * How the manager picks the next session for YOLO inference
+ */
+enum class SchedulingPolicy {
+    ROUND_ROBIN = 0,    // Strict rotation over sessions with a pending frame
+    PRIORITY = 1        // Highest priority x staleness first
+};
+
+/**
+ * Latest fast pipeline result for one session
+ */
+struct SessionResult {
+    int session_id;
+    int64_t timestamp_ms;        // Frame time of the inferred frame
+    bool person_detected;
+    bool fall_detected;
+    Pose pose;
+    float motion_level;
+    int64_t seconds_since_motion;
+    size_t detection_count;
+    float inference_ms;
+
+    // Depth on the session's person box (zero without a depth map or a person)
+    bool depth_available;
+    bool depth_fall;             // Depth-verified fall (fall_detected is set too)
+    float fall_confidence;
+    float vertical_drop_meters;
+    float distance_meters;
+    float depth_motion_level;
+};
+
+/**
+ * Per-bed monitoring session.
+ *
+ * Owns only per-session state (detector state, motion/pose/depth history and
+ * the pending frame). Model weights are shared through YoloModel.
+ */
+struct CameraSession {
+    int id = 0;
+    std::string name;
+    int priority = 1;            // Higher is served more often under PRIORITY
+
+    YoloDetector detector;
+    MotionAnalyzer motion;
+    PoseEstimator pose;
+    DepthProcessor depth;
+
+    // Latest submitted frame (latest wins; buffers swapped, never reallocated)
+    std::mutex frame_mutex;      // Guards pending_* and last_result
+    std::vector<uint8_t> pending_frame;
+    std::vector<uint8_t> infer_frame;
+    int pending_width = 0;
+    int pending_height = 0;
+    PixelFormat pending_format = PixelFormat::RGBA_8888;
+    int64_t pending_timestamp_ms = 0;
+    bool has_pending = false;
+    bool in_flight = false;      // YOLO running on this session
+
+    // Scheduling + stats
+    int64_t last_inference_ms = 0;
+    uint64_t frames_submitted = 0;
+    uint64_t frames_inferred = 0;
+    uint64_t frames_skipped = 0;   // Overwritten before inference
+    SessionResult last_result = {};
+    MotionState last_motion = {};
+};
+
+/**
+ * Runs the fast pipeline for several beds on one device.
+ *
+ * - YOLO weights are loaded once and shared by every session's detector;
+ *   each inference uses its own ncnn::Extractor
+ * - Motion analysis runs on every submitted frame (cheap)
+ * - YOLO runs on one session per runNext() call, or on several concurrently
+ *   with runBatch(), chosen by policy
+ *
+ * Frame sources (USB/IP cameras or a local stand-in) only call submitFrame.
+ */
+class SessionManager {
+public:
+    SessionManager();
+    ~SessionManager();
+
+    /**
+     * Load shared model weights
+     * @param model_path Directory containing the YOLO model
+     * @param use_gpu Whether to use Vulkan GPU acceleration
+     */
+    bool init(const std::string& model_path, bool use_gpu = true);
+
+    /**
+     * Use weights that are already loaded (e.g. by the single-camera detector)
+     */
+    bool init(std::shared_ptr<YoloModel> model);
+
+    /**
+     * Create a session for one camera
+     * @return Session id, or -1 if the model is not loaded
+     */
+    int addSession(const std::string& name, int priority = 1);
+
+    /**
+     * Remove a session and free its state
+     */
+    bool removeSession(int session_id);
+
+    /**
+     * Submit an RGBA frame for a session. Runs motion analysis immediately
+     * and keeps a packed copy as the session's pending YOLO input.
+     */
+    bool submitFrame(int session_id, const ImageView& image, int64_t timestamp_ms);
+
+    /**
+     * Submit a DEPTH16 frame for a session. The latest map is measured on
+     * the person box of each inferred frame (fall and depth motion).
+     */
+    bool submitDepth(int session_id, const DepthView& depth);
+
+    /**
+     * Run YOLO for the next scheduled session with a pending frame
+     * @param out Result of the inferred session
+     * @return false if no session had a pending frame
+     */
+    bool runNext(SessionResult& out);
+
+    /**
+     * Run YOLO for up to max_streams scheduled sessions concurrently.
+     *
+     * Each stream gets its own extractor with a share of the model's thread
+     * budget; preprocessing, forward pass and decoding all run in parallel
+     * across streams on the OpenMP pool that ncnn already uses.
+     * @param out Results, one per served session
+     * @return Number of sessions served
+     */
+    size_t runBatch(int max_streams, std::vector<SessionResult>& out);
+
+    /**
+     * Inferred frames per second of batch wall time (aggregate over sessions)
+     */
+    float getAggregateFps() const;
+
+    /**
+     * Latest result for a session
+     */
+    bool getResult(int session_id, SessionResult& out) const;
+
+    void setPolicy(SchedulingPolicy policy) { policy_ = policy; }
+    SchedulingPolicy getPolicy() const { return policy_; }
+
+    bool setPriority(int session_id, int priority);
+
+    /**
+     * Thermal state applied to every session's input-size governor
+     */
+    void setThermalState(ThermalState state) { thermal_state_ = static_cast<int>(state); }
+
+    /**
+     * Largest YOLO input size applied to every session's governor
+     */
+    void setMaxInputSize(int max_size) { max_input_size_ = max_size; }
+
+    size_t getSessionCount() const;
+
+    /**
+     * Shared model (for components that need the same weights)
+     */
+    std::shared_ptr<YoloModel> getModel() const { return model_; }
+
+    /**
+     * Remove all sessions and release the model
+     */
+    void cleanup();
+
+private:
+    std::shared_ptr<YoloModel> model_;
+    SchedulingPolicy policy_ = SchedulingPolicy::ROUND_ROBIN;
+    std::atomic<int> thermal_state_{0};
+    std::atomic<int> max_input_size_{640};
+
+    mutable std::mutex sessions_mutex_;
+    std::map<int, std::shared_ptr<CameraSession>> sessions_;
+    int next_session_id_ = 1;
+    int last_scheduled_id_ = 0;
+
+    // Aggregate throughput
+    mutable std::mutex stats_mutex_;
+    uint64_t batches_run_ = 0;
+    uint64_t frames_batched_ = 0;
+    float batch_time_ms_ = 0.0f;
+
+    // A pending frame taken for inference
+    struct ClaimedFrame {
+        std::shared_ptr<CameraSession> session;
+        int width = 0;
+        int height = 0;
+        PixelFormat format = PixelFormat::RGBA_8888;
+        int64_t timestamp_ms = 0;
+        MotionState motion = {};
+        int64_t seconds_since_motion = 0;
+    };
+
+    std::vector<std::shared_ptr<CameraSession>> pickBatch(int64_t now_ms, int max_count);
+    std::shared_ptr<CameraSession> findSession(int session_id) const;
+    bool claim(const std::shared_ptr<CameraSession>& session, ClaimedFrame& frame);
+    SessionResult infer(ClaimedFrame& frame, int num_threads);
+    void release(ClaimedFrame& frame, const SessionResult& result);
+    int getThreadBudget() const;
+};
+
+} // namespace triage
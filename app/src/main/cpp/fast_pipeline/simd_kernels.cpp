@@ -0,0 +1,285 @@
+#include "simd_kernels.h"
+#include <android/log.h>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define TRIAGE_TARGET_DOTPROD __attribute__((target("arch=armv8.2-a+dotprod")))
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TRIAGE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+#define TRIAGE_INLINE inline __attribute__((always_inline))
+
+#define LOG_TAG "SimdKernels"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+namespace {
+
+// ----------------------------------------------------------------------------
+// Portable bodies. Branch-free with restrict pointers, so each wrapper
+// below is auto-vectorized for the instruction set it is compiled for.
+// ----------------------------------------------------------------------------
+
+TRIAGE_INLINE void lumaRgbxBody(const uint8_t* row, int step, int count, int red_offset,
+                                uint8_t* __restrict out) {
+    const int blue_offset = 2 - red_offset;
+    for (int i = 0; i < count; i++) {
+        const uint8_t* p = row + static_cast<size_t>(i) * step * 4;
+        out[i] = static_cast<uint8_t>((77 * p[red_offset] + 150 * p[1] + 29 * p[blue_offset]) >> 8);
+    }
+}
+
+TRIAGE_INLINE void accumulateMomentsBody(const uint8_t* __restrict cur,
+                                         const uint8_t* __restrict prev, int count,
+                                         const MomentColumns& columns) {
+    uint32_t* __restrict sum_cur = columns.sum_cur;
+    uint32_t* __restrict sum_prev = columns.sum_prev;
+    uint32_t* __restrict sq_cur = columns.sq_cur;
+    uint32_t* __restrict sq_prev = columns.sq_prev;
+    uint32_t* __restrict cross = columns.cross;
+    uint32_t* __restrict abs_diff = columns.abs_diff;
+    for (int i = 0; i < count; i++) {
+        const uint32_t c = cur[i];
+        const uint32_t p = prev[i];
+        sum_cur[i] += c;
+        sum_prev[i] += p;
+        sq_cur[i] += c * c;
+        sq_prev[i] += p * p;
+        cross[i] += c * p;
+        abs_diff[i] += c > p ? c - p : p - c;
+    }
+}
+
+TRIAGE_INLINE void blendRowsBody(const uint16_t* __restrict top, const uint16_t* __restrict bottom,
+                                 int count, int weight, uint8_t* __restrict out) {
+    const uint32_t a = 256 - weight;
+    const uint32_t b = weight;
+    for (int i = 0; i < count; i++) {
+        out[i] = static_cast<uint8_t>((top[i] * a + bottom[i] * b + 32768u) >> 16);
+    }
+}
+
+TRIAGE_INLINE void depthRangeStatsBody(const uint16_t* __restrict row, int count,
+                                       DepthRangeStats& stats) {
+    // Invalid samples are 0: they add nothing to the sum or the max and
+    // are lifted out of the min
+    // (32-bit lanes throughout - mixed widths stop the vectorizer)
+    uint32_t valid = 0;
+    uint32_t sum = 0;            // <= count * 8191 per row
+    uint32_t lo = 0xFFFF;
+    uint32_t hi = 0;
+    for (int i = 0; i < count; i++) {
+        const uint32_t d = row[i];
+        const uint32_t d_or_max = d != 0 ? d : 0xFFFF;
+        valid += d != 0;
+        sum += d;
+        lo = d_or_max < lo ? d_or_max : lo;
+        hi = d > hi ? d : hi;
+    }
+    stats.count += valid;
+    stats.sum += sum;
+    stats.min = static_cast<uint16_t>(lo < stats.min ? lo : stats.min);
+    stats.max = static_cast<uint16_t>(hi > stats.max ? hi : stats.max);
+}
+
+TRIAGE_INLINE void maxRowsBody(const float* __restrict row, int count, float* __restrict best) {
+    for (int i = 0; i < count; i++) {
+        best[i] = best[i] > row[i] ? best[i] : row[i];
+    }
+}
+
+// Baseline ABI (NEON on arm64, SSE2 on x86-64)
+
+void lumaRgbxBaseline(const uint8_t* row, int step, int count, int red_offset, uint8_t* out) {
+    lumaRgbxBody(row, step, count, red_offset, out);
+}
+
+void accumulateMomentsBaseline(const uint8_t* cur, const uint8_t* prev, int count,
+                               const MomentColumns& columns) {
+    accumulateMomentsBody(cur, prev, count, columns);
+}
+
+void blendRowsBaseline(const uint16_t* top, const uint16_t* bottom, int count, int weight,
+                       uint8_t* out) {
+    blendRowsBody(top, bottom, count, weight, out);
+}
+
+void depthRangeStatsBaseline(const uint16_t* row, int count, DepthRangeStats& stats) {
+    depthRangeStatsBody(row, count, stats);
+}
+
+void maxRowsBaseline(const float* row, int count, float* best) {
+    maxRowsBody(row, count, best);
+}
+
+#if defined(__aarch64__)
+// ARMv8.2 dotprod: one UDOT gives the weighted R/G/B sum of four pixels
+
+TRIAGE_TARGET_DOTPROD
+void lumaRgbxDotprod(const uint8_t* row, int step, int count, int red_offset, uint8_t* out) {
+    // Weights per pixel byte: R 77, G 150, B 29, A 0
+    const uint8x16_t weights = vreinterpretq_u8_u32(
+        vdupq_n_u32(red_offset == 0 ? 0x001D964Du : 0x004D961Du));
+    const uint32x4_t zero = vdupq_n_u32(0);
+    int i = 0;
+
+    if (step == 1) {
+        for (; i + 8 <= count; i += 8) {
+            const uint8_t* p = row + static_cast<size_t>(i) * 4;
+            uint32x4_t lo = vdotq_u32(zero, vld1q_u8(p), weights);
+            uint32x4_t hi = vdotq_u32(zero, vld1q_u8(p + 16), weights);
+            vst1_u8(out + i, vmovn_u16(vcombine_u16(vshrn_n_u32(lo, 8), vshrn_n_u32(hi, 8))));
+        }
+    } else if (step == 4) {
+        // LD4 de-interleaves 16 pixels; lane 0 holds every 4th one. The
+        // loads end 3 pixels past the last sample, so the final block is
+        // left to the scalar tail.
+        for (; i + 9 <= count; i += 8) {
+            const uint32_t* p = reinterpret_cast<const uint32_t*>(row + static_cast<size_t>(i) * 16);
+            uint32x4x4_t a = vld4q_u32(p);
+            uint32x4x4_t b = vld4q_u32(p + 16);
+            uint32x4_t lo = vdotq_u32(zero, vreinterpretq_u8_u32(a.val[0]), weights);
+            uint32x4_t hi = vdotq_u32(zero, vreinterpretq_u8_u32(b.val[0]), weights);
+            vst1_u8(out + i, vmovn_u16(vcombine_u16(vshrn_n_u32(lo, 8), vshrn_n_u32(hi, 8))));
+        }
+    }
+
+    lumaRgbxBody(row + static_cast<size_t>(i) * step * 4, step, count - i, red_offset, out + i);
+}
+
+/**
+ * Dotprod luma against the portable body on a synthetic row, for each
+ * step and channel order it has a vector loop for (run once at selection)
+ */
+bool lumaRgbxDotprodMatchesBody() {
+    uint8_t row[160 * 4];
+    for (size_t j = 0; j < sizeof(row); j++) {
+        row[j] = static_cast<uint8_t>(j * 97 + 13);
+    }
+    std::memset(row, 255, 64);   // Largest weighted sum
+    std::memset(row + 64, 0, 64);
+
+    for (int step : {1, 4}) {
+        for (int red_offset : {0, 2}) {
+            const int count = (160 - 1) / step + 1;
+            uint8_t fast[160], ref[160];
+            lumaRgbxDotprod(row, step, count, red_offset, fast);
+            lumaRgbxBody(row, step, count, red_offset, ref);
+            if (std::memcmp(fast, ref, count) != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+// AVX2: the portable bodies at 256-bit width, plus a gather-based luma
+
+TRIAGE_TARGET_AVX2
+void lumaRgbxAvx2(const uint8_t* row, int step, int count, int red_offset, uint8_t* out) {
+    const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                             _mm256_set1_epi32(step));
+    const __m256i byte_mask = _mm256_set1_epi32(0xFF);
+    const __m256i red_shift = _mm256_set1_epi32(red_offset * 8);
+    const __m256i blue_shift = _mm256_set1_epi32((2 - red_offset) * 8);
+    const __m256i wr = _mm256_set1_epi32(77);
+    const __m256i wg = _mm256_set1_epi32(150);
+    const __m256i wb = _mm256_set1_epi32(29);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        const int* base = reinterpret_cast<const int*>(row + static_cast<size_t>(i) * step * 4);
+        __m256i px = _mm256_i32gather_epi32(base, index, 4);
+        __m256i r = _mm256_and_si256(_mm256_srlv_epi32(px, red_shift), byte_mask);
+        __m256i g = _mm256_and_si256(_mm256_srli_epi32(px, 8), byte_mask);
+        __m256i b = _mm256_and_si256(_mm256_srlv_epi32(px, blue_shift), byte_mask);
+        __m256i luma = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(r, wr),
+                                                         _mm256_mullo_epi32(g, wg)),
+                                        _mm256_mullo_epi32(b, wb));
+        luma = _mm256_srli_epi32(luma, 8);
+        __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(luma),
+                                         _mm256_extracti128_si256(luma, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(words, words));
+    }
+
+    lumaRgbxBody(row + static_cast<size_t>(i) * step * 4, step, count - i, red_offset, out + i);
+}
+
+TRIAGE_TARGET_AVX2
+void accumulateMomentsAvx2(const uint8_t* cur, const uint8_t* prev, int count,
+                           const MomentColumns& columns) {
+    accumulateMomentsBody(cur, prev, count, columns);
+}
+
+TRIAGE_TARGET_AVX2
+void blendRowsAvx2(const uint16_t* top, const uint16_t* bottom, int count, int weight,
+                   uint8_t* out) {
+    blendRowsBody(top, bottom, count, weight, out);
+}
+
+TRIAGE_TARGET_AVX2
+void depthRangeStatsAvx2(const uint16_t* row, int count, DepthRangeStats& stats) {
+    depthRangeStatsBody(row, count, stats);
+}
+
+TRIAGE_TARGET_AVX2
+void maxRowsAvx2(const float* row, int count, float* best) {
+    maxRowsBody(row, count, best);
+}
+#endif
+
+} // namespace
+
+SimdKernels selectSimdKernels(const CpuFeatures& features) {
+    SimdKernels k = {
+        "baseline",
+        lumaRgbxBaseline,
+        accumulateMomentsBaseline,
+        blendRowsBaseline,
+        depthRangeStatsBaseline,
+        maxRowsBaseline
+    };
+#if defined(__aarch64__)
+    if (features.dotprod) {
+        if (lumaRgbxDotprodMatchesBody()) {
+            k.name = "dotprod";
+            k.luma_rgbx = lumaRgbxDotprod;
+        } else {
+            LOGE("Dotprod luma differs from the portable kernel - not used");
+        }
+    }
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+    if (features.avx2 && features.fma) {
+        k.name = "avx2";
+        k.luma_rgbx = lumaRgbxAvx2;
+        k.accumulate_moments = accumulateMomentsAvx2;
+        k.blend_rows = blendRowsAvx2;
+        k.depth_range_stats = depthRangeStatsAvx2;
+        k.max_rows = maxRowsAvx2;
+    }
+#endif
+    (void)features;
+    return k;
+}
+
+const SimdKernels& simdKernels() {
+    static const SimdKernels kernels = [] {
+        SimdKernels k = selectSimdKernels(cpuFeatures());
+        LOGI("SIMD kernels: %s", k.name);
+        return k;
+    }();
+    return kernels;
+}
+
+} // namespace triage
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+
+#include "cpu_features.h"
+
+namespace triage {
+
+/**
+ * Per-column luma moments of two frames, accumulated row by row
+ * (each array has one entry per column)
+ */
+struct MomentColumns {
+    uint32_t* sum_cur;
+    uint32_t* sum_prev;
+    uint32_t* sq_cur;
+    uint32_t* sq_prev;
+    uint32_t* cross;
+    uint32_t* abs_diff;          // Sum of |cur - prev|
+};
+
+/**
+ * Statistics of the non-zero (valid) samples of a depth range plane
+ */
+struct DepthRangeStats {
+    uint32_t count = 0;
+    uint16_t min = 0xFFFF;
+    uint16_t max = 0;
+    uint64_t sum = 0;
+};
+
+/**
+ * Hot loops of the pipelines, one variant per instruction set.
+ *
+ * The table is filled once from cpuFeatures(), so a single baseline
+ * build runs the dotprod variants on ARMv8.2 cores and the AVX2
+ * variants on x86 hosts. Every variant returns bit-identical results.
+ */
+struct SimdKernels {
+    const char* name;    // Widest instruction set in use
+
+    /**
+     * Luma of every step-th pixel of a 4-byte-per-pixel row
+     * @param red_offset Byte of the red channel (0 RGBA, 2 BGRA)
+     */
+    void (*luma_rgbx)(const uint8_t* row, int step, int count, int red_offset, uint8_t* out);
+
+    /**
+     * Add one row of two luma grids to the per-column moments
+     */
+    void (*accumulate_moments)(const uint8_t* cur, const uint8_t* prev, int count,
+                               const MomentColumns& columns);
+
+    /**
+     * Vertical bilinear step: out = (top * (256 - weight) + bottom * weight) / 65536,
+     * rounded, with top and bottom in 8.8 fixed point
+     */
+    void (*blend_rows)(const uint16_t* top, const uint16_t* bottom, int count, int weight,
+                       uint8_t* out);
+
+    /**
+     * Merge a row of range samples (0 = invalid) into stats
+     */
+    void (*depth_range_stats)(const uint16_t* row, int count, DepthRangeStats& stats);
+
+    /**
+     * best[i] = max(best[i], row[i])
+     */
+    void (*max_rows)(const float* row, int count, float* best);
+};
+
+/**
+ * Kernels for this CPU (selected on first use)
+ */
+const SimdKernels& simdKernels();
+
+/**
+ * Kernels for a given feature set - for benchmarking a variant against
+ * the baseline on the same device
+ */
+SimdKernels selectSimdKernels(const CpuFeatures& features);
+
+} // namespace triage
@@ -0,0 +1,157 @@
+#include "sleep_wake_estimator.h"
+#include <android/log.h>
+#include <algorithm>
+
+#define LOG_TAG "SleepWakeEstimator"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+namespace {
+// Cole-Kripke 30 s epoch weights: A-4, A-3, A-2, A-1, A0, A+1, A+2
+constexpr float CK_WEIGHTS[7] = {50.0f, 30.0f, 14.0f, 28.0f, 121.0f, 8.0f, 50.0f};
+constexpr float CK_SCALE = 0.0001f;
+// Index of the scored epoch (A0) in the 7-epoch window
+constexpr int CK_CENTER = 4;
+// EMA weight for the per-frame activity level
+constexpr float ACTIVITY_ALPHA = 0.05f;
+}
+
+SleepWakeEstimator::SleepWakeEstimator() {
+    reset();
+}
+
+SleepWakeEstimator::~SleepWakeEstimator() {
+}
+
+void SleepWakeEstimator::init(int64_t epoch_ms, float count_scale, float restless_count) {
+    epoch_ms_ = std::max<int64_t>(epoch_ms, 1000);
+    count_scale_ = count_scale;
+    restless_count_ = restless_count;
+    reset();
+    LOGI("Sleep/wake estimator initialized (epoch=%llds, scale=%.1f, restless=%.1f)",
+         (long long)(epoch_ms_ / 1000), count_scale, restless_count);
+}
+
+bool SleepWakeEstimator::addFrame(float active_cell_fraction, int64_t timestamp_ms) {
+    activity_level_ += ACTIVITY_ALPHA * (active_cell_fraction - activity_level_);
+
+    if (epoch_start_ms_ == 0) {
+        epoch_start_ms_ = timestamp_ms;
+        state_since_ms_ = timestamp_ms;
+    }
+
+    bool scored = false;
+
+    if (timestamp_ms - epoch_start_ms_ >= epoch_ms_) {
+        // Percentage of active cells, averaged over the epoch, scaled to counts
+        float count = epoch_frames_ > 0
+            ? static_cast<float>(epoch_sum_ / epoch_frames_) * 100.0f * count_scale_
+            : 0.0f;
+        closeEpoch(count);
+        scored = window_filled_ >= 7;
+
+        // A gap of several epochs (pipeline paused) breaks the scoring window
+        if (timestamp_ms - epoch_start_ms_ >= 3 * epoch_ms_) {
+            window_filled_ = 0;
+            epoch_start_ms_ = timestamp_ms;
+        } else {
+            epoch_start_ms_ += epoch_ms_;
+        }
+        epoch_sum_ = 0.0;
+        epoch_frames_ = 0;
+    }
+
+    epoch_sum_ += active_cell_fraction;
+    epoch_frames_++;
+
+    return scored;
+}
+
+void SleepWakeEstimator::closeEpoch(float count) {
+    // Shift window left; newest epoch goes in slot 6
+    for (int i = 0; i < 6; i++) {
+        window_[i] = window_[i + 1];
+        window_start_[i] = window_start_[i + 1];
+    }
+    window_[6] = count;
+    window_start_[6] = epoch_start_ms_;
+    window_filled_ = std::min(window_filled_ + 1, 7);
+
+    if (window_filled_ >= 7) {
+        scoreEpoch();
+    }
+}
+
+void SleepWakeEstimator::scoreEpoch() {
+    float d = 0.0f;
+    for (int i = 0; i < 7; i++) {
+        d += CK_WEIGHTS[i] * window_[i];
+    }
+    d *= CK_SCALE;
+
+    float a0 = window_[CK_CENTER];
+    SleepState scored;
+    if (d >= 1.0f) {
+        scored = SleepState::WAKE;
+        wake_epochs_++;
+    } else if (a0 >= restless_count_) {
+        scored = SleepState::RESTLESS;
+        restless_epochs_++;
+    } else {
+        scored = SleepState::SLEEP;
+        sleep_epochs_++;
+    }
+
+    SleepEpoch& epoch = history_[history_head_];
+    epoch.start_ms = window_start_[CK_CENTER];
+    epoch.activity_count = a0;
+    epoch.score = d;
+    epoch.state = scored;
+    history_head_ = (history_head_ + 1) % HISTORY_EPOCHS;
+    history_count_ = std::min(history_count_ + 1, HISTORY_EPOCHS);
+
+    if (scored != state_) {
+        LOGI("Sleep state %d -> %d (D=%.2f, count=%.1f)",
+             static_cast<int>(state_), static_cast<int>(scored), d, a0);
+        state_ = scored;
+        state_since_ms_ = epoch.start_ms;
+    }
+}
+
+int64_t SleepWakeEstimator::getMsInState(int64_t now_ms) const {
+    if (state_ == SleepState::UNKNOWN) {
+        return 0;
+    }
+    return std::max<int64_t>(0, now_ms - state_since_ms_);
+}
+
+std::vector<SleepEpoch> SleepWakeEstimator::getRecentEpochs() const {
+    std::vector<SleepEpoch> out;
+    out.reserve(history_count_);
+
+    int start = (history_head_ - history_count_ + HISTORY_EPOCHS) % HISTORY_EPOCHS;
+    for (int i = 0; i < history_count_; i++) {
+        out.push_back(history_[(start + i) % HISTORY_EPOCHS]);
+    }
+    return out;
+}
+
+void SleepWakeEstimator::reset() {
+    epoch_start_ms_ = 0;
+    epoch_sum_ = 0.0;
+    epoch_frames_ = 0;
+    window_.fill(0.0f);
+    window_start_.fill(0);
+    window_filled_ = 0;
+    state_ = SleepState::UNKNOWN;
+    state_since_ms_ = 0;
+    activity_level_ = 0.0f;
+    sleep_epochs_ = 0;
+    wake_epochs_ = 0;
+    restless_epochs_ = 0;
+    history_head_ = 0;
+    history_count_ = 0;
+}
+
+} // namespace triage
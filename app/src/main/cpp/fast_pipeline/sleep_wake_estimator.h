@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace triage {
+
+enum class SleepState {
+    UNKNOWN = 0,
+    SLEEP = 1,
+    WAKE = 2,
+    RESTLESS = 3    // Scored sleep with elevated movement
+};
+
+/**
+ * One scored 30-second epoch
+ */
+struct SleepEpoch {
+    int64_t start_ms;
+    float activity_count;        // Actigraphy-style count for the epoch
+    float score;                 // Cole-Kripke D (>= 1 means wake)
+    SleepState state;
+};
+
+/**
+ * Streaming sleep/wake estimator over motion-grid activity.
+ *
+ * Each frame contributes the fraction of active motion-grid cells; frames
+ * are integrated into 30 s epochs (O(1) per frame). Epochs are scored with
+ * the Cole-Kripke 30-second weights:
+ *
+ *   D = 0.0001 * (50 A-4 + 30 A-3 + 14 A-2 + 28 A-1 + 121 A0 + 8 A+1 + 50 A+2)
+ *
+ * so an epoch is scored two epochs (~60 s) after it ends. D >= 1 is wake;
+ * sleep epochs with high activity are reported as restless.
+ *
+ * Gives continuous alertness context between VLM runs.
+ */
+class SleepWakeEstimator {
+public:
+    static const int HISTORY_EPOCHS = 240;   // 2 hours of 30 s epochs
+
+    SleepWakeEstimator();
+    ~SleepWakeEstimator();
+
+    /**
+     * Configure scoring
+     * @param epoch_ms Epoch length (Cole-Kripke weights assume 30 s)
+     * @param count_scale Scales mean active-cell percentage to actigraphy counts
+     * @param restless_count Epoch count above which sleep is scored restless
+     */
+    void init(int64_t epoch_ms = 30000, float count_scale = 4.0f, float restless_count = 15.0f);
+
+    /**
+     * Add one frame of motion
+     * @param active_cell_fraction Fraction of active motion-grid cells (0-1)
+     * @param timestamp_ms Frame time
+     * @return true if a new epoch was scored
+     */
+    bool addFrame(float active_cell_fraction, int64_t timestamp_ms);
+
+    /**
+     * Latest scored state
+     */
+    SleepState getState() const { return state_; }
+
+    /**
+     * Smoothed per-frame activity (0-1), available immediately
+     */
+    float getActivityLevel() const { return activity_level_; }
+
+    /**
+     * Time in the current scored state (ms)
+     */
+    int64_t getMsInState(int64_t now_ms) const;
+
+    /**
+     * Scored minutes per state since reset
+     */
+    float getSleepMinutes() const { return sleep_epochs_ * epoch_ms_ / 60000.0f; }
+    float getWakeMinutes() const { return wake_epochs_ * epoch_ms_ / 60000.0f; }
+    float getRestlessMinutes() const { return restless_epochs_ * epoch_ms_ / 60000.0f; }
+
+    /**
+     * Scored epochs, oldest first (at most HISTORY_EPOCHS)
+     */
+    std::vector<SleepEpoch> getRecentEpochs() const;
+
+    void reset();
+
+private:
+    int64_t epoch_ms_ = 30000;
+    float count_scale_ = 4.0f;
+    float restless_count_ = 15.0f;
+
+    // Current (open) epoch
+    int64_t epoch_start_ms_ = 0;
+    double epoch_sum_ = 0.0;
+    int epoch_frames_ = 0;
+
+    // Last 7 epoch counts for the scoring window (index 6 = newest)
+    std::array<float, 7> window_{};
+    std::array<int64_t, 7> window_start_{};
+    int window_filled_ = 0;
+
+    // Output
+    SleepState state_ = SleepState::UNKNOWN;
+    int64_t state_since_ms_ = 0;
+    float activity_level_ = 0.0f;
+    int sleep_epochs_ = 0;
+    int wake_epochs_ = 0;
+    int restless_epochs_ = 0;
+
+    std::array<SleepEpoch, HISTORY_EPOCHS> history_;
+    int history_head_ = 0;
+    int history_count_ = 0;
+
+    void closeEpoch(float count);
+    void scoreEpoch();
+};
+
+} // namespace triage
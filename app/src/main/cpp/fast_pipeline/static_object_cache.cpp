@@ -0,0 +1,188 @@
+#include "static_object_cache.h"
+#include "yolo_detector.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cmath>
+
+#define LOG_TAG "StaticObjectCache"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+namespace {
+// Persistence of a first sighting, and the step toward 1 per re-sighting
+constexpr float INITIAL_PERSISTENCE = 0.4f;
+constexpr float HIT_GAIN = 0.4f;
+// Decay per missed pass
+constexpr float MISS_DECAY = 0.7f;
+// Hysteresis: stable at 3 sightings, unstable after ~3 misses
+constexpr float STABLE_ON = 0.7f;
+constexpr float STABLE_OFF = 0.3f;
+constexpr float DROP_BELOW = 0.1f;
+// Box smoothing across passes
+constexpr float BOX_ALPHA = 0.3f;
+// Edge movement (normalized) of a stable box that counts as moved
+constexpr float MOVE_THRESHOLD = 0.05f;
+// Refresh this much faster while nothing is stable yet
+constexpr int WARMUP_DIVISOR = 6;
+constexpr float NMS_THRESHOLD = 0.45f;
+
+float boxIou(const float a[4], const float b[4]) {
+    float iw = std::min(a[2], b[2]) - std::max(a[0], b[0]);
+    float ih = std::min(a[3], b[3]) - std::max(a[1], b[1]);
+    if (iw <= 0.0f || ih <= 0.0f) return 0.0f;
+    float inter = iw * ih;
+    float area_a = (a[2] - a[0]) * (a[3] - a[1]);
+    float area_b = (b[2] - b[0]) * (b[3] - b[1]);
+    return inter / std::max(area_a + area_b - inter, 1e-6f);
+}
+}
+
+StaticObjectCache::StaticObjectCache() {
+}
+
+StaticObjectCache::~StaticObjectCache() {
+}
+
+void StaticObjectCache::init(int64_t refresh_interval_ms, float match_iou) {
+    refresh_interval_ms_ = std::max<int64_t>(1000, refresh_interval_ms);
+    match_iou_ = match_iou;
+    clear();
+    LOGI("Static object cache initialized (refresh=%lldms, match IoU=%.2f)",
+         (long long)refresh_interval_ms_, match_iou_);
+}
+
+bool StaticObjectCache::isStaticClass(int class_id) {
+    switch (class_id) {
+        case CHAIR:
+        case COUCH:
+        case BED:
+        case DINING_TABLE:
+        case TOILET:
+        case TV:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool StaticObjectCache::isRefreshDue(int64_t now_ms) const {
+    if (last_refresh_ms_ < 0) {
+        return true;
+    }
+    bool any_stable = std::any_of(objects_.begin(), objects_.end(),
+                                  [](const StaticObject& o) { return o.stable; });
+    int64_t interval = any_stable ? refresh_interval_ms_ : refresh_interval_ms_ / WARMUP_DIVISOR;
+    return now_ms - last_refresh_ms_ >= interval;
+}
+
+void StaticObjectCache::update(const std::vector<Detection>& detections, int width, int height,
+                               int64_t now_ms) {
+    last_refresh_ms_ = now_ms;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    // Raw head output has many boxes per object - one per object here
+    std::vector<Detection> candidates;
+    for (const auto& det : detections) {
+        if (isStaticClass(det.class_id)) {
+            candidates.push_back(det);
+        }
+    }
+    YoloDetector::applyNms(candidates, NMS_THRESHOLD);
+
+    std::vector<bool> matched(objects_.size(), false);
+    bool changed = false;
+
+    for (const auto& det : candidates) {
+        float box[4] = {det.x1 / width, det.y1 / height, det.x2 / width, det.y2 / height};
+
+        // Best unmatched cached object of the same class
+        int best = -1;
+        float best_iou = match_iou_;
+        for (size_t i = 0; i < objects_.size(); i++) {
+            if (matched[i] || objects_[i].class_id != det.class_id) continue;
+            const float cached[4] = {objects_[i].x1, objects_[i].y1, objects_[i].x2, objects_[i].y2};
+            float overlap = boxIou(box, cached);
+            if (overlap >= best_iou) {
+                best_iou = overlap;
+                best = static_cast<int>(i);
+            }
+        }
+
+        if (best < 0) {
+            StaticObject obj = {};
+            obj.class_id = det.class_id;
+            obj.class_name = det.class_name;
+            obj.x1 = box[0]; obj.y1 = box[1]; obj.x2 = box[2]; obj.y2 = box[3];
+            obj.confidence = det.confidence;
+            obj.persistence = INITIAL_PERSISTENCE;
+            obj.sightings = 1;
+            std::copy(box, box + 4, obj.reported);
+            objects_.push_back(obj);
+            matched.push_back(true);
+            continue;
+        }
+
+        StaticObject& obj = objects_[best];
+        matched[best] = true;
+        obj.x1 += BOX_ALPHA * (box[0] - obj.x1);
+        obj.y1 += BOX_ALPHA * (box[1] - obj.y1);
+        obj.x2 += BOX_ALPHA * (box[2] - obj.x2);
+        obj.y2 += BOX_ALPHA * (box[3] - obj.y2);
+        obj.confidence = det.confidence;
+        obj.persistence += HIT_GAIN * (1.0f - obj.persistence);
+        obj.sightings++;
+    }
+
+    for (size_t i = 0; i < objects_.size(); i++) {
+        StaticObject& obj = objects_[i];
+        if (!matched[i]) {
+            obj.persistence *= MISS_DECAY;
+        }
+
+        bool was_stable = obj.stable;
+        obj.stable = obj.stable ? obj.persistence >= STABLE_OFF : obj.persistence >= STABLE_ON;
+
+        float moved = std::max({std::fabs(obj.x1 - obj.reported[0]), std::fabs(obj.y1 - obj.reported[1]),
+                                std::fabs(obj.x2 - obj.reported[2]), std::fabs(obj.y2 - obj.reported[3])});
+        if (obj.stable != was_stable || (obj.stable && moved > MOVE_THRESHOLD)) {
+            obj.reported[0] = obj.x1; obj.reported[1] = obj.y1;
+            obj.reported[2] = obj.x2; obj.reported[3] = obj.y2;
+            changed = true;
+            LOGI("%s %s at (%.2f, %.2f)-(%.2f, %.2f), persistence %.2f",
+                 obj.class_name.c_str(), obj.stable ? (was_stable ? "moved" : "stable") : "lost",
+                 obj.x1, obj.y1, obj.x2, obj.y2, obj.persistence);
+        }
+    }
+
+    objects_.erase(std::remove_if(objects_.begin(), objects_.end(),
+                                  [](const StaticObject& o) { return o.persistence < DROP_BELOW; }),
+                   objects_.end());
+
+    if (changed) {
+        revision_++;
+    }
+}
+
+const StaticObject* StaticObjectCache::findStable(int class_id) const {
+    const StaticObject* best = nullptr;
+    for (const auto& obj : objects_) {
+        if (obj.class_id == class_id && obj.stable &&
+            (!best || obj.persistence > best->persistence)) {
+            best = &obj;
+        }
+    }
+    return best;
+}
+
+void StaticObjectCache::clear() {
+    if (!objects_.empty()) {
+        revision_++;
+    }
+    objects_.clear();
+    last_refresh_ms_ = -1;
+}
+
+} // namespace triage
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace triage {
+
+struct Detection;
+
+/**
+ * Furniture / fixed equipment remembered between full-class passes
+ */
+struct StaticObject {
+    int class_id;
+    std::string class_name;
+    float x1, y1, x2, y2;        // Smoothed box (normalized 0-1)
+    float confidence;            // Detector confidence at the last sighting
+    float persistence;           // 0-1: rises with each sighting, decays when missed
+    bool stable;                 // Seen often enough to trust (with hysteresis)
+    int sightings;
+    float reported[4];           // Box when the revision last changed for it
+};
+
+/**
+ * Remembers where the furniture is.
+ *
+ * Beds, chairs and monitors do not move, so a full 80-class pass is only
+ * needed now and then; the frames in between decode the person class
+ * alone. Each full-class pass is matched per class by IoU against the
+ * cached objects: a match raises the persistence and smooths the box, a
+ * miss decays it (a nurse standing in front of a chair for one pass does
+ * not remove it), and objects below a floor are dropped.
+ *
+ * The revision counter changes whenever a stable object appears,
+ * disappears or moves, so consumers (bed region) only recompute then.
+ */
+class StaticObjectCache {
+public:
+    // COCO ids of the classes that are cached
+    static const int CHAIR = 56;
+    static const int COUCH = 57;
+    static const int BED = 59;
+    static const int DINING_TABLE = 60;
+    static const int TOILET = 61;
+    static const int TV = 62;                    // Bedside monitors detect as tv
+
+    StaticObjectCache();
+    ~StaticObjectCache();
+
+    /**
+     * @param refresh_interval_ms Time between full-class passes once the
+     *        scene is known (faster while nothing is stable yet)
+     * @param match_iou Overlap for a detection to update a cached object
+     */
+    void init(int64_t refresh_interval_ms = 30000, float match_iou = 0.3f);
+
+    static bool isStaticClass(int class_id);
+
+    /**
+     * Whether the next frame should decode all classes
+     */
+    bool isRefreshDue(int64_t now_ms) const;
+
+    /**
+     * Fold in the detections of a full-class pass
+     * @param detections All classes, pixel coordinates
+     */
+    void update(const std::vector<Detection>& detections, int width, int height, int64_t now_ms);
+
+    const std::vector<StaticObject>& getObjects() const { return objects_; }
+
+    /**
+     * Most persistent stable object of a class, or nullptr
+     */
+    const StaticObject* findStable(int class_id) const;
+
+    uint32_t getRevision() const { return revision_; }
+
+    /**
+     * Forget everything (camera moved) - the next frame runs a full pass
+     */
+    void clear();
+
+private:
+    int64_t refresh_interval_ms_ = 30000;
+    float match_iou_ = 0.3f;
+
+    std::vector<StaticObject> objects_;
+    int64_t last_refresh_ms_ = -1;
+    uint32_t revision_ = 0;
+};
+
+} // namespace triage
@@ -0,0 +1,270 @@
+#include "thread_pool.h"
+#include <android/log.h>
+#include <algorithm>
+
+#define LOG_TAG "ThreadPool"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+namespace {
+
+// parallelFor chunks per available thread: enough slack to even out rows
+// of uneven cost and a late-starting worker, few enough to stay cheap
+constexpr int CHUNKS_PER_THREAD = 4;
+
+thread_local TaskPriority t_priority = TaskPriority::FAST;
+thread_local const ThreadPool* t_pool = nullptr;   // Set on the pool's own workers
+thread_local int t_worker = -1;
+
+/**
+ * One parallelFor call; shared with the helper tasks, which may start
+ * after the call has returned (they then find no chunk left)
+ */
+struct ParallelJob {
+    const std::function<void(int, int)>* body;
+    int begin;
+    int range;
+    int chunks;
+    std::atomic<int> next{0};
+    std::atomic<int> done{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+/**
+ * Claim and run chunks until none are left
+ * @return Chunks run by this thread
+ */
+int runChunks(ParallelJob& job) {
+    int ran = 0;
+    for (;;) {
+        const int c = job.next.fetch_add(1);
+        if (c >= job.chunks) {
+            break;
+        }
+        const int b = job.begin + static_cast<int>(static_cast<int64_t>(job.range) * c / job.chunks);
+        const int e = job.begin + static_cast<int>(static_cast<int64_t>(job.range) * (c + 1) / job.chunks);
+        (*job.body)(b, e);
+        ran++;
+        if (job.done.fetch_add(1) + 1 == job.chunks) {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            job.finished.notify_all();
+        }
+    }
+    return ran;
+}
+
+} // namespace
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::ThreadPool(int num_workers) {
+    if (num_workers <= 0) {
+        // The submitting thread runs its share of every parallelFor
+        num_workers = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    }
+    num_workers = std::max(num_workers, 0);
+
+    workers_.reserve(num_workers);
+    for (int i = 0; i < num_workers; i++) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < num_workers; i++) {
+        workers_[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
+    }
+    LOGI("Thread pool started: %d workers", num_workers);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+TaskPriority ThreadPool::currentPriority() {
+    return t_priority;
+}
+
+void ThreadPool::submit(std::function<void()> task, TaskPriority priority) {
+    if (workers_.empty()) {
+        task();
+        return;
+    }
+
+    // A worker keeps its own subtasks (they share its cache); other
+    // threads spread theirs over the workers
+    int target = (t_pool == this) ? t_worker
+               : static_cast<int>(next_queue_.fetch_add(1) % workers_.size());
+    {
+        Worker& worker = *workers_[target];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queues[static_cast<int>(priority)].push_back({std::move(task), priority});
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        queued_++;
+    }
+    wake_.notify_one();
+}
+
+void ThreadPool::parallelFor(int begin, int end, int grain,
+                             const std::function<void(int, int)>& body, TaskPriority priority) {
+    if (end <= begin) {
+        return;
+    }
+    parallel_fors_++;
+
+    const int range = end - begin;
+    const int threads = availableThreads();
+    const int max_chunks = (range + std::max(grain, 1) - 1) / std::max(grain, 1);
+    const int chunks = std::min(max_chunks, threads * CHUNKS_PER_THREAD);
+    if (chunks <= 1 || threads <= 1) {
+        body(begin, end);
+        chunks_run_++;
+        chunks_by_caller_++;
+        return;
+    }
+
+    auto job = std::make_shared<ParallelJob>();
+    job->body = &body;
+    job->begin = begin;
+    job->range = range;
+    job->chunks = chunks;
+
+    const int helpers = std::min(chunks, threads) - 1;
+    for (int i = 0; i < helpers; i++) {
+        submit([this, job] {
+            chunks_run_ += runChunks(*job);
+        }, priority);
+    }
+
+    // Work alongside the helpers, then wait for chunks they already hold
+    {
+        const TaskPriority previous = t_priority;
+        t_priority = priority;
+        const int mine = runChunks(*job);
+        t_priority = previous;
+        chunks_run_ += mine;
+        chunks_by_caller_ += mine;
+    }
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&] { return job->done.load() == job->chunks; });
+}
+
+int ThreadPool::availableThreads() const {
+    const int cores = workers() + 1;
+    return std::max(1, cores - external_threads_.load());
+}
+
+bool ThreadPool::mayRun() const {
+    // Workers share the cores left over by external threads and by the
+    // thread running its own share of a parallelFor
+    return active_workers_.load() < availableThreads() - 1;
+}
+
+ThreadPoolStats ThreadPool::getStats() const {
+    ThreadPoolStats stats;
+    stats.workers = workers();
+    stats.active_workers = active_workers_.load();
+    stats.external_threads = external_threads_.load();
+    stats.tasks_run = tasks_run_.load();
+    stats.tasks_stolen = tasks_stolen_.load();
+    stats.parallel_fors = parallel_fors_.load();
+    stats.chunks_run = chunks_run_.load();
+    stats.chunks_by_caller = chunks_by_caller_.load();
+    return stats;
+}
+
+void ThreadPool::lendThreads(int delta) {
+    external_threads_ += delta;
+    if (delta < 0) {
+        // Cores handed back: parked workers may resume
+        { std::lock_guard<std::mutex> lock(wake_mutex_); }
+        wake_.notify_all();
+    }
+}
+
+bool ThreadPool::takeTask(int index, Task& out) {
+    const int n = workers();
+    for (int p = 0; p < NUM_PRIORITIES; p++) {
+        // Own queue, newest first
+        {
+            Worker& own = *workers_[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.queues[p].empty()) {
+                out = std::move(own.queues[p].back());
+                own.queues[p].pop_back();
+                return true;
+            }
+        }
+        // Steal the oldest task of another worker
+        for (int k = 1; k < n; k++) {
+            Worker& victim = *workers_[(index + k) % n];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.queues[p].empty()) {
+                out = std::move(victim.queues[p].front());
+                victim.queues[p].pop_front();
+                tasks_stolen_++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(int index) {
+    t_pool = this;
+    t_worker = index;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait(lock, [&] { return stopping_ || (queued_.load() > 0 && mayRun()); });
+            if (stopping_ && queued_.load() <= 0) {
+                return;
+            }
+            // Counted under the lock so parked workers stay parked
+            active_workers_++;
+        }
+
+        Task task;
+        if (takeTask(index, task)) {
+            queued_--;
+            t_priority = task.priority;
+            task.fn();
+            t_priority = TaskPriority::FAST;
+            tasks_run_++;
+        }
+        active_workers_--;
+    }
+}
+
+ThreadPool::PriorityScope::PriorityScope(TaskPriority priority) : previous_(t_priority) {
+    t_priority = priority;
+}
+
+ThreadPool::PriorityScope::~PriorityScope() {
+    t_priority = previous_;
+}
+
+ThreadPool::ExternalThreads::ExternalThreads(int threads, ThreadPool& pool)
+    : pool_(pool), threads_(std::max(threads, 0)) {
+    pool_.lendThreads(threads_);
+}
+
+ThreadPool::ExternalThreads::~ExternalThreads() {
+    pool_.lendThreads(-threads_);
+}
+
+} // namespace triage
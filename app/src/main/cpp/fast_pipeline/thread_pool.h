@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace triage {
+
+/**
+ * Queue a task runs from. Idle workers drain every FAST queue (their own,
+ * then by stealing) before they look at a SLOW one.
+ */
+enum class TaskPriority {
+    FAST = 0,    // Fast pipeline: motion, detection, depth
+    SLOW = 1     // Slow pipeline: VLM preprocessing, background work
+};
+
+/**
+ * Thread pool statistics
+ */
+struct ThreadPoolStats {
+    int workers;
+    int active_workers;          // Workers currently running a task
+    int external_threads;        // Cores lent to OpenMP / llama.cpp
+    uint64_t tasks_run;
+    uint64_t tasks_stolen;       // Taken from another worker's queue
+    uint64_t parallel_fors;
+    uint64_t chunks_run;
+    uint64_t chunks_by_caller;   // parallelFor chunks run on the calling thread
+};
+
+/**
+ * Process-wide work-stealing pool for the native CPU stages.
+ *
+ * One worker per core, minus one for the thread that submits work. Each
+ * worker owns a queue per priority: it pops its own newest task first
+ * (cache-warm) and steals the oldest task of another worker when its own
+ * queues are empty.
+ *
+ * parallelFor() splits a row range into chunks that the caller and idle
+ * workers claim from a shared counter. The caller always takes part and
+ * never waits on a chunk nobody has started, so it completes on a busy
+ * pool, from inside a worker, and when nested.
+ *
+ * ncnn (OpenMP) and llama.cpp run their own threads. Code about to start
+ * them holds an ExternalThreads scope for the cores they use, and the pool
+ * parks that many workers until the scope ends, so the two never run more
+ * threads than there are cores.
+ */
+class ThreadPool {
+public:
+    /**
+     * The shared pool (started on first use)
+     */
+    static ThreadPool& instance();
+
+    /**
+     * @param num_workers Worker threads (0 = online cores - 1)
+     */
+    explicit ThreadPool(int num_workers = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Queue a task; from a worker it goes to that worker's own queue
+     */
+    void submit(std::function<void()> task, TaskPriority priority = currentPriority());
+
+    /**
+     * Run body(begin, end) over [begin, end) in chunks of at least grain
+     * rows and return when every chunk is done
+     */
+    void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& body,
+                     TaskPriority priority = currentPriority());
+
+    int workers() const { return static_cast<int>(workers_.size()); }
+
+    /**
+     * Threads the caller can expect for a parallel region right now
+     * (workers not parked for external threads, plus the caller)
+     */
+    int availableThreads() const;
+
+    ThreadPoolStats getStats() const;
+
+    /**
+     * Priority of the calling thread: FAST unless a PriorityScope says
+     * otherwise. Pool workers run each task at the priority it was queued
+     * with, so nested parallelFor calls inherit it.
+     */
+    static TaskPriority currentPriority();
+
+    /**
+     * Runs the current thread's pool work at a priority until destroyed
+     */
+    class PriorityScope {
+    public:
+        explicit PriorityScope(TaskPriority priority);
+        ~PriorityScope();
+    private:
+        TaskPriority previous_;
+    };
+
+    /**
+     * Lends cores to threads the pool does not own (OpenMP regions,
+     * llama.cpp) until destroyed
+     */
+    class ExternalThreads {
+    public:
+        ExternalThreads(int threads, ThreadPool& pool = ThreadPool::instance());
+        ~ExternalThreads();
+    private:
+        ThreadPool& pool_;
+        int threads_;
+    };
+
+private:
+    static const int NUM_PRIORITIES = 2;
+
+    struct Task {
+        std::function<void()> fn;
+        TaskPriority priority;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> queues[NUM_PRIORITIES];
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    // Sleeping workers wait for queued work or for cores to be handed back
+    mutable std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::atomic<int> queued_{0};
+    std::atomic<int> external_threads_{0};
+    std::atomic<int> active_workers_{0};
+    std::atomic<unsigned> next_queue_{0};
+    bool stopping_ = false;
+
+    std::atomic<uint64_t> tasks_run_{0};
+    std::atomic<uint64_t> tasks_stolen_{0};
+    std::atomic<uint64_t> parallel_fors_{0};
+    std::atomic<uint64_t> chunks_run_{0};
+    std::atomic<uint64_t> chunks_by_caller_{0};
+
+    void workerLoop(int index);
+    bool takeTask(int index, Task& out);
+    bool mayRun() const;
+    void lendThreads(int delta);
+};
+
+} // namespace triage
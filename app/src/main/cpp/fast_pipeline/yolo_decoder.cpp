@@ -0,0 +1,114 @@
+#include "yolo_decoder.h"
+
+namespace triage {
+
+namespace {
+// Feature counts of the compiled heads
+constexpr int COCO_CLASSES = 80;
+constexpr int COCO_KEYPOINTS = 17;
+constexpr int DETECT_FEATURES = 4 + COCO_CLASSES;            // 84
+constexpr int POSE_FEATURES = 4 + 1 + COCO_KEYPOINTS * 3;    // 56
+
+using DetectFeatureMajor = YoloHeadDecoder<HeadLayout::FEATURE_MAJOR, COCO_CLASSES, BoxEncoding::CXCYWH>;
+using DetectAnchorMajor = YoloHeadDecoder<HeadLayout::ANCHOR_MAJOR, COCO_CLASSES, BoxEncoding::CXCYWH>;
+using PoseFeatureMajor = YoloHeadDecoder<HeadLayout::FEATURE_MAJOR, 1, BoxEncoding::CXCYWH, COCO_KEYPOINTS>;
+using PoseAnchorMajor = YoloHeadDecoder<HeadLayout::ANCHOR_MAJOR, 1, BoxEncoding::CXCYWH, COCO_KEYPOINTS>;
+
+/**
+ * Runtime-generic decode: any class count, box-only, one feature lookup
+ * per element
+ */
+void decodeGeneric(const float* data, int num_anchors, int features, HeadLayout layout,
+                   const DecodeTransform& t, std::vector<Detection>& out, int only_class) {
+    const bool feature_major = layout == HeadLayout::FEATURE_MAJOR;
+    auto at = [&](int anchor, int feature) {
+        return feature_major ? data[feature * num_anchors + anchor]
+                             : data[anchor * features + feature];
+    };
+
+    for (int i = 0; i < num_anchors; i++) {
+        int best_class = 0;
+        float best_score = 0;
+        if (only_class >= 0) {
+            best_class = only_class;
+            best_score = at(i, 4 + only_class);
+        } else {
+            for (int j = 4; j < features; j++) {
+                float score = at(i, j);
+                if (score > best_score) {
+                    best_score = score;
+                    best_class = j - 4;
+                }
+            }
+        }
+        if (best_score < t.conf_threshold) continue;
+
+        float cx = at(i, 0), cy = at(i, 1), bw = at(i, 2), bh = at(i, 3);
+        Detection det;
+        det.x1 = t.offset_x + (cx - bw/2) * t.scale_x;
+        det.y1 = t.offset_y + (cy - bh/2) * t.scale_y;
+        det.x2 = t.offset_x + (cx + bw/2) * t.scale_x;
+        det.y2 = t.offset_y + (cy + bh/2) * t.scale_y;
+        det.confidence = best_score;
+        det.class_id = best_class;
+        out.push_back(std::move(det));
+    }
+}
+}
+
+YoloHeadType identifyYoloHead(int out_w, int out_h, HeadLayout& layout, int& features) {
+    // Far more anchors than features, so the short side is the feature axis
+    layout = out_h <= out_w ? HeadLayout::FEATURE_MAJOR : HeadLayout::ANCHOR_MAJOR;
+    features = layout == HeadLayout::FEATURE_MAJOR ? out_h : out_w;
+
+    if (features == DETECT_FEATURES) {
+        return YoloHeadType::DETECT_COCO;
+    }
+    if (features == POSE_FEATURES) {
+        return YoloHeadType::POSE_COCO;
+    }
+    return YoloHeadType::UNKNOWN;
+}
+
+void decodeYoloHead(YoloHeadType type, HeadLayout layout, int features,
+                    const float* data, int num_anchors, const DecodeTransform& t,
+                    std::vector<Detection>& out, int only_class) {
+    const bool feature_major = layout == HeadLayout::FEATURE_MAJOR;
+    switch (type) {
+        case YoloHeadType::DETECT_COCO:
+            if (only_class >= COCO_CLASSES) {
+                return;
+            }
+            if (only_class >= 0) {
+                if (feature_major) {
+                    DetectFeatureMajor::decodeClass(data, num_anchors, only_class, t, out);
+                } else {
+                    DetectAnchorMajor::decodeClass(data, num_anchors, only_class, t, out);
+                }
+            } else if (feature_major) {
+                DetectFeatureMajor::decode(data, num_anchors, t, out);
+            } else {
+                DetectAnchorMajor::decode(data, num_anchors, t, out);
+            }
+            return;
+        case YoloHeadType::POSE_COCO:
+            // Single class (person) - nothing to restrict
+            if (only_class > 0) {
+                return;
+            }
+            if (feature_major) {
+                PoseFeatureMajor::decode(data, num_anchors, t, out);
+            } else {
+                PoseAnchorMajor::decode(data, num_anchors, t, out);
+            }
+            return;
+        default:
+            if (only_class >= features - 4) {
+                return;
+            }
+            decodeGeneric(data, num_anchors, features, layout, t, out, only_class);
+            return;
+    }
+}
+
+} // namespace triage
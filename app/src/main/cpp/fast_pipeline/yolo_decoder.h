@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "simd_kernels.h"
+#include "yolo_detector.h"
+
+namespace triage {
+
+/**
+ * Memory order of a YOLO head output
+ */
+enum class HeadLayout {
+    FEATURE_MAJOR,   // [features x anchors] - ncnn export of YOLOv8/11 (out.h = features)
+    ANCHOR_MAJOR     // [anchors x features] - transposed exports
+};
+
+/**
+ * How the first four features encode the box (model input pixels)
+ */
+enum class BoxEncoding {
+    CXCYWH,          // Center + size (YOLOv8/11)
+    XYXY             // Corners
+};
+
+/**
+ * Maps model-input coordinates back into the image
+ */
+struct DecodeTransform {
+    float conf_threshold;
+    float scale_x;
+    float scale_y;
+    float offset_x;
+    float offset_y;
+};
+
+/**
+ * Decoder for one head layout, fixed at compile time.
+ *
+ * With the class and keypoint counts known to the compiler, the class
+ * max and keypoint loops have constant trip counts and unroll; for the
+ * feature-major layout the class scan runs row by row over a block of
+ * anchors (contiguous, vectorizable loads) instead of striding down a
+ * column per anchor, and the argmax is only resolved for anchors above
+ * the threshold.
+ *
+ * Scores are class probabilities (sigmoid already applied, no objectness),
+ * as in YOLOv8/11 exports. class_name is left for the caller to fill.
+ */
+template <HeadLayout Layout, int NumClasses, BoxEncoding Encoding, int NumKeypoints = 0>
+struct YoloHeadDecoder {
+    static constexpr int FEATURES = 4 + NumClasses + NumKeypoints * 3;
+    static constexpr int BLOCK = 256;    // Anchors per block (feature-major)
+
+    static void decode(const float* data, int num_anchors, const DecodeTransform& t,
+                       std::vector<Detection>& out) {
+        if (Layout == HeadLayout::FEATURE_MAJOR) {
+            decodeFeatureMajor(data, num_anchors, t, out);
+        } else {
+            decodeAnchorMajor(data, num_anchors, t, out);
+        }
+    }
+
+    /**
+     * Decode a single class: reads only that class's scores (one
+     * contiguous row when feature-major) and skips the argmax, so a box is
+     * kept when its score for the class passes even if another class
+     * scores higher
+     */
+    static void decodeClass(const float* data, int num_anchors, int class_id,
+                            const DecodeTransform& t, std::vector<Detection>& out) {
+        for (int a = 0; a < num_anchors; a++) {
+            float score = at(data, num_anchors, a, 4 + class_id);
+            if (score >= t.conf_threshold) {
+                emit(data, num_anchors, a, score, class_id, t, out);
+            }
+        }
+    }
+
+private:
+    static inline float at(const float* data, int num_anchors, int anchor, int feature) {
+        return Layout == HeadLayout::FEATURE_MAJOR ? data[feature * num_anchors + anchor]
+                                                   : data[anchor * FEATURES + feature];
+    }
+
+    static void decodeFeatureMajor(const float* data, int num_anchors, const DecodeTransform& t,
+                                   std::vector<Detection>& out) {
+        float best[BLOCK];
+        const auto max_rows = simdKernels().max_rows;
+
+        for (int a0 = 0; a0 < num_anchors; a0 += BLOCK) {
+            const int n = std::min(BLOCK, num_anchors - a0);
+
+            // Max score only - a plain running max over contiguous rows
+            // (CPU-dispatched kernel)
+            const float* row = data + 4 * num_anchors + a0;
+            for (int i = 0; i < n; i++) {
+                best[i] = row[i];
+            }
+            for (int c = 1; c < NumClasses; c++) {
+                max_rows(data + (4 + c) * num_anchors + a0, n, best);
+            }
+
+            // Class lookup only for the few anchors that pass
+            for (int i = 0; i < n; i++) {
+                if (best[i] < t.conf_threshold) continue;
+                const int a = a0 + i;
+                int best_class = 0;
+                for (int c = 0; c < NumClasses; c++) {
+                    if (data[(4 + c) * num_anchors + a] == best[i]) {
+                        best_class = c;
+                        break;
+                    }
+                }
+                emit(data, num_anchors, a, best[i], best_class, t, out);
+            }
+        }
+    }
+
+    static void decodeAnchorMajor(const float* data, int num_anchors, const DecodeTransform& t,
+                                  std::vector<Detection>& out) {
+        for (int a = 0; a < num_anchors; a++) {
+            const float* scores = data + a * FEATURES + 4;
+            float best = scores[0];
+            int best_class = 0;
+            for (int c = 1; c < NumClasses; c++) {
+                if (scores[c] > best) {
+                    best = scores[c];
+                    best_class = c;
+                }
+            }
+            if (best >= t.conf_threshold) {
+                emit(data, num_anchors, a, best, best_class, t, out);
+            }
+        }
+    }
+
+    static void emit(const float* data, int num_anchors, int anchor, float score, int class_id,
+                     const DecodeTransform& t, std::vector<Detection>& out) {
+        float b0 = at(data, num_anchors, anchor, 0);
+        float b1 = at(data, num_anchors, anchor, 1);
+        float b2 = at(data, num_anchors, anchor, 2);
+        float b3 = at(data, num_anchors, anchor, 3);
+
+        float x1, y1, x2, y2;
+        if (Encoding == BoxEncoding::CXCYWH) {
+            x1 = b0 - b2 / 2; y1 = b1 - b3 / 2;
+            x2 = b0 + b2 / 2; y2 = b1 + b3 / 2;
+        } else {
+            x1 = b0; y1 = b1; x2 = b2; y2 = b3;
+        }
+
+        Detection det;
+        det.x1 = t.offset_x + x1 * t.scale_x;
+        det.y1 = t.offset_y + y1 * t.scale_y;
+        det.x2 = t.offset_x + x2 * t.scale_x;
+        det.y2 = t.offset_y + y2 * t.scale_y;
+        det.confidence = score;
+        det.class_id = class_id;
+
+        if (NumKeypoints > 0) {
+            det.keypoints.resize(NumKeypoints);
+            for (int k = 0; k < NumKeypoints; k++) {
+                const int f = 4 + NumClasses + k * 3;
+                det.keypoints[k].x = t.offset_x + at(data, num_anchors, anchor, f) * t.scale_x;
+                det.keypoints[k].y = t.offset_y + at(data, num_anchors, anchor, f + 1) * t.scale_y;
+                det.keypoints[k].confidence = at(data, num_anchors, anchor, f + 2);
+            }
+        }
+
+        out.push_back(std::move(det));
+    }
+};
+
+/**
+ * Identify the head from the output blob shape (ncnn param files do not
+ * record output shapes, so this runs on a probe inference at load)
+ * @param out_w Output width (ncnn Mat w)
+ * @param out_h Output height (ncnn Mat h)
+ * @param layout Detected memory order
+ * @param features Features per anchor
+ * @return Head variant, UNKNOWN if no compiled decoder matches
+ */
+YoloHeadType identifyYoloHead(int out_w, int out_h, HeadLayout& layout, int& features);
+
+/**
+ * Decode a head output with the decoder compiled for its variant
+ * (falls back to a runtime-generic loop for UNKNOWN heads)
+ * @param only_class Decode just this class (-1 = all classes)
+ */
+void decodeYoloHead(YoloHeadType type, HeadLayout layout, int features,
+                    const float* data, int num_anchors, const DecodeTransform& t,
+                    std::vector<Detection>& out, int only_class = -1);
+
+} // namespace triage
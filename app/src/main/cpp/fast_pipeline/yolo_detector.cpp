@@ -1,7 +1,21 @@
 #include "yolo_detector.h"
+#include "yolo_decoder.h"
+#include "pixel_kernels.h"
+#include "thread_pool.h"
 #include <android/log.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 #define LOG_TAG "YoloDetector"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -9,12 +23,31 @@
 
 namespace triage {
 
-// COCO class names (subset relevant for patient monitoring)
+// COCO class names, indexed by YOLO class id
 static const char* COCO_CLASSES[] = {
-    "person", "bed", "chair", "couch", "tv", "laptop", "remote",
-    "cell phone", "book", "clock", "vase", "bottle", "cup"
+    "person", "bicycle", "car", "motorcycle", "airplane", "bus", "train", "truck", "boat",
+    "traffic light", "fire hydrant", "stop sign", "parking meter", "bench", "bird", "cat",
+    "dog", "horse", "sheep", "cow", "elephant", "bear", "zebra", "giraffe", "backpack",
+    "umbrella", "handbag", "tie", "suitcase", "frisbee", "skis", "snowboard", "sports ball",
+    "kite", "baseball bat", "baseball glove", "skateboard", "surfboard", "tennis racket",
+    "bottle", "wine glass", "cup", "fork", "knife", "spoon", "bowl", "banana", "apple",
+    "sandwich", "orange", "broccoli", "carrot", "hot dog", "pizza", "donut", "cake", "chair",
+    "couch", "potted plant", "bed", "dining table", "toilet", "tv", "laptop", "mouse",
+    "remote", "keyboard", "cell phone", "microwave", "oven", "toaster", "sink",
+    "refrigerator", "book", "clock", "vase", "scissors", "teddy bear", "hair drier",
+    "toothbrush"
 };
 static const int NUM_COCO_CLASSES = 80;
+static_assert(sizeof(COCO_CLASSES) / sizeof(COCO_CLASSES[0]) == NUM_COCO_CLASSES,
+              "COCO class table out of sync");
+
+// Fraction of a box inside a stronger one for it to count as a fragment
+static const float CONTAINED_THRESHOLD = 0.8f;
+
+// Presence stage input (YOLO11n at 160 costs ~1/16 of 640)
+static const int PRESENCE_INPUT_SIZE = 160;
+
+static const int PERSON_CLASS = 0;
 
 YoloDetector::YoloDetector() {
     class_names_.assign(COCO_CLASSES, COCO_CLASSES + sizeof(COCO_CLASSES)/sizeof(COCO_CLASSES[0]));
@@ -24,43 +57,129 @@ YoloDetector::~YoloDetector() {
     cleanup();
 }
 
-bool YoloDetector::init(const std::string& model_path, bool use_gpu) {
+YoloModel::~YoloModel() {
 #ifdef HAVE_NCNN
-    LOGI("Initializing YOLO detector from: %s", model_path.c_str());
+    net.clear();
+#endif
+}
 
-    // Configure options
-    opt_.lightmode = true;
-    opt_.num_threads = 4;
+#ifdef HAVE_NCNN
+static bool fileExists(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    fclose(f);
+    return true;
+}
+#endif
+
+std::shared_ptr<YoloModel> YoloModel::load(const std::string& model_path, bool use_gpu,
+                                           bool use_int8) {
+#ifdef HAVE_NCNN
+    LOGI("Loading YOLO model from: %s", model_path.c_str());
+
+    auto model = std::make_shared<YoloModel>();
+    model->model_path = model_path;
+
+    // Load model (actual asset paths)
+    std::string param_path = model_path + "/yolo11n_ncnn_model/model.ncnn.param";
+    std::string bin_path = model_path + "/yolo11n_ncnn_model/model.ncnn.bin";
 
-    if (use_gpu) {
+    if (use_int8) {
+        // Quantized with the same input normalization, so pre/post-processing is unchanged
+        std::string int8_param = model_path + "/yolo11n_ncnn_model/model.ncnn.int8.param";
+        std::string int8_bin = model_path + "/yolo11n_ncnn_model/model.ncnn.int8.bin";
+        if (fileExists(int8_param) && fileExists(int8_bin)) {
+            param_path = int8_param;
+            bin_path = int8_bin;
+            model->int8 = true;
+        } else {
+            LOGE("INT8 model not found at %s - using float model", int8_param.c_str());
+        }
+    }
+
+    // Configure options
+    model->opt.lightmode = true;
+    model->opt.num_threads = 4;
+    // OpenMP workers sleep as soon as a layer ends instead of spinning
+    // for 20ms, so the shared thread pool gets the cores back
+    model->opt.openmp_blocktime = 0;
+    model->opt.use_int8_inference = model->int8;
+
+    if (use_gpu && !model->int8) {
 #ifdef HAVE_VULKAN
-        opt_.use_vulkan_compute = ncnn::get_gpu_count() > 0;
-        if (opt_.use_vulkan_compute) {
+        model->opt.use_vulkan_compute = ncnn::get_gpu_count() > 0;
+        if (model->opt.use_vulkan_compute) {
             LOGI("Vulkan GPU acceleration enabled");
         }
 #endif
     }
+    model->use_gpu = model->opt.use_vulkan_compute;
 
-    net_.opt = opt_;
+    model->net.opt = model->opt;
 
-    // Load model (actual asset paths)
-    std::string param_path = model_path + "/yolo11n_ncnn_model/model.ncnn.param";
-    std::string bin_path = model_path + "/yolo11n_ncnn_model/model.ncnn.bin";
-
-    int ret = net_.load_param(param_path.c_str());
-    if (ret != 0) {
+    int ret = model->net.load_param(param_path.c_str());
+    if (ret == 0) {
+        ret = model->net.load_model(bin_path.c_str());
+        if (ret != 0) {
+            LOGE("Failed to load model file: %s", bin_path.c_str());
+        }
+    } else {
         LOGE("Failed to load param file: %s", param_path.c_str());
-        return false;
     }
-
-    ret = net_.load_model(bin_path.c_str());
     if (ret != 0) {
-        LOGE("Failed to load model file: %s", bin_path.c_str());
+        if (model->int8) {
+            // A truncated or mismatched INT8 export must not cost detection
+            LOGE("INT8 model failed to load - retrying with the float model");
+            return load(model_path, use_gpu, false);
+        }
+        return nullptr;
+    }
+
+    // The param file does not record output shapes; a small probe
+    // inference tells which compiled decoder fits the head
+    {
+        ncnn::Mat probe_in(320, 320, 3);
+        probe_in.fill(0.5f);
+        ncnn::Extractor ex = model->net.create_extractor();
+        ex.input("in0", probe_in);
+        ncnn::Mat probe_out;
+        if (ex.extract("out0", probe_out) == 0 && probe_out.dims == 2) {
+            HeadLayout layout;
+            model->head_type = identifyYoloHead(probe_out.w, probe_out.h, layout, model->head_features);
+            model->head_anchor_major = layout == HeadLayout::ANCHOR_MAJOR;
+        } else {
+            LOGE("Could not probe YOLO output shape - using generic decoder");
+        }
+    }
+
+    LOGI("YOLO model loaded (%s, %s, head %d: %d features, %s)", model->int8 ? "int8" : "float",
+         model->use_gpu ? "gpu" : "cpu", static_cast<int>(model->head_type), model->head_features,
+         model->head_anchor_major ? "anchor-major" : "feature-major");
+    return model;
+#else
+    LOGE("NCNN not available - model not loaded");
+    return nullptr;
+#endif
+}
+
+bool YoloDetector::init(const std::string& model_path, bool use_gpu, bool use_int8) {
+    LOGI("Initializing YOLO detector from: %s", model_path.c_str());
+    return init(YoloModel::load(model_path, use_gpu, use_int8));
+}
+
+bool YoloDetector::init(std::shared_ptr<YoloModel> model) {
+#ifdef HAVE_NCNN
+    if (!model) {
+        LOGE("No model to initialize detector with");
         return false;
     }
 
+    model_ = std::move(model);
+    governor_.init();
+    static_cache_.init();
+    low_light_.init();
     initialized_ = true;
-    LOGI("YOLO detector initialized successfully");
+    LOGI("YOLO detector initialized successfully (model refs=%ld)", model_.use_count());
     return true;
 #else
     LOGE("NCNN not available - detector disabled");
@@ -68,8 +187,10 @@ bool YoloDetector::init(const std::string& model_path, bool use_gpu) {
 #endif
 }
 
-std::vector<Detection> YoloDetector::detect(const uint8_t* pixels, int width, int height) {
+std::vector<Detection> YoloDetector::detect(const ImageView& image) {
     std::vector<Detection> detections;
+    const int width = image.width;
+    const int height = image.height;
 
 #ifdef HAVE_NCNN
     if (!initialized_) {
@@ -77,83 +198,82 @@ std::vector<Detection> YoloDetector::detect(const uint8_t* pixels, int width, in
         return detections;
     }
 
-    // Create input from pixels
-    ncnn::Mat in = ncnn::Mat::from_pixels_resize(
-        pixels, ncnn::Mat::PIXEL_RGBA2RGB,
-        width, height,
-        input_width_, input_height_
-    );
-
-    // Normalize (YOLO expects 0-1)
-    const float mean_vals[3] = {0.f, 0.f, 0.f};
-    const float norm_vals[3] = {1/255.f, 1/255.f, 1/255.f};
-    in.substract_mean_normalize(mean_vals, norm_vals);
-
-    // Run inference
-    ncnn::Extractor ex = net_.create_extractor();
-    ex.input("in0", in);
-
-    ncnn::Mat out;
-    ex.extract("out0", out);
-
-    // Parse YOLO11 output
-    // YOLO11 output shape: [8400, 84] where 84 = 4 (bbox) + 80 (class probs)
-    // bbox format: x_center, y_center, w, h (in pixels, need to scale to input size)
-    // class probs: already sigmoid applied, no separate objectness score
-    person_detected_ = false;
-    fall_detected_ = false;
+    // Night frames get a tone curve, applied while normalizing the input
+    const uint8_t* input_lut = nullptr;
+    if (low_light_enabled_) {
+        low_light_.update(image);
+        if (low_light_.isActive()) {
+            input_lut = low_light_.getLut().data();
+        }
+    }
 
-    LOGI("YOLO output: w=%d h=%d c=%d", out.w, out.h, out.c);
-
-    // YOLO11 NCNN output is [84, 8400] where:
-    // - 84 rows = 4 (bbox: cx, cy, w, h) + 80 (class probs)
-    // - 8400 columns = number of detections
-    // So out.h = 84 (features), out.w = 8400 (detections)
-    const int num_classes = 80;
-    const int num_dets = out.w;  // 8400 detections
-    const int feat_dim = out.h;  // 84 features per detection
-
-    for (int i = 0; i < num_dets; i++) {
-        // Access column i - each detection is a column, not a row
-        // row(j) gives feature j, and we want element i from that row
-        float cx = out.row(0)[i];
-        float cy = out.row(1)[i];
-        float bw = out.row(2)[i];
-        float bh = out.row(3)[i];
-
-        // Find best class (rows 4-83 are class probs)
-        int best_class = 0;
-        float best_score = 0;
-        for (int j = 4; j < feat_dim && j < 4 + num_classes; j++) {
-            float score = out.row(j)[i];
-            if (score > best_score) {
-                best_score = score;
-                best_class = j - 4;
+    // Presence stage on the fixed ROI
+    float stage_score = 0.0f;
+    PresenceBox stage_box = {};
+    if (cascade_enabled_) {
+        float roi_x1, roi_y1, roi_x2, roi_y2;
+        cascade_.getRoi(roi_x1, roi_y1, roi_x2, roi_y2);
+        const int rx = static_cast<int>(roi_x1 * width);
+        const int ry = static_cast<int>(roi_y1 * height);
+        const int rw = std::max(1, static_cast<int>(roi_x2 * width) - rx);
+        const int rh = std::max(1, static_cast<int>(roi_y2 * height) - ry);
+
+        std::vector<Detection> stage;
+        auto stage_start = std::chrono::steady_clock::now();
+        runInference(image, rx, ry, rw, rh, PRESENCE_INPUT_SIZE, num_threads_, stage,
+                     PERSON_CLASS, input_lut);
+        float stage_ms = std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - stage_start).count();
+
+        for (const auto& det : stage) {
+            if (det.class_id == 0 && det.confidence > stage_score) {
+                stage_score = det.confidence;
+                stage_box = {(det.x1 - rx) / rw, (det.y1 - ry) / rh,
+                             (det.x2 - rx) / rw, (det.y2 - ry) / rh};
             }
         }
 
-        // In YOLO11, class probability IS the confidence
-        float confidence = best_score;
-        if (confidence < conf_threshold_) continue;
-
-        // Convert to box coordinates (scale from 640x640 to actual image size)
-        Detection det;
-        det.x1 = (cx - bw/2) * width / input_width_;
-        det.y1 = (cy - bh/2) * height / input_height_;
-        det.x2 = (cx + bw/2) * width / input_width_;
-        det.y2 = (cy + bh/2) * height / input_height_;
-        det.confidence = confidence;
-        det.class_id = best_class;
-        det.class_name = (best_class < class_names_.size()) ? class_names_[best_class] : "unknown";
-
-        detections.push_back(det);
+        if (!cascade_.needsFullRun(stage_score, stage_box, stage_ms)) {
+            // Same scene as the last full run - person / pose / fall state stands
+            full_run_skipped_ = true;
+            return last_full_detections_;
+        }
+    }
+    full_run_skipped_ = false;
+
+    const int input_size = adaptive_resolution_ ? governor_.getInputSize() : input_width_;
+
+    auto start = std::chrono::steady_clock::now();
+    const int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        start.time_since_epoch()).count();
+    const bool all_classes = !static_cache_enabled_ || static_cache_.isRefreshDue(now_ms);
+    runInference(image, 0, 0, width, height, input_size, num_threads_, detections,
+                 all_classes ? -1 : PERSON_CLASS, input_lut);
+    float latency_ms = std::chrono::duration<float, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    last_input_size_ = input_size;
+
+    if (static_cache_enabled_ && all_classes) {
+        static_cache_.update(detections, width, height, now_ms);
+    }
 
+    person_detected_ = false;
+    fall_detected_ = false;
+    float person_fraction = 0.0f;
+    for (const auto& det : detections) {
         // Track person detection
-        if (best_class == 0) { // person class
+        if (det.class_id == 0) { // person class
             person_detected_ = true;
+            person_fraction = std::max({person_fraction,
+                                        (det.x2 - det.x1) / width,
+                                        (det.y2 - det.y1) / height});
         }
     }
 
+    if (adaptive_resolution_) {
+        governor_.update(input_size, latency_ms, std::min(person_fraction, 1.0f));
+    }
+
     // NMS
     // (simplified - production should use proper NMS)
 
@@ -163,10 +283,401 @@ std::vector<Detection> YoloDetector::detect(const uint8_t* pixels, int width, in
     // Check for fall
     fall_detected_ = checkForFall(detections);
 
+    if (cascade_enabled_) {
+        cascade_.recordFullRun(person_detected_, stage_score, stage_box, latency_ms);
+        last_full_detections_ = detections;
+    }
+
 #endif
     return detections;
 }
 
+void YoloDetector::setStaticObjectCache(bool enabled) {
+    static_cache_enabled_ = enabled;
+    static_cache_.clear();
+    LOGI("Static object cache %s", enabled ? "enabled" : "disabled");
+}
+
+void YoloDetector::setLowLightEnhancement(bool enabled) {
+    low_light_enabled_ = enabled;
+    low_light_.reset();
+    LOGI("Low-light enhancement %s", enabled ? "enabled" : "disabled");
+}
+
+void YoloDetector::setPresenceCascade(bool enabled, int refresh_frames) {
+    if (enabled && !cascade_enabled_) {
+        float x1, y1, x2, y2;
+        cascade_.getRoi(x1, y1, x2, y2);
+        cascade_.init(refresh_frames);
+        cascade_.setRoi(x1, y1, x2, y2);
+    }
+    cascade_enabled_ = enabled;
+    full_run_skipped_ = false;
+    last_full_detections_.clear();
+    LOGI("Presence cascade %s", enabled ? "enabled" : "disabled");
+}
+
+std::vector<Detection> YoloDetector::detectTiled(const ImageView& image, float overlap,
+                                                 bool include_full_frame) {
+    std::vector<Detection> merged;
+    tiled_stats_ = {};
+    const int width = image.width;
+    const int height = image.height;
+
+#ifdef HAVE_NCNN
+    if (!initialized_) {
+        LOGE("Detector not initialized");
+        return merged;
+    }
+
+    // Tiles are one model input each, so objects keep native resolution
+    overlap = std::max(0.0f, std::min(overlap, 0.5f));
+    const int tile_w = std::min(input_width_, width);
+    const int tile_h = std::min(input_height_, height);
+    const int step_x = std::max(1, static_cast<int>(tile_w * (1.0f - overlap)));
+    const int step_y = std::max(1, static_cast<int>(tile_h * (1.0f - overlap)));
+
+    // Tile origins along one axis; the last tile is flush with the edge
+    auto origins = [](int extent, int tile, int step) {
+        std::vector<int> out;
+        for (int pos = 0; ; pos += step) {
+            if (pos + tile >= extent) {
+                out.push_back(extent - tile);
+                break;
+            }
+            out.push_back(pos);
+        }
+        return out;
+    };
+
+    struct Region { int x, y, w, h; };
+    std::vector<Region> regions;
+    for (int y : origins(height, tile_h, step_y)) {
+        for (int x : origins(width, tile_w, step_x)) {
+            regions.push_back({x, y, tile_w, tile_h});
+        }
+    }
+    if (include_full_frame && regions.size() > 1) {
+        // Objects larger than a tile are only whole in the downscaled frame
+        regions.push_back({0, 0, width, height});
+    }
+
+    const int tiles = static_cast<int>(regions.size());
+    const int budget = getThreadBudget();
+    const int concurrent = std::min(tiles, budget);
+    const int threads_per_tile = std::max(1, budget / concurrent);
+    ThreadPool::ExternalThreads omp_threads(concurrent * threads_per_tile);
+
+    std::vector<std::vector<Detection>> per_tile(tiles);
+    std::vector<double> tile_ms(tiles, 0.0);
+
+    auto start = std::chrono::steady_clock::now();
+
+#ifdef _OPENMP
+    // Let each tile's extractor fan out inside the outer parallel loop;
+    // the nesting limit is process-wide, so it is put back afterwards
+    const int saved_active_levels = omp_get_max_active_levels();
+    if (threads_per_tile > 1) {
+        omp_set_max_active_levels(std::max(saved_active_levels, 2));
+    }
+    #pragma omp parallel for num_threads(concurrent) schedule(dynamic, 1)
+#endif
+    for (int i = 0; i < tiles; i++) {
+        auto tile_start = std::chrono::steady_clock::now();
+        const Region& r = regions[i];
+        runInference(image, r.x, r.y, r.w, r.h, input_width_, threads_per_tile, per_tile[i]);
+        tile_ms[i] = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - tile_start).count();
+    }
+#ifdef _OPENMP
+    omp_set_max_active_levels(saved_active_levels);
+#endif
+
+    double total_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    double tile_sum_ms = 0.0;
+    for (int i = 0; i < tiles; i++) {
+        merged.insert(merged.end(), per_tile[i].begin(), per_tile[i].end());
+        tile_sum_ms += tile_ms[i];
+    }
+    const int raw = static_cast<int>(merged.size());
+
+    // Global NMS also drops fragments cut off at tile borders
+    applyNms(merged, nms_threshold_, true);
+
+    tiled_stats_.tiles = tiles;
+    tiled_stats_.concurrent_tiles = concurrent;
+    tiled_stats_.threads_per_tile = threads_per_tile;
+    tiled_stats_.total_ms = static_cast<float>(total_ms);
+    tiled_stats_.mean_tile_ms = static_cast<float>(tile_sum_ms / tiles);
+    tiled_stats_.tiles_per_second = total_ms > 0.0 ? static_cast<float>(tiles * 1000.0 / total_ms) : 0.0f;
+    tiled_stats_.raw_detections = raw;
+    tiled_stats_.merged_detections = static_cast<int>(merged.size());
+
+    LOGI("Tiled detection %dx%d: %d tiles (%d concurrent x %d threads) in %.1fms, "
+         "%.1f ms/tile, %.1f tiles/s, %d -> %d boxes",
+         width, height, tiles, concurrent, threads_per_tile, total_ms,
+         tiled_stats_.mean_tile_ms, tiled_stats_.tiles_per_second, raw, tiled_stats_.merged_detections);
+#endif
+    return merged;
+}
+
+void YoloDetector::runInference(const ImageView& image, int rx, int ry, int rw, int rh,
+                                int input_size, int num_threads, std::vector<Detection>& out,
+                                int only_class, const uint8_t* input_lut) const {
+#ifdef HAVE_NCNN
+    // Create input from the region of interest (a sub-view, read in place).
+    // Byte-per-channel formats go to ncnn's resize as they are; packed
+    // 16-bit and YUV frames are decoded while resizing to the input size.
+    const ImageView roi = image.crop(rx, ry, rw, rh);
+    ncnn::Mat in;
+    switch (roi.format) {
+        case PixelFormat::RGBA_8888:
+        case PixelFormat::BGRA_8888:
+        case PixelFormat::RGB_888: {
+            const int pixel_type = roi.format == PixelFormat::RGB_888 ? ncnn::Mat::PIXEL_RGB
+                                 : roi.format == PixelFormat::BGRA_8888 ? ncnn::Mat::PIXEL_BGRA2RGB
+                                 : ncnn::Mat::PIXEL_RGBA2RGB;
+            in = ncnn::Mat::from_pixels_resize(
+                roi.data, pixel_type,
+                roi.width, roi.height, roi.stride,
+                input_size, input_size
+            );
+            break;
+        }
+        default: {
+            std::vector<uint8_t> rgb(static_cast<size_t>(input_size) * input_size * 3);
+            if (!resizeToRgb(roi, input_size, input_size, rgb.data())) {
+                return;
+            }
+            in = ncnn::Mat::from_pixels(rgb.data(), ncnn::Mat::PIXEL_RGB, input_size, input_size);
+            break;
+        }
+    }
+
+    // Normalize (YOLO expects 0-1)
+    if (input_lut) {
+        applyInputLut(in, input_lut);
+    } else {
+        const float mean_vals[3] = {0.f, 0.f, 0.f};
+        const float norm_vals[3] = {1/255.f, 1/255.f, 1/255.f};
+        in.substract_mean_normalize(mean_vals, norm_vals);
+    }
+
+    // Run inference
+    ncnn::Extractor ex = model_->net.create_extractor();
+    if (num_threads > 0) {
+        ex.set_num_threads(num_threads);
+    }
+    ex.input("in0", in);
+
+    ncnn::Mat output;
+    {
+#ifdef _OPENMP
+        // An enclosing tiled or batched region has lent these cores already
+        const int omp_team = omp_in_parallel() ? 0 : (num_threads > 0 ? num_threads : model_->opt.num_threads);
+#else
+        const int omp_team = 0;
+#endif
+        ThreadPool::ExternalThreads omp_threads(omp_team);
+        ex.extract("out0", output);
+    }
+
+    // Decoded by the variant identified at load (YOLO11 detect: [84, 8400],
+    // rows = 4 bbox (cx, cy, w, h) + 80 sigmoid class probs, no objectness)
+    const bool anchor_major = model_->head_anchor_major;
+    const int features = model_->head_features > 0 ? model_->head_features
+                                                   : (anchor_major ? output.w : output.h);
+    const int num_anchors = anchor_major ? output.h : output.w;
+
+    DecodeTransform t;
+    t.conf_threshold = conf_threshold_;
+    t.scale_x = static_cast<float>(rw) / input_size;
+    t.scale_y = static_cast<float>(rh) / input_size;
+    t.offset_x = static_cast<float>(rx);
+    t.offset_y = static_cast<float>(ry);
+
+    const size_t first = out.size();
+    decodeYoloHead(model_->head_type,
+                   anchor_major ? HeadLayout::ANCHOR_MAJOR : HeadLayout::FEATURE_MAJOR,
+                   features, static_cast<const float*>(output.data), num_anchors, t, out,
+                   only_class);
+
+    for (size_t i = first; i < out.size(); i++) {
+        int cls = out[i].class_id;
+        out[i].class_name = (cls < static_cast<int>(class_names_.size())) ? class_names_[cls] : "unknown";
+    }
+#endif
+}
+
+#ifdef HAVE_NCNN
+static inline float lutSample(float value, const uint8_t* lut, float scale) {
+    int level = std::max(0, std::min(static_cast<int>(value), 255));
+    return lut[level] * scale;
+}
+
+#if defined(__aarch64__)
+/**
+ * NEON lookup of whole 16-sample blocks: the 256-entry table as four
+ * 64-byte TBL tables. Saturating narrows clamp out-of-range values as
+ * lutSample does.
+ * @return Samples done; the rest is left to the scalar loop
+ */
+static int applyLutNeon(float* ptr, int n, const uint8_t* lut, float scale) {
+    uint8x16x4_t t0, t1, t2, t3;
+    for (int k = 0; k < 4; k++) {
+        t0.val[k] = vld1q_u8(lut + k * 16);
+        t1.val[k] = vld1q_u8(lut + 64 + k * 16);
+        t2.val[k] = vld1q_u8(lut + 128 + k * 16);
+        t3.val[k] = vld1q_u8(lut + 192 + k * 16);
+    }
+    const uint8x16_t base64 = vdupq_n_u8(64);
+    const uint8x16_t base128 = vdupq_n_u8(128);
+    const uint8x16_t base192 = vdupq_n_u8(192);
+
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint16x8_t lo = vcombine_u16(vqmovn_u32(vcvtq_u32_f32(vld1q_f32(ptr + i))),
+                                     vqmovn_u32(vcvtq_u32_f32(vld1q_f32(ptr + i + 4))));
+        uint16x8_t hi = vcombine_u16(vqmovn_u32(vcvtq_u32_f32(vld1q_f32(ptr + i + 8))),
+                                     vqmovn_u32(vcvtq_u32_f32(vld1q_f32(ptr + i + 12))));
+        uint8x16_t idx = vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi));
+
+        // TBX leaves lanes whose (rebased) index is out of range untouched
+        uint8x16_t v = vqtbl4q_u8(t0, idx);
+        v = vqtbx4q_u8(v, t1, vsubq_u8(idx, base64));
+        v = vqtbx4q_u8(v, t2, vsubq_u8(idx, base128));
+        v = vqtbx4q_u8(v, t3, vsubq_u8(idx, base192));
+
+        uint16x8_t w_lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t w_hi = vmovl_u8(vget_high_u8(v));
+        vst1q_f32(ptr + i, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(w_lo))), scale));
+        vst1q_f32(ptr + i + 4, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(w_lo))), scale));
+        vst1q_f32(ptr + i + 8, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(w_hi))), scale));
+        vst1q_f32(ptr + i + 12, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(w_hi))), scale));
+    }
+    return i;
+}
+
+/**
+ * The NEON lookup against lutSample on every level and half level and
+ * on values past both ends of the range (run once)
+ */
+static bool lutNeonMatchesScalar() {
+    uint8_t lut[256];
+    for (int k = 0; k < 256; k++) {
+        lut[k] = static_cast<uint8_t>(k * 167 + 41);
+    }
+    const float scale = 1.0f / 255.0f;
+    float fast[640], ref[640];
+    for (int k = 0; k < 640; k++) {
+        fast[k] = (k - 64) * 0.5f;    // -32 to 287.5
+    }
+    fast[0] = 65546.0f;               // Wraps to 10 in a plain 16-bit narrow
+    for (int k = 0; k < 640; k++) {
+        ref[k] = lutSample(fast[k], lut, scale);
+    }
+    if (applyLutNeon(fast, 640, lut, scale) != 640 || std::memcmp(fast, ref, sizeof(ref)) != 0) {
+        LOGE("NEON input LUT differs from the scalar path - not used");
+        return false;
+    }
+    return true;
+}
+#endif
+
+void YoloDetector::applyInputLut(ncnn::Mat& in, const uint8_t* lut) {
+    // The resize works on 8-bit pixels, so every value is a whole 0-255
+    // level: look it up and scale to 0-1 in the same pass
+    const float scale = 1.0f / 255.0f;
+    const int n = in.w * in.h;
+#if defined(__aarch64__)
+    static const bool use_neon = lutNeonMatchesScalar();
+#endif
+
+    for (int c = 0; c < in.c; c++) {
+        float* ptr = in.channel(c);
+        int i = 0;
+#if defined(__aarch64__)
+        if (use_neon) {
+            i = applyLutNeon(ptr, n, lut, scale);
+        }
+#endif
+
+        // Scalar tail (and the whole input on non-NEON builds)
+        for (; i < n; i++) {
+            ptr[i] = lutSample(ptr[i], lut, scale);
+        }
+    }
+}
+#endif
+
+void YoloDetector::applyNms(std::vector<Detection>& detections, float iou_threshold,
+                            bool suppress_contained) {
+    std::sort(detections.begin(), detections.end(),
+              [](const Detection& a, const Detection& b) { return a.confidence > b.confidence; });
+
+    std::vector<Detection> kept;
+    kept.reserve(detections.size());
+    for (const auto& det : detections) {
+        float area = std::max(0.0f, det.x2 - det.x1) * std::max(0.0f, det.y2 - det.y1);
+        bool suppressed = false;
+        for (const auto& k : kept) {
+            if (k.class_id != det.class_id) continue;
+
+            float iw = std::min(det.x2, k.x2) - std::max(det.x1, k.x1);
+            float ih = std::min(det.y2, k.y2) - std::max(det.y1, k.y1);
+            if (iw <= 0.0f || ih <= 0.0f) continue;
+
+            float inter = iw * ih;
+            float k_area = (k.x2 - k.x1) * (k.y2 - k.y1);
+            float iou = inter / std::max(area + k_area - inter, 1e-6f);
+            // A tile-border fragment lies almost entirely inside the whole box
+            float contained = inter / std::max(area, 1e-6f);
+            if (iou > iou_threshold || (suppress_contained && contained > CONTAINED_THRESHOLD)) {
+                suppressed = true;
+                break;
+            }
+        }
+        if (!suppressed) {
+            kept.push_back(det);
+        }
+    }
+    detections.swap(kept);
+}
+
+void YoloDetector::warmup() {
+#ifdef HAVE_NCNN
+    if (!initialized_) {
+        return;
+    }
+
+    // Mid-gray frame at the largest size
+    const int size = ResolutionGovernor::SIZES[ResolutionGovernor::NUM_SIZES - 1];
+    std::vector<uint8_t> gray(static_cast<size_t>(size) * size * 4, 128);
+    const ImageView frame = ImageView::packed(gray.data(), size, size);
+    std::vector<Detection> discard;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ResolutionGovernor::NUM_SIZES; i++) {
+        runInference(frame, 0, 0, size, size, ResolutionGovernor::SIZES[i], num_threads_, discard);
+        discard.clear();
+    }
+    runInference(frame, 0, 0, size, size, PRESENCE_INPUT_SIZE, num_threads_, discard);
+    LOGI("Warmed up %d input sizes in %.1fms", ResolutionGovernor::NUM_SIZES + 1,
+         std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+#endif
+}
+
+int YoloDetector::getThreadBudget() const {
+#ifdef HAVE_NCNN
+    if (model_ && model_->opt.num_threads > 0) {
+        return model_->opt.num_threads;
+    }
+#endif
+    return 4;
+}
+
 void YoloDetector::estimatePose(const std::vector<Detection>& detections) {
     estimated_pose_ = Pose::UNKNOWN;
 
@@ -217,7 +728,8 @@ bool YoloDetector::checkForFall(const std::vector<Detection>& detections) {
 void YoloDetector::cleanup() {
 #ifdef HAVE_NCNN
     if (initialized_) {
-        net_.clear();
+        // Weights are released when the last detector sharing them lets go
+        model_.reset();
         initialized_ = false;
         LOGI("YOLO detector cleaned up");
     }
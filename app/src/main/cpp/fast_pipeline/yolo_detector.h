@@ -2,6 +2,13 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+
+#include "image_view.h"
+#include "low_light_enhancer.h"
+#include "presence_cascade.h"
+#include "resolution_governor.h"
+#include "static_object_cache.h"
 
 #ifdef HAVE_NCNN
 #include <ncnn/net.h>
@@ -9,16 +16,40 @@
 
 namespace triage {
 
+struct PoseKeypoint {
+    float x, y;
+    float confidence;
+};
+
 struct Detection {
     float x1, y1, x2, y2;  // Bounding box
     float confidence;
     int class_id;
     std::string class_name;
+    std::vector<PoseKeypoint> keypoints;  // Pose models only (17 COCO keypoints)
 };
 
-struct PoseKeypoint {
-    float x, y;
-    float confidence;
+/**
+ * YOLO head variants with compile-time specialized decoders
+ */
+enum class YoloHeadType {
+    UNKNOWN = 0,     // Runtime-generic decoder
+    DETECT_COCO,     // YOLOv8/11 detect, 80 classes
+    POSE_COCO        // YOLOv8/11 pose, 1 class + 17 keypoints
+};
+
+/**
+ * Timing of the last tiled detection (per-tile throughput benchmark)
+ */
+struct TiledStats {
+    int tiles;                   // Tiles run (including the full-frame pass)
+    int concurrent_tiles;        // Tiles in flight at once
+    int threads_per_tile;        // Extractor threads per tile
+    float total_ms;              // Wall time of the whole call
+    float mean_tile_ms;          // Mean per-tile preprocessing + inference
+    float tiles_per_second;      // Aggregate throughput across workers
+    int raw_detections;          // Before global NMS
+    int merged_detections;       // After global NMS
 };
 
 enum class Pose {
@@ -29,6 +60,41 @@ enum class Pose {
     FALLEN = 4
 };
 
+/**
+ * Loaded YOLO weights.
+ *
+ * One instance per model file; any number of YoloDetectors can share it.
+ * ncnn::Net is safe for concurrent extractors, so sharing costs nothing
+ * beyond the per-detector state.
+ */
+struct YoloModel {
+    std::string model_path;
+    bool use_gpu = false;
+    bool int8 = false;           // Quantized weights (ncnn2int8 output) loaded
+
+    // Output head, identified at load
+    YoloHeadType head_type = YoloHeadType::UNKNOWN;
+    bool head_anchor_major = false;  // [anchors x features] instead of [features x anchors]
+    int head_features = 0;           // Features per anchor (4 box + classes [+ keypoints])
+
+#ifdef HAVE_NCNN
+    ncnn::Net net;
+    ncnn::Option opt;
+#endif
+
+    ~YoloModel();
+
+    /**
+     * Load .param/.bin from a model directory
+     * @param use_int8 Prefer model.ncnn.int8.param/.bin (from
+     *        scripts/calibrate_yolo_int8.py); falls back to the float model
+     *        if they are missing. INT8 runs on the CPU.
+     * @return nullptr on failure
+     */
+    static std::shared_ptr<YoloModel> load(const std::string& model_path, bool use_gpu = true,
+                                           bool use_int8 = false);
+};
+
 class YoloDetector {
 public:
     YoloDetector();
@@ -38,18 +104,138 @@ public:
      * Initialize the detector with model files
      * @param model_path Path to directory containing .param and .bin files
      * @param use_gpu Whether to use Vulkan GPU acceleration
+     * @param use_int8 Prefer the INT8-quantized model if present
+     * @return true on success
+     */
+    bool init(const std::string& model_path, bool use_gpu = true, bool use_int8 = false);
+
+    /**
+     * Initialize against already-loaded weights (no extra ncnn::Net)
+     * @param model Shared model from YoloModel::load
      * @return true on success
      */
-    bool init(const std::string& model_path, bool use_gpu = true);
+    bool init(std::shared_ptr<YoloModel> model);
 
     /**
      * Run detection on an image
-     * @param pixels RGBA pixel data
-     * @param width Image width
-     * @param height Image height
-     * @return Vector of detections
+     * @param image View in any PixelFormat (any row stride, may be a crop)
+     * @return Vector of detections in view coordinates
+     */
+    std::vector<Detection> detect(const ImageView& image);
+
+    /**
+     * Detect small objects in a high-resolution still.
+     *
+     * Splits the image into overlapping tiles at native resolution (one
+     * model input each), runs them in parallel and merges the boxes with
+     * class-aware global NMS. An optional downscaled full-frame pass keeps
+     * objects larger than a tile. Does not update the per-frame person /
+     * pose / fall state - intended for on-demand equipment charting.
+     * @param image View in any PixelFormat (any row stride)
+     * @param overlap Fraction of a tile shared with its neighbour (0-0.5)
+     * @param include_full_frame Also run the whole image downscaled
+     * @return Merged detections in full-image pixel coordinates
+     */
+    std::vector<Detection> detectTiled(const ImageView& image, float overlap = 0.2f,
+                                       bool include_full_frame = true);
+
+    /**
+     * Timing of the last detectTiled call
+     */
+    const TiledStats& getLastTiledStats() const { return tiled_stats_; }
+
+    /**
+     * Class-aware non-maximum suppression, highest confidence first
+     * @param detections Detections to filter in place
+     * @param iou_threshold Overlap above which the weaker box is dropped
+     * @param suppress_contained Also drop boxes mostly inside a stronger one
+     *        (fragments of an object cut by a tile border)
+     */
+    static void applyNms(std::vector<Detection>& detections, float iou_threshold,
+                         bool suppress_contained = false);
+
+    /**
+     * Threads for this detector's extractor (0 = model default).
+     * Lower it when several detectors run concurrently on one model.
+     */
+    void setNumThreads(int num_threads) { num_threads_ = num_threads; }
+
+    /**
+     * Let the resolution governor pick the input size per frame
+     * (off = always the full 640 input)
+     */
+    void setAdaptiveResolution(bool enabled) { adaptive_resolution_ = enabled; }
+
+    /**
+     * Thermal state from the app (caps the input size)
+     */
+    void setThermalState(ThermalState state) { governor_.setThermalState(state); }
+
+    /**
+     * Largest input size the governor may pick (pipeline governor level)
      */
-    std::vector<Detection> detect(const uint8_t* pixels, int width, int height);
+    void setMaxInputSize(int max_size) { governor_.setSizeLimit(max_size); }
+
+    /**
+     * Inference time the governor aims for per frame
+     */
+    void setLatencyBudget(float budget_ms) { governor_.setBudget(budget_ms); }
+
+    /**
+     * Input size used by the last detect call
+     */
+    int getInputSize() const { return last_input_size_; }
+
+    const ResolutionGovernor& getGovernor() const { return governor_; }
+
+    /**
+     * Check person presence with a small input on a fixed ROI first and
+     * run the full detector only when that is uncertain or a refresh is
+     * due; skipped frames return the last full result
+     * @param refresh_frames Full run at least this often
+     */
+    void setPresenceCascade(bool enabled, int refresh_frames = 15);
+    bool isPresenceCascadeEnabled() const { return cascade_enabled_; }
+
+    /**
+     * Cascade policy (ROI, stats)
+     */
+    PresenceCascade& getPresenceCascade() { return cascade_; }
+
+    /**
+     * The last detect call reused the previous full result
+     */
+    bool wasFullRunSkipped() const { return full_run_skipped_; }
+
+    /**
+     * Decode all classes only on the cache's occasional refresh passes
+     * and the person class alone on other frames (default on)
+     */
+    void setStaticObjectCache(bool enabled);
+    bool isStaticObjectCacheEnabled() const { return static_cache_enabled_; }
+
+    /**
+     * Furniture remembered from the full-class passes
+     */
+    StaticObjectCache& getStaticObjects() { return static_cache_; }
+
+    /**
+     * Brighten dark frames with an adaptive tone curve before detection
+     * (default on; no effect on frames that are not dark)
+     */
+    void setLowLightEnhancement(bool enabled);
+    bool isLowLightEnhancementEnabled() const { return low_light_enabled_; }
+
+    /**
+     * Curve state (active, mean luma, gamma)
+     */
+    const LowLightEnhancer& getLowLightEnhancer() const { return low_light_; }
+
+    /**
+     * Run one inference at every governor input size so switching
+     * sizes later does not stall a frame on first-use allocation
+     */
+    void warmup();
 
     /**
      * Check if person is detected in frame
@@ -77,10 +263,8 @@ private:
     bool fall_detected_ = false;
     Pose estimated_pose_ = Pose::UNKNOWN;
 
-#ifdef HAVE_NCNN
-    ncnn::Net net_;
-    ncnn::Option opt_;
-#endif
+    std::shared_ptr<YoloModel> model_;
+    int num_threads_ = 0;
 
     // Detection parameters
     float conf_threshold_ = 0.15f;
@@ -91,6 +275,50 @@ private:
     // Class names for YOLO
     std::vector<std::string> class_names_;
 
+    TiledStats tiled_stats_ = {};
+
+    // Per-frame input size selection
+    ResolutionGovernor governor_;
+    bool adaptive_resolution_ = true;
+    int last_input_size_ = 640;
+
+    // Presence stage ahead of the full detector
+    PresenceCascade cascade_;
+    bool cascade_enabled_ = false;
+    bool full_run_skipped_ = false;
+    std::vector<Detection> last_full_detections_;
+
+    // Furniture between full-class passes
+    StaticObjectCache static_cache_;
+    bool static_cache_enabled_ = true;
+
+    // Night-time tone curve
+    LowLightEnhancer low_light_;
+    bool low_light_enabled_ = true;
+
+    /**
+     * Run the network on a region of the image
+     * @param image Full image
+     * @param rx, ry, rw, rh Region of interest (pixels, cropped without a copy)
+     * @param input_size Square model input the region is resized to
+     * @param num_threads Extractor threads (0 = model default)
+     * @param out Detections appended in full-image coordinates
+     * @param only_class Decode just this class (-1 = all)
+     * @param input_lut Tone curve applied to every 8-bit level before
+     *        normalization (nullptr = none)
+     */
+    void runInference(const ImageView& image, int rx, int ry, int rw, int rh,
+                      int input_size, int num_threads, std::vector<Detection>& out,
+                      int only_class = -1, const uint8_t* input_lut = nullptr) const;
+    int getThreadBudget() const;
+
+#ifdef HAVE_NCNN
+    /**
+     * Tone curve + 1/255 normalization over a resized model input
+     */
+    static void applyInputLut(ncnn::Mat& in, const uint8_t* lut);
+#endif
+
     void estimatePose(const std::vector<Detection>& detections);
     bool checkForFall(const std::vector<Detection>& detections);
 };
@@ -11,7 +11,11 @@
 #include <android/bitmap.h>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <memory>
+#include <chrono>
+#include <limits>
+#include <mutex>
 
 #define LOG_TAG "TriageVisionNative"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -21,9 +25,19 @@
 #include "../fast_pipeline/yolo_detector.h"
 #include "../fast_pipeline/motion_analyzer.h"
 #include "../fast_pipeline/pose_estimator.h"
+#include "../fast_pipeline/reposition_tracker.h"
+#include "../fast_pipeline/sleep_wake_estimator.h"
+#include "../fast_pipeline/session_manager.h"
+#include "../fast_pipeline/scene_change_detector.h"
 #endif
 
 #include "../fast_pipeline/depth_processor.h"
+#include "../fast_pipeline/frame_synchronizer.h"
+#include "../fast_pipeline/simd_kernels.h"
+#include "../fast_pipeline/thread_pool.h"
+#include "../fast_pipeline/pipeline_governor.h"
+#include "../fast_pipeline/duty_cycle_controller.h"
+#include "../storage/telemetry_log.h"
 
 #ifdef HAVE_LLAMA
 #include "../slow_pipeline/vlm_inference.h"
@@ -33,9 +47,18 @@
 
 // Global instances
 #ifdef HAVE_NCNN
+static std::shared_ptr<triage::YoloModel> g_yolo_model;  // Weights shared by all detectors
 static std::unique_ptr<triage::YoloDetector> g_yolo_detector;
 static std::unique_ptr<triage::MotionAnalyzer> g_motion_analyzer;
 static std::unique_ptr<triage::PoseEstimator> g_pose_estimator;
+static std::unique_ptr<triage::RepositionTracker> g_reposition_tracker;
+static std::unique_ptr<triage::SleepWakeEstimator> g_sleep_estimator;
+static std::unique_ptr<triage::SessionManager> g_session_manager;  // Multi-bed sessions
+static std::unique_ptr<triage::SceneChangeDetector> g_scene_detector;  // Camera bump detection
+static uint32_t g_bed_region_revision = 0;  // Static cache revision the bed zone came from
+static int g_applied_governor_level = -1;   // Governor level last pushed to the components
+static triage::BoundingBox g_duty_person_box;   // Last person box, for the depth-only idle checks
+static bool g_has_duty_person_box = false;
 #endif
 
 #ifdef HAVE_LLAMA
@@ -45,8 +68,620 @@ static std::unique_ptr<triage::VLMInference> g_vlm;
 // Depth processor (always available)
 static std::unique_ptr<triage::DepthProcessor> g_depth_processor;
 
+// RGB-depth synchronizer (always available; guards the pipeline it feeds)
+static std::unique_ptr<triage::FrameSynchronizer> g_frame_sync;
+static std::mutex g_frame_sync_mutex;
+
+/**
+ * A synced pair copied out of the synchronizer, so the pipeline runs
+ * without holding g_frame_sync_mutex (storage is reused between pairs)
+ */
+struct OwnedSyncedPair {
+    std::vector<uint8_t> rgba;
+    std::vector<uint16_t> depth;
+    triage::SyncedPair pair = {};
+
+    /**
+     * @param keep_rgba RGB pointer stays valid for as long as this copy
+     *        is used (the caller's locked Bitmap), so it is not copied
+     */
+    void assign(const triage::SyncedPair& src, const uint8_t* keep_rgba = nullptr) {
+        pair = src;
+        if (src.rgba != keep_rgba) {
+            rgba.assign(src.rgba, src.rgba + static_cast<size_t>(src.rgb_width) * src.rgb_height * 4);
+            pair.rgba = rgba.data();
+        }
+        depth.assign(src.depth, src.depth + static_cast<size_t>(src.depth_width) * src.depth_height);
+        pair.depth = depth.data();
+    }
+};
+
+// Pair completed by a depth frame, waiting for the frame thread
+// (guarded by g_frame_sync_mutex)
+static OwnedSyncedPair g_pending_pair;
+static bool g_has_pending_pair = false;
+// Pair the frame thread is running through the pipeline
+static OwnedSyncedPair g_running_pair;
+
+// Thermal/battery governor (always available; steers both pipelines)
+static triage::PipelineGovernor g_governor;
+
+// Night idle duty cycling (always available; off until the app enables it)
+static triage::DutyCycleController g_duty_cycle;
+
+// Telemetry log (always available)
+static std::unique_ptr<triage::TelemetryLog> g_telemetry_log;
+static int64_t g_last_telemetry_ms = 0;
+static const int64_t TELEMETRY_INTERVAL_MS = 1000;  // One record per second
+
 static std::string g_model_path;
 static bool g_initialized = false;
+static bool g_yolo_int8 = false;  // Prefer INT8 YOLO weights (set before init)
+
+/**
+ * Append a fast pipeline sample to the telemetry log (rate-limited to 1 Hz)
+ */
+static void appendTelemetry(const triage::TelemetryRecord& record) {
+    if (!g_telemetry_log || !g_telemetry_log->isOpen()) return;
+    if (record.timestamp_ms - g_last_telemetry_ms < TELEMETRY_INTERVAL_MS) return;
+
+    g_telemetry_log->append(record);
+    g_last_telemetry_ms = record.timestamp_ms;
+}
+
+static int64_t wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static int64_t steadyClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * View of a locked Bitmap, row padding included (no repack)
+ * @return Empty view for configs the pixel kernels cannot read
+ */
+static triage::ImageView bitmapView(const AndroidBitmapInfo& info, const void* pixels) {
+    triage::PixelFormat format;
+    switch (info.format) {
+        case ANDROID_BITMAP_FORMAT_RGBA_8888:
+            format = triage::PixelFormat::RGBA_8888;
+            break;
+        case ANDROID_BITMAP_FORMAT_RGB_565:
+            format = triage::PixelFormat::RGB_565;
+            break;
+        default:
+            LOGE("Unsupported bitmap format %d", info.format);
+            return triage::ImageView();
+    }
+    return triage::ImageView(static_cast<const uint8_t*>(pixels), info.width, info.height,
+                             info.stride, format);
+}
+
+#ifdef HAVE_NCNN
+/**
+ * Highest-confidence person box, normalized to 0-1
+ */
+static bool findPersonBox(const std::vector<triage::Detection>& detections,
+                          int width, int height, triage::BoundingBox& out) {
+    const triage::Detection* best = nullptr;
+    for (const auto& det : detections) {
+        if (det.class_id == 0 && (!best || det.confidence > best->confidence)) {
+            best = &det;
+        }
+    }
+    if (!best) return false;
+
+    out = {
+        best->x1 / static_cast<float>(width),
+        best->y1 / static_cast<float>(height),
+        (best->x2 - best->x1) / static_cast<float>(width),
+        (best->y2 - best->y1) / static_cast<float>(height)
+    };
+    return true;
+}
+
+/**
+ * Feed the repositioning tracker from the current frame
+ * @param lateral_tilt Depth tilt across the body, NaN if unavailable
+ */
+static void updateRepositioning(const std::vector<triage::Detection>& detections,
+                                int width, int height, float lateral_tilt) {
+    if (!g_reposition_tracker) return;
+
+    triage::RepositionInput input = {};
+    input.timestamp_ms = wallClockMs();
+    input.person_present = findPersonBox(detections, width, height, input.bbox);
+    input.pose = g_pose_estimator->getCurrentPose();
+    input.lateral_tilt = lateral_tilt;
+    g_reposition_tracker->update(input);
+}
+
+/**
+ * Low-rate camera-bump check; on a confirmed change, drop calibrations
+ * learned for the old view so they are re-estimated
+ * @param use_depth Include the current depth map in the signature
+ */
+static void checkSceneChange(const triage::ImageView& image, bool use_depth) {
+    if (!g_scene_detector) return;
+
+    triage::DepthView depth;
+    if (use_depth && g_depth_processor && g_depth_processor->hasDepthData()) {
+        depth = triage::DepthView::packed(g_depth_processor->getRangePlane(),
+                                          g_depth_processor->getWidth(),
+                                          g_depth_processor->getHeight());
+    }
+
+    auto scene = g_scene_detector->update(image, depth, wallClockMs());
+    if (!scene.changed) return;
+
+    if (g_depth_processor) {
+        g_depth_processor->invalidateCalibration();
+    }
+    if (g_reposition_tracker) {
+        g_reposition_tracker->rebaseAnchor();
+    }
+    if (g_yolo_detector) {
+        g_yolo_detector->getStaticObjects().clear();
+    }
+}
+
+/**
+ * Point the depth bed zone at the cached bed box whenever the static
+ * object cache reports a change (until then the 2 m / 1.5 m default stands)
+ */
+static void updateBedRegion(int width, int height) {
+    if (!g_depth_processor->hasDepthData()) return;
+
+    auto& cache = g_yolo_detector->getStaticObjects();
+    if (cache.getRevision() == g_bed_region_revision) return;
+
+    const triage::StaticObject* bed = cache.findStable(triage::StaticObjectCache::BED);
+    if (bed) {
+        triage::BoundingBox bed_box = {bed->x1, bed->y1, bed->x2 - bed->x1, bed->y2 - bed->y1};
+        if (!g_depth_processor->setBedRegionFromBox(bed_box, width, height)) {
+            return;  // No depth on the bed yet - retry next frame
+        }
+    }
+    g_bed_region_revision = cache.getRevision();
+}
+
+/**
+ * Push the governor level's settings to the components. Called on the
+ * frame thread, which owns the detector and motion analyzer.
+ */
+static void applyGovernorLevel() {
+    const int level = g_governor.getLevel();
+    if (level == g_applied_governor_level) return;
+
+    const triage::GovernorLevel& settings = triage::PipelineGovernor::LEVELS[level];
+    if (g_yolo_detector) {
+        g_yolo_detector->setMaxInputSize(settings.yolo_max_input);
+    }
+    if (g_session_manager) {
+        g_session_manager->setMaxInputSize(settings.yolo_max_input);
+    }
+    if (g_motion_analyzer) {
+        g_motion_analyzer->setSampleStep(settings.motion_step);
+    }
+#ifdef HAVE_LLAMA
+    if (g_vlm) {
+        g_vlm->setThreadCount(settings.vlm_threads);
+    }
+#endif
+    g_applied_governor_level = level;
+    LOGI("Governor level %s: max %d fps, YOLO <= %d, motion step %d, VLM %d threads",
+         settings.name, settings.max_fps, settings.yolo_max_input, settings.motion_step,
+         settings.vlm_threads);
+}
+
+// Result of a frame over the governor or idle rate: nothing was run, so
+// the caller keeps its last state and raises no alerts from it
+static const char* const SKIPPED_RESULT_JSON = R"({"skipped": true})";
+
+/**
+ * Frame pacing at the governor level's frame rate
+ * @return false if the frame should be skipped
+ */
+static bool admitGovernedFrame() {
+    const int64_t now_ms = steadyClockMs();
+    g_governor.update(now_ms);
+    applyGovernorLevel();
+    return g_governor.admitFrame(now_ms);
+}
+
+/**
+ * Duty cycling inputs from a frame's RGB motion
+ */
+static triage::DutyCycleSignals motionDutySignals(const triage::MotionState& motion) {
+    triage::DutyCycleSignals signals;
+    signals.still_ms = motion.is_still ? motion.stillness_duration : 0;
+    signals.motion_cells = motion.active_cell_fraction;
+    signals.lighting_change = motion.lighting_change;
+    return signals;
+}
+
+/**
+ * Run the fast pipeline on a camera frame (no depth)
+ * @return JSON result
+ */
+static std::string runFastPipeline(const triage::ImageView& image) {
+    const int64_t now_ms = steadyClockMs();
+    if (!g_duty_cycle.admitFrame(now_ms) || !admitGovernedFrame()) {
+        return SKIPPED_RESULT_JSON;
+    }
+    std::string result_json = "{}";
+
+    if (g_yolo_detector && g_motion_analyzer && g_pose_estimator && !image.empty()) {
+        // Analyze motion (all that runs while duty cycling is idle)
+        auto motion_state = g_motion_analyzer->analyze(image);
+
+        // Actigraphy epoch accumulation
+        g_sleep_estimator->addFrame(motion_state.active_cell_fraction, wallClockMs());
+
+        // An idle frame with activity wakes the pipeline and runs in full
+        triage::DutyCycleSignals signals = motionDutySignals(motion_state);
+        const bool idle_checked = g_duty_cycle.isIdle();
+        const bool idle = idle_checked &&
+            g_duty_cycle.update(signals, false, now_ms) != triage::DutyMode::FULL;
+
+        std::vector<triage::Detection> detections;
+        if (!idle) {
+            // Run YOLO detection
+            detections = g_yolo_detector->detect(image);
+
+            // Update pose estimator
+            g_pose_estimator->update(detections);
+
+            // Camera bump check (edge signature only)
+            checkSceneChange(image, false);
+
+            // Update repositioning timer (no depth tilt without ToF)
+            updateRepositioning(detections, image.width, image.height,
+                                std::numeric_limits<float>::quiet_NaN());
+        }
+        if (!idle_checked) {
+            signals.alert = g_yolo_detector->isFallDetected();
+            g_duty_cycle.update(signals, false, now_ms);
+        }
+
+        // Build JSON result
+        char json_buf[1024];
+        snprintf(json_buf, sizeof(json_buf),
+            R"({"person_detected": %s, "pose": %d, "motion_level": %.3f, )"
+            R"("fall_detected": %s, "seconds_since_motion": %lld, "detection_count": %zu, )"
+            R"("seconds_since_reposition": %lld, "reposition_count": %u, )"
+            R"("sleep_state": %d, "activity_level": %.3f, "lighting_change": %s, )"
+            R"("low_light": %s, "scene_generation": %u, "scene_settling": %s, )"
+            R"("input_size": %d, "inference_ms": %.1f, "full_inference": %s, "duty_mode": "%s"})",
+            g_yolo_detector->isPersonDetected() ? "true" : "false",
+            static_cast<int>(g_pose_estimator->getCurrentPose()),
+            motion_state.motion_level,
+            g_yolo_detector->isFallDetected() ? "true" : "false",
+            (long long)g_motion_analyzer->getSecondsSinceMotion(),
+            detections.size(),
+            (long long)(g_reposition_tracker->getMsSinceReposition(wallClockMs()) / 1000),
+            g_reposition_tracker->getEventCount(),
+            static_cast<int>(g_sleep_estimator->getState()),
+            g_sleep_estimator->getActivityLevel(),
+            motion_state.lighting_change ? "true" : "false",
+            g_yolo_detector->getLowLightEnhancer().isActive() ? "true" : "false",
+            g_scene_detector->getGeneration(),
+            g_scene_detector->isSettling() ? "true" : "false",
+            g_yolo_detector->getInputSize(),
+            g_yolo_detector->getGovernor().getLatencyMs(),
+            (idle || g_yolo_detector->wasFullRunSkipped()) ? "false" : "true",
+            triage::dutyModeName(g_duty_cycle.getMode())
+        );
+        result_json = json_buf;
+
+        triage::TelemetryRecord record = {};
+        record.timestamp_ms = wallClockMs();
+        record.motion_level = motion_state.motion_level;
+        record.pose = static_cast<uint8_t>(g_pose_estimator->getCurrentPose());
+        record.flags = (g_yolo_detector->isPersonDetected() ? triage::TELEMETRY_PERSON_PRESENT : 0) |
+                       (g_yolo_detector->isFallDetected() ? triage::TELEMETRY_FALL_DETECTED : 0);
+        appendTelemetry(record);
+    }
+
+    return result_json;
+}
+
+/**
+ * Run the fast pipeline on a frame with the current depth map
+ * (already loaded into g_depth_processor)
+ * @return JSON result with depth metrics
+ */
+static std::string runDepthPipeline(const triage::ImageView& image) {
+    const int64_t now_ms = steadyClockMs();
+    if (!g_duty_cycle.admitFrame(now_ms) || !admitGovernedFrame()) {
+        return SKIPPED_RESULT_JSON;
+    }
+    std::string result_json = "{}";
+    const int width = image.width;
+    const int height = image.height;
+
+    if (g_yolo_detector && g_motion_analyzer && g_pose_estimator && !image.empty()) {
+        // Depth-enhanced analysis
+        float distance_meters = 0.0f;
+        float depth_motion_level = 0.0f;
+        bool depth_fall = false;
+        float vertical_drop = 0.0f;
+        float fall_confidence = 0.0f;
+        float head_height = 0.0f;
+        float near_floor_fraction = 0.0f;
+        float bed_proximity = 0.0f;
+        bool in_bed_zone = false;
+        float pos_x = 0.0f, pos_y = 0.0f, pos_z = 0.0f;
+        float height_above_bed = 0.0f;
+        float over_bed_edge = 0.0f;
+
+        // Depth-only idle: the depth checks on the last person box stand in
+        // for the pipeline; an idle frame with activity wakes it and runs in full
+        const triage::DutyMode duty_mode = g_duty_cycle.getMode();
+        bool idle = false;
+        bool depth_measured = false;   // Fall and motion already run on this depth map
+        if (duty_mode == triage::DutyMode::DEPTH_ONLY) {
+            const bool depth_ready = g_depth_processor->hasDepthData() && g_has_duty_person_box;
+            triage::DutyCycleSignals signals;
+            if (depth_ready) {
+                depth_measured = true;
+                auto fall_result = g_depth_processor->detectFall(g_duty_person_box, width, height);
+                depth_fall = fall_result.fall_detected;
+                vertical_drop = fall_result.vertical_drop_meters;
+                fall_confidence = fall_result.confidence;
+                head_height = fall_result.head_height_meters;
+                near_floor_fraction = fall_result.near_floor_fraction;
+
+                auto motion_result = g_depth_processor->analyzeMotion(g_duty_person_box, width, height);
+                distance_meters = motion_result.distance_meters;
+                depth_motion_level = motion_result.depth_motion_level;
+                bed_proximity = motion_result.bed_proximity_meters;
+                in_bed_zone = motion_result.in_bed_zone;
+                pos_x = motion_result.position_3d.x;
+                pos_y = motion_result.position_3d.y;
+                pos_z = motion_result.position_3d.z;
+
+                signals.alert = depth_fall;
+                signals.depth_motion = depth_motion_level;
+                signals.head_drop_meters = fall_result.head_drop_meters;
+                auto occupancy = g_depth_processor->measureBedOccupancy(g_duty_person_box);
+                if (occupancy.valid) {
+                    height_above_bed = occupancy.height_above_bed_meters;
+                    over_bed_edge = occupancy.over_edge_fraction;
+                    signals.height_above_bed = height_above_bed;
+                    signals.over_bed_edge = over_bed_edge;
+                }
+            }
+            idle = g_duty_cycle.update(signals, depth_ready, now_ms) != triage::DutyMode::FULL;
+        }
+
+        // Analyze RGB motion (not while depth stands in for it)
+        triage::MotionState motion_state = {};
+        motion_state.motion_level = g_motion_analyzer->getMotionLevel();
+        if (!idle) {
+            motion_state = g_motion_analyzer->analyze(image);
+
+            // Actigraphy epoch accumulation
+            g_sleep_estimator->addFrame(motion_state.active_cell_fraction, wallClockMs());
+        }
+        if (duty_mode == triage::DutyMode::MOTION_ONLY) {
+            idle = g_duty_cycle.update(motionDutySignals(motion_state), false, now_ms) !=
+                   triage::DutyMode::FULL;
+        }
+
+        std::vector<triage::Detection> detections;
+        bool has_person_box = false;
+        if (!idle) {
+            // Run YOLO detection on RGB
+            detections = g_yolo_detector->detect(image);
+
+            // Update pose estimator
+            g_pose_estimator->update(detections);
+
+            // Camera bump invalidates floor / bed calibration before it is used
+            checkSceneChange(image, true);
+
+            // Bed zone from the cached bed box
+            updateBedRegion(width, height);
+
+            // A wake from depth-only idle keeps the idle checks' results: a
+            // second pass would add this depth map to the fall history twice
+            if (g_depth_processor->hasDepthData() && !detections.empty() && !depth_measured) {
+                // Get person bounding box (use first detection)
+                auto& det = detections[0];
+                triage::BoundingBox person_bbox = {
+                    det.x1 / static_cast<float>(width),
+                    det.y1 / static_cast<float>(height),
+                    (det.x2 - det.x1) / static_cast<float>(width),
+                    (det.y2 - det.y1) / static_cast<float>(height)
+                };
+
+                // Fall detection with depth
+                auto fall_result = g_depth_processor->detectFall(
+                    person_bbox, width, height);
+                depth_fall = fall_result.fall_detected;
+                vertical_drop = fall_result.vertical_drop_meters;
+                fall_confidence = fall_result.confidence;
+                head_height = fall_result.head_height_meters;
+                near_floor_fraction = fall_result.near_floor_fraction;
+
+                // Motion analysis with depth
+                auto motion_result = g_depth_processor->analyzeMotion(
+                    person_bbox, width, height);
+                distance_meters = motion_result.distance_meters;
+                depth_motion_level = motion_result.depth_motion_level;
+                bed_proximity = motion_result.bed_proximity_meters;
+                in_bed_zone = motion_result.in_bed_zone;
+                pos_x = motion_result.position_3d.x;
+                pos_y = motion_result.position_3d.y;
+                pos_z = motion_result.position_3d.z;
+            }
+
+            // Repositioning timer, with lateral orientation from depth when a person is seen
+            float lateral_tilt = std::numeric_limits<float>::quiet_NaN();
+            triage::BoundingBox person_box;
+            has_person_box = g_depth_processor->hasDepthData() &&
+                             findPersonBox(detections, width, height, person_box);
+            if (has_person_box) {
+                lateral_tilt = g_depth_processor->estimateLateralTilt(person_box);
+            }
+            updateRepositioning(detections, width, height, lateral_tilt);
+
+            // Mattress plane (learned while the bed is empty or the patient is still)
+            // and the patient's height above it
+            triage::DutyCycleSignals signals = motionDutySignals(motion_state);
+            if (g_depth_processor->hasDepthData()) {
+                g_depth_processor->updateBedSurface(has_person_box ? &person_box : nullptr,
+                                                    motion_state.is_still);
+                if (has_person_box) {
+                    auto occupancy = g_depth_processor->measureBedOccupancy(person_box);
+                    if (occupancy.valid) {
+                        height_above_bed = occupancy.height_above_bed_meters;
+                        over_bed_edge = occupancy.over_edge_fraction;
+                        signals.height_above_bed = height_above_bed;
+                    }
+                }
+            }
+
+            // Person box the depth-only idle checks will watch
+            g_has_duty_person_box = has_person_box;
+            if (has_person_box) {
+                g_duty_person_box = person_box;
+            }
+            if (duty_mode == triage::DutyMode::FULL) {
+                signals.alert = g_yolo_detector->isFallDetected() || depth_fall;
+                g_duty_cycle.update(signals, has_person_box, now_ms);
+            }
+        }
+
+        // Combined fall detection (2D + depth)
+        bool combined_fall = g_yolo_detector->isFallDetected() || depth_fall;
+
+        // Build JSON result with depth metrics
+        char json_buf[2048];
+        snprintf(json_buf, sizeof(json_buf),
+            R"({)"
+            R"("person_detected": %s, )"
+            R"("pose": %d, )"
+            R"("motion_level": %.3f, )"
+            R"("fall_detected": %s, )"
+            R"("depth_fall": %s, )"
+            R"("vertical_drop_meters": %.3f, )"
+            R"("fall_confidence": %.2f, )"
+            R"("head_height_meters": %.2f, )"
+            R"("near_floor_fraction": %.2f, )"
+            R"("seconds_since_motion": %lld, )"
+            R"("detection_count": %zu, )"
+            R"("distance_meters": %.2f, )"
+            R"("depth_motion_level": %.3f, )"
+            R"("bed_proximity_meters": %.2f, )"
+            R"("in_bed_zone": %s, )"
+            R"("bed_surface_valid": %s, )"
+            R"("height_above_bed_meters": %.2f, )"
+            R"("over_bed_edge_fraction": %.2f, )"
+            R"("position_3d": {"x": %.3f, "y": %.3f, "z": %.3f}, )"
+            R"("depth_available": %s, )"
+            R"("depth_valid_fraction": %.3f, )"
+            R"("seconds_since_reposition": %lld, )"
+            R"("reposition_count": %u, )"
+            R"("lying_orientation": %d, )"
+            R"("sleep_state": %d, )"
+            R"("activity_level": %.3f, )"
+            R"("lighting_change": %s, )"
+            R"("low_light": %s, )"
+            R"("scene_generation": %u, )"
+            R"("scene_settling": %s, )"
+            R"("input_size": %d, )"
+            R"("inference_ms": %.1f, )"
+            R"("full_inference": %s, )"
+            R"("duty_mode": "%s")"
+            R"(})",
+            g_yolo_detector->isPersonDetected() ? "true" : "false",
+            static_cast<int>(g_pose_estimator->getCurrentPose()),
+            motion_state.motion_level,
+            combined_fall ? "true" : "false",
+            depth_fall ? "true" : "false",
+            vertical_drop,
+            fall_confidence,
+            head_height,
+            near_floor_fraction,
+            (long long)g_motion_analyzer->getSecondsSinceMotion(),
+            detections.size(),
+            distance_meters,
+            depth_motion_level,
+            bed_proximity,
+            in_bed_zone ? "true" : "false",
+            g_depth_processor->hasBedSurface() ? "true" : "false",
+            height_above_bed,
+            over_bed_edge,
+            pos_x, pos_y, pos_z,
+            g_depth_processor->hasDepthData() ? "true" : "false",
+            g_depth_processor->getValidFraction(),
+            (long long)(g_reposition_tracker->getMsSinceReposition(wallClockMs()) / 1000),
+            g_reposition_tracker->getEventCount(),
+            static_cast<int>(g_reposition_tracker->getOrientation()),
+            static_cast<int>(g_sleep_estimator->getState()),
+            g_sleep_estimator->getActivityLevel(),
+            motion_state.lighting_change ? "true" : "false",
+            g_yolo_detector->getLowLightEnhancer().isActive() ? "true" : "false",
+            g_scene_detector->getGeneration(),
+            g_scene_detector->isSettling() ? "true" : "false",
+            g_yolo_detector->getInputSize(),
+            g_yolo_detector->getGovernor().getLatencyMs(),
+            (idle || g_yolo_detector->wasFullRunSkipped()) ? "false" : "true",
+            triage::dutyModeName(g_duty_cycle.getMode())
+        );
+        result_json = json_buf;
+
+        triage::TelemetryRecord record = {};
+        record.timestamp_ms = wallClockMs();
+        record.motion_level = motion_state.motion_level;
+        record.depth_motion_level = depth_motion_level;
+        record.distance_meters = distance_meters;
+        record.position_x = pos_x;
+        record.position_y = pos_y;
+        record.position_z = pos_z;
+        record.fall_confidence = fall_confidence;
+        record.pose = static_cast<uint8_t>(g_pose_estimator->getCurrentPose());
+        record.flags = (g_yolo_detector->isPersonDetected() ? triage::TELEMETRY_PERSON_PRESENT : 0) |
+                       (combined_fall ? triage::TELEMETRY_FALL_DETECTED : 0) |
+                       (in_bed_zone ? triage::TELEMETRY_IN_BED_ZONE : 0) |
+                       (distance_meters > 0 ? triage::TELEMETRY_DEPTH_VALID : 0);
+        appendTelemetry(record);
+    }
+
+    return result_json;
+}
+#endif
+
+/**
+ * Run a synchronized pair through the depth pipeline
+ * @return Pipeline JSON tagged with "synced" and "sync_delta_ms"
+ */
+static std::string processSyncedPair(const triage::SyncedPair& pair) {
+    if (!g_depth_processor) {
+        g_depth_processor = std::make_unique<triage::DepthProcessor>();
+    }
+    g_depth_processor->updateDepthMap(
+        triage::DepthView::packed(pair.depth, pair.depth_width, pair.depth_height));
+
+    std::string result_json = "{}";
+#ifdef HAVE_NCNN
+    result_json = runDepthPipeline(
+        triage::ImageView::packed(pair.rgba, pair.rgb_width, pair.rgb_height));
+#endif
+
+    char sync_buf[96];
+    snprintf(sync_buf, sizeof(sync_buf), R"({"synced": true, "sync_delta_ms": %.1f)",
+             pair.delta_ns / 1e6);
+    if (result_json.size() > 2) {
+        return std::string(sync_buf) + ", " + result_json.substr(1);
+    }
+    return std::string(sync_buf) + "}";
+}
 
 extern "C" {
 
@@ -66,14 +701,31 @@ Java_com_triage_vision_native_NativeBridge_init(
 
     int result = 0;
 
+    // Detect CPU features, pick kernel variants and start the shared
+    // thread pool before the first frame
+    LOGI("SIMD kernels: %s", triage::simdKernels().name);
+    triage::ThreadPool::instance();
+    g_governor.init();
+    g_duty_cycle.init();
+
 #ifdef HAVE_NCNN
     LOGI("NCNN support enabled - initializing fast pipeline");
 
+    // New components start at defaults; the governor level is re-applied
+    // on the first frame
+    g_applied_governor_level = -1;
+
+    // Load YOLO weights once; the detector and any camera sessions share them
+    g_yolo_model = triage::YoloModel::load(g_model_path, true, g_yolo_int8);
+
     // Initialize YOLO detector
     g_yolo_detector = std::make_unique<triage::YoloDetector>();
-    if (!g_yolo_detector->init(g_model_path, true)) {
+    if (!g_yolo_detector->init(g_yolo_model)) {
         LOGE("Failed to initialize YOLO detector");
         result = -1;
+    } else {
+        // Pre-warm every governor input size so switching never stalls a frame
+        g_yolo_detector->warmup();
     }
 
     // Initialize motion analyzer
@@ -83,296 +735,1188 @@ Java_com_triage_vision_native_NativeBridge_init(
     // Initialize pose estimator
     g_pose_estimator = std::make_unique<triage::PoseEstimator>();
 
+    // Initialize repositioning tracker (pressure-injury timer)
+    g_reposition_tracker = std::make_unique<triage::RepositionTracker>();
+    g_reposition_tracker->init();
+
+    // Initialize streaming sleep/wake estimator (30 s Cole-Kripke epochs)
+    g_sleep_estimator = std::make_unique<triage::SleepWakeEstimator>();
+    g_sleep_estimator->init();
+
+    // Initialize camera-bump detector (1 Hz signature checks)
+    g_scene_detector = std::make_unique<triage::SceneChangeDetector>();
+    g_scene_detector->init();
+
 #else
     LOGI("NCNN support not available - fast pipeline disabled");
 #endif
 
-#ifdef HAVE_LLAMA
-    LOGI("llama.cpp support enabled - initializing slow pipeline");
+#ifdef HAVE_LLAMA
+    LOGI("llama.cpp support enabled - initializing slow pipeline");
+
+    // Actual asset filenames (both model and mmproj required for vision)
+    std::string vlm_path = g_model_path + "/SmolVLM-500M-Instruct-Q8_0.gguf";
+    std::string mmproj_path = g_model_path + "/mmproj-SmolVLM-500M-Instruct-Q8_0.gguf";
+
+    g_vlm = std::make_unique<triage::VLMInference>();
+    if (!g_vlm->init(vlm_path, mmproj_path, 4, 0)) {
+        LOGE("Failed to initialize VLM from: %s", vlm_path.c_str());
+        // Don't fail completely - VLM is optional
+    } else {
+        LOGI("VLM initialized successfully from: %s", vlm_path.c_str());
+    }
+
+#else
+    LOGI("llama.cpp support not available - slow pipeline disabled");
+#endif
+
+    g_initialized = (result == 0);
+    env->ReleaseStringUTFChars(model_path, path);
+    return result;
+}
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setYoloInt8(
+    JNIEnv *env,
+    jobject thiz,
+    jboolean enabled
+) {
+    g_yolo_int8 = enabled;
+    LOGI("YOLO INT8 model %s (applies on next init)", enabled ? "preferred" : "disabled");
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_triage_vision_native_NativeBridge_isYoloInt8(
+    JNIEnv *env,
+    jobject thiz
+) {
+#ifdef HAVE_NCNN
+    return g_yolo_model && g_yolo_model->int8;
+#else
+    return false;
+#endif
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getCpuFeatures(
+    JNIEnv *env,
+    jobject thiz
+) {
+    const triage::CpuFeatures& cpu = triage::cpuFeatures();
+    char json_buf[256];
+    snprintf(json_buf, sizeof(json_buf),
+        R"({"neon": %s, "dotprod": %s, "fp16": %s, "i8mm": %s, "avx2": %s, "fma": %s, )"
+        R"("kernels": "%s"})",
+        cpu.neon ? "true" : "false",
+        cpu.dotprod ? "true" : "false",
+        cpu.fp16 ? "true" : "false",
+        cpu.i8mm ? "true" : "false",
+        cpu.avx2 ? "true" : "false",
+        cpu.fma ? "true" : "false",
+        triage::simdKernels().name
+    );
+    return env->NewStringUTF(json_buf);
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getThreadPoolStats(
+    JNIEnv *env,
+    jobject thiz
+) {
+    triage::ThreadPoolStats stats = triage::ThreadPool::instance().getStats();
+    char json_buf[384];
+    snprintf(json_buf, sizeof(json_buf),
+        R"({"workers": %d, "active_workers": %d, "external_threads": %d, )"
+        R"("tasks_run": %llu, "tasks_stolen": %llu, "parallel_fors": %llu, )"
+        R"("chunks_run": %llu, "chunks_by_caller": %llu})",
+        stats.workers, stats.active_workers, stats.external_threads,
+        static_cast<unsigned long long>(stats.tasks_run),
+        static_cast<unsigned long long>(stats.tasks_stolen),
+        static_cast<unsigned long long>(stats.parallel_fors),
+        static_cast<unsigned long long>(stats.chunks_run),
+        static_cast<unsigned long long>(stats.chunks_by_caller)
+    );
+    return env->NewStringUTF(json_buf);
+}
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setThermalState(
+    JNIEnv *env,
+    jobject thiz,
+    jint status
+) {
+    auto state = static_cast<triage::ThermalState>(std::max(0, std::min(static_cast<int>(status), 6)));
+    g_governor.setThermalState(state, steadyClockMs());
+#ifdef HAVE_NCNN
+    if (g_yolo_detector) {
+        g_yolo_detector->setThermalState(state);
+    }
+    if (g_session_manager) {
+        g_session_manager->setThermalState(state);
+    }
+#endif
+    LOGI("Thermal state: %d", static_cast<int>(status));
+}
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setThermalHeadroom(
+    JNIEnv *env,
+    jobject thiz,
+    jfloat headroom
+) {
+    g_governor.setThermalHeadroom(headroom, steadyClockMs());
+}
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setBatteryState(
+    JNIEnv *env,
+    jobject thiz,
+    jfloat percent,
+    jboolean charging
+) {
+    g_governor.setBattery(percent, charging, steadyClockMs());
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_triage_vision_native_NativeBridge_pollSysfsPower(
+    JNIEnv *env,
+    jobject thiz
+) {
+    // Start from the inputs the app reported, so sysfs only replaces
+    // what it exposes
+    const int64_t now_ms = steadyClockMs();
+    triage::PowerSample sample = g_governor.getStats(now_ms).sample;
+    if (!triage::readSysfsPowerSample(sample)) {
+        return JNI_FALSE;
+    }
+    g_governor.setPowerSample(sample, now_ms);
+    return JNI_TRUE;
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getGovernorState(
+    JNIEnv *env,
+    jobject thiz
+) {
+    triage::GovernorStats stats = g_governor.getStats(steadyClockMs());
+    const triage::GovernorLevel& settings = triage::PipelineGovernor::LEVELS[stats.level];
+    const float headroom = stats.sample.thermal_headroom;
+    char json_buf[768];
+    snprintf(json_buf, sizeof(json_buf),
+        R"({"level": %d, "name": "%s", "demand": %d, "max_fps": %d, "yolo_max_input": %d, )"
+        R"("motion_step": %d, "vlm_threads": %d, "level_changes": %u, )"
+        R"("frames_admitted": %llu, "frames_skipped": %llu, "seconds_at_level": [%.1f, %.1f, %.1f, %.1f], )"
+        R"("thermal_headroom": %.3f, "thermal_state": %d, "battery_percent": %.0f, "charging": %s})",
+        stats.level, settings.name, stats.demand, settings.max_fps, settings.yolo_max_input,
+        settings.motion_step, settings.vlm_threads, stats.level_changes,
+        static_cast<unsigned long long>(stats.frames_admitted),
+        static_cast<unsigned long long>(stats.frames_skipped),
+        stats.ms_at_level[0] / 1000.0, stats.ms_at_level[1] / 1000.0,
+        stats.ms_at_level[2] / 1000.0, stats.ms_at_level[3] / 1000.0,
+        std::isnan(headroom) ? -1.0f : headroom,
+        static_cast<int>(stats.sample.thermal_state),
+        stats.sample.battery_percent,
+        stats.sample.charging ? "true" : "false"
+    );
+    return env->NewStringUTF(json_buf);
+}
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setDutyCycling(
+    JNIEnv *env,
+    jobject thiz,
+    jboolean enabled,
+    jint idle_after_seconds
+) {
+    triage::DutyCycleConfig config;
+    if (idle_after_seconds > 0) {
+        config.idle_after_ms = static_cast<int64_t>(idle_after_seconds) * 1000;
+    }
+    g_duty_cycle.init(config);
+    g_duty_cycle.setEnabled(enabled, steadyClockMs());
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getDutyCycleState(
+    JNIEnv *env,
+    jobject thiz
+) {
+    triage::DutyCycleStats stats = g_duty_cycle.getStats(steadyClockMs());
+    char json_buf[512];
+    snprintf(json_buf, sizeof(json_buf),
+        R"({"enabled": %s, "mode": "%s", "idle_entries": %u, "wakes": %u, "last_wake_reason": "%s", )"
+        R"("frames_processed": %llu, "frames_skipped": %llu, )"
+        R"("seconds_in_mode": {"full": %.1f, "motion_only": %.1f, "depth_only": %.1f}})",
+        stats.enabled ? "true" : "false",
+        triage::dutyModeName(stats.mode),
+        stats.idle_entries, stats.wakes, stats.last_wake_reason,
+        static_cast<unsigned long long>(stats.frames_processed),
+        static_cast<unsigned long long>(stats.frames_skipped),
+        stats.ms_in_mode[0] / 1000.0, stats.ms_in_mode[1] / 1000.0, stats.ms_in_mode[2] / 1000.0
+    );
+    return env->NewStringUTF(json_buf);
+}
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setYoloLatencyBudget(
+    JNIEnv *env,
+    jobject thiz,
+    jfloat budget_ms
+) {
+#ifdef HAVE_NCNN
+    if (g_yolo_detector && budget_ms > 0.0f) {
+        g_yolo_detector->setLatencyBudget(budget_ms);
+    }
+#endif
+}
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setPresenceCascade(
+    JNIEnv *env,
+    jobject thiz,
+    jboolean enabled,
+    jint refresh_frames
+) {
+#ifdef HAVE_NCNN
+    if (g_yolo_detector) {
+        g_yolo_detector->setPresenceCascade(enabled, std::max(1, static_cast<int>(refresh_frames)));
+    }
+#endif
+}
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setPresenceRoi(
+    JNIEnv *env,
+    jobject thiz,
+    jfloat left,
+    jfloat top,
+    jfloat right,
+    jfloat bottom
+) {
+#ifdef HAVE_NCNN
+    if (g_yolo_detector) {
+        g_yolo_detector->getPresenceCascade().setRoi(left, top, right, bottom);
+        LOGI("Presence ROI: (%.2f, %.2f) - (%.2f, %.2f)", left, top, right, bottom);
+    }
+#endif
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getPresenceCascadeStats(
+    JNIEnv *env,
+    jobject thiz
+) {
+    std::string result_json = "{}";
+
+#ifdef HAVE_NCNN
+    if (g_yolo_detector) {
+        auto stats = g_yolo_detector->getPresenceCascade().getStats();
+        char json_buf[512];
+        snprintf(json_buf, sizeof(json_buf),
+            R"({"enabled": %s, "frames": %llu, "full_runs": %llu, )"
+            R"("avoided_fraction": %.3f, "mean_stage_ms": %.2f, "mean_full_ms": %.2f, )"
+            R"("mean_frame_ms": %.2f})",
+            g_yolo_detector->isPresenceCascadeEnabled() ? "true" : "false",
+            (unsigned long long)stats.frames,
+            (unsigned long long)stats.full_runs,
+            stats.avoided_fraction,
+            stats.mean_stage_ms,
+            stats.mean_full_ms,
+            stats.mean_frame_ms
+        );
+        result_json = json_buf;
+    }
+#endif
+
+    return env->NewStringUTF(result_json.c_str());
+}
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setStaticObjectCache(
+    JNIEnv *env,
+    jobject thiz,
+    jboolean enabled
+) {
+#ifdef HAVE_NCNN
+    if (g_yolo_detector) {
+        g_yolo_detector->setStaticObjectCache(enabled);
+    }
+#endif
+}
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setLowLightEnhancement(
+    JNIEnv *env,
+    jobject thiz,
+    jboolean enabled
+) {
+#ifdef HAVE_NCNN
+    if (g_yolo_detector) {
+        g_yolo_detector->setLowLightEnhancement(enabled);
+    }
+#endif
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getLowLightStatus(
+    JNIEnv *env,
+    jobject thiz
+) {
+    std::string result_json = "{}";
+
+#ifdef HAVE_NCNN
+    if (g_yolo_detector) {
+        const auto& enhancer = g_yolo_detector->getLowLightEnhancer();
+        char json_buf[160];
+        snprintf(json_buf, sizeof(json_buf),
+            R"({"enabled": %s, "active": %s, "mean_luma": %.1f, "gamma": %.2f})",
+            g_yolo_detector->isLowLightEnhancementEnabled() ? "true" : "false",
+            enhancer.isActive() ? "true" : "false",
+            enhancer.getMeanLuma(),
+            enhancer.getGamma()
+        );
+        result_json = json_buf;
+    }
+#endif
+
+    return env->NewStringUTF(result_json.c_str());
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getStaticObjects(
+    JNIEnv *env,
+    jobject thiz
+) {
+    std::string result_json = "{}";
+
+#ifdef HAVE_NCNN
+    if (g_yolo_detector) {
+        const auto& cache = g_yolo_detector->getStaticObjects();
+        char item[256];
+        result_json = R"({"revision": )" + std::to_string(cache.getRevision()) + R"(, "objects": [)";
+        const auto& objects = cache.getObjects();
+        for (size_t i = 0; i < objects.size(); i++) {
+            const auto& o = objects[i];
+            snprintf(item, sizeof(item),
+                R"(%s{"class_id": %d, "class_name": "%s", "x1": %.3f, "y1": %.3f, "x2": %.3f, "y2": %.3f, )"
+                R"("persistence": %.2f, "stable": %s, "sightings": %d})",
+                i > 0 ? ", " : "", o.class_id, o.class_name.c_str(), o.x1, o.y1, o.x2, o.y2,
+                o.persistence, o.stable ? "true" : "false", o.sightings);
+            result_json += item;
+        }
+        result_json += "]}";
+    }
+#endif
+
+    return env->NewStringUTF(result_json.c_str());
+}
+
+// ============================================================================
+// Fast Pipeline - Motion/Pose Detection
+// ============================================================================
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_detectMotion(
+    JNIEnv *env,
+    jobject thiz,
+    jobject bitmap
+) {
+    // Get bitmap info
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS) {
+        LOGE("Failed to get bitmap info");
+        return env->NewStringUTF("{}");
+    }
+
+    // Lock pixels
+    void *pixels;
+    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != ANDROID_BITMAP_RESULT_SUCCESS) {
+        LOGE("Failed to lock bitmap pixels");
+        return env->NewStringUTF("{}");
+    }
+
+    std::string result_json = "{}";
+
+#ifdef HAVE_NCNN
+    result_json = runFastPipeline(bitmapView(info, pixels));
+#endif
+
+    // Unlock pixels
+    AndroidBitmap_unlockPixels(env, bitmap);
+
+    return env->NewStringUTF(result_json.c_str());
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_detectMotionNv21(
+    JNIEnv *env,
+    jobject thiz,
+    jobject y_buffer,
+    jobject vu_buffer,
+    jint width,
+    jint height,
+    jint y_row_stride,
+    jint vu_row_stride
+) {
+    // Camera planes are read in place - no Bitmap conversion
+    auto* y_plane = static_cast<const uint8_t*>(env->GetDirectBufferAddress(y_buffer));
+    auto* vu_plane = static_cast<const uint8_t*>(env->GetDirectBufferAddress(vu_buffer));
+    if (y_plane == nullptr || vu_plane == nullptr) {
+        LOGE("NV21 planes must be direct buffers");
+        return env->NewStringUTF("{}");
+    }
+    const int chroma_rows = (height + 1) / 2;
+    if (width <= 0 || height <= 0 || y_row_stride < width || vu_row_stride < ((width + 1) & ~1) ||
+        env->GetDirectBufferCapacity(y_buffer) < static_cast<jlong>(height - 1) * y_row_stride + width ||
+        env->GetDirectBufferCapacity(vu_buffer) <
+            static_cast<jlong>(chroma_rows - 1) * vu_row_stride + ((width + 1) & ~1)) {
+        LOGE("Invalid NV21 frame %dx%d (strides %d, %d)", width, height, y_row_stride, vu_row_stride);
+        return env->NewStringUTF("{}");
+    }
+
+    std::string result_json = "{}";
+
+#ifdef HAVE_NCNN
+    result_json = runFastPipeline(triage::ImageView::nv21(
+        y_plane, width, height, y_row_stride, vu_plane, vu_row_stride));
+#endif
+
+    return env->NewStringUTF(result_json.c_str());
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_triage_vision_native_NativeBridge_isPersonDetected(
+    JNIEnv *env,
+    jobject thiz,
+    jobject bitmap
+) {
+#ifdef HAVE_NCNN
+    if (g_yolo_detector) {
+        return g_yolo_detector->isPersonDetected() ? JNI_TRUE : JNI_FALSE;
+    }
+#endif
+    return JNI_FALSE;
+}
+
+JNIEXPORT jfloat JNICALL
+Java_com_triage_vision_native_NativeBridge_getMotionLevel(
+    JNIEnv *env,
+    jobject thiz
+) {
+#ifdef HAVE_NCNN
+    if (g_motion_analyzer) {
+        return g_motion_analyzer->getMotionLevel();
+    }
+#endif
+    return 0.0f;
+}
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setMotionHistoryConfig(
+    JNIEnv *env,
+    jobject thiz,
+    jint duration_ms,
+    jint window_frames
+) {
+#ifdef HAVE_NCNN
+    if (g_motion_analyzer) {
+        g_motion_analyzer->setMotionHistoryConfig(duration_ms, window_frames);
+        LOGI("Motion history: %d ms decay, %d frame window", duration_ms, window_frames);
+    }
+#endif
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getMotionFeatures(
+    JNIEnv *env,
+    jobject thiz
+) {
+    std::string result_json = "{}";
+
+#ifdef HAVE_NCNN
+    if (g_motion_analyzer) {
+        auto features = g_motion_analyzer->getMotionFeatures();
+        auto appendHist = [&result_json](const float* hist) {
+            char val_buf[16];
+            result_json += "[";
+            for (int b = 0; b < triage::MotionFeatures::BINS; b++) {
+                snprintf(val_buf, sizeof(val_buf), "%s%.3f", b > 0 ? ", " : "", hist[b]);
+                result_json += val_buf;
+            }
+            result_json += "]";
+        };
+
+        char json_buf[256];
+        snprintf(json_buf, sizeof(json_buf),
+            R"({"frames": %d, "energy": %.3f, "mean_energy": %.3f, "edge_fraction": %.3f, )"
+            R"("centroid_x": %.3f, "centroid_y": %.3f, "energy_hist": )",
+            features.frames,
+            features.energy,
+            features.mean_energy,
+            features.edge_fraction,
+            features.centroid_x,
+            features.centroid_y
+        );
+        result_json = json_buf;
+        appendHist(features.energy_hist);
+        result_json += R"(, "direction_hist": )";
+        appendHist(features.direction_hist);
+        result_json += "}";
+    }
+#endif
+
+    return env->NewStringUTF(result_json.c_str());
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_detectTiled(
+    JNIEnv *env,
+    jobject thiz,
+    jobject bitmap,
+    jfloat overlap
+) {
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS) {
+        LOGE("Failed to get bitmap info");
+        return env->NewStringUTF("{}");
+    }
+
+    void *pixels;
+    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != ANDROID_BITMAP_RESULT_SUCCESS) {
+        LOGE("Failed to lock bitmap pixels");
+        return env->NewStringUTF("{}");
+    }
+
+    std::string json = "{}";
+
+#ifdef HAVE_NCNN
+    const triage::ImageView image = bitmapView(info, pixels);
+    if (g_yolo_detector && !image.empty()) {
+        auto detections = g_yolo_detector->detectTiled(image, overlap);
+        const auto& stats = g_yolo_detector->getLastTiledStats();
+
+        json = "{\"detections\": [";
+        char det_buf[256];
+        for (size_t i = 0; i < detections.size(); i++) {
+            const auto& d = detections[i];
+            snprintf(det_buf, sizeof(det_buf),
+                R"(%s{"class_id": %d, "class_name": "%s", "confidence": %.3f, )"
+                R"("x1": %.1f, "y1": %.1f, "x2": %.1f, "y2": %.1f})",
+                i > 0 ? ", " : "", d.class_id, d.class_name.c_str(), d.confidence,
+                d.x1, d.y1, d.x2, d.y2);
+            json += det_buf;
+        }
+        char stats_buf[384];
+        snprintf(stats_buf, sizeof(stats_buf),
+            R"(], "tiles": %d, "concurrent_tiles": %d, "threads_per_tile": %d, )"
+            R"("total_ms": %.1f, "mean_tile_ms": %.1f, "tiles_per_second": %.2f, )"
+            R"("raw_detections": %d, "merged_detections": %d})",
+            stats.tiles, stats.concurrent_tiles, stats.threads_per_tile,
+            stats.total_ms, stats.mean_tile_ms, stats.tiles_per_second,
+            stats.raw_detections, stats.merged_detections);
+        json += stats_buf;
+    }
+#endif
+
+    AndroidBitmap_unlockPixels(env, bitmap);
+    return env->NewStringUTF(json.c_str());
+}
+
+// ============================================================================
+// Depth-Enhanced Detection
+// ============================================================================
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_detectMotionWithDepth(
+    JNIEnv *env,
+    jobject thiz,
+    jobject bitmap,
+    jshortArray depth_data,
+    jint depth_width,
+    jint depth_height
+) {
+    // Get RGB bitmap info and pixels
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS) {
+        LOGE("Failed to get bitmap info");
+        return env->NewStringUTF(R"({"error": "Failed to get bitmap info"})");
+    }
+
+    void *pixels;
+    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != ANDROID_BITMAP_RESULT_SUCCESS) {
+        LOGE("Failed to lock bitmap pixels");
+        return env->NewStringUTF(R"({"error": "Failed to lock bitmap pixels"})");
+    }
+
+    // Get depth array
+    jshort* depth_ptr = nullptr;
+    if (depth_data != nullptr) {
+        depth_ptr = env->GetShortArrayElements(depth_data, nullptr);
+    }
+
+    // Initialize depth processor if needed
+    if (!g_depth_processor) {
+        g_depth_processor = std::make_unique<triage::DepthProcessor>();
+    }
+
+    // Update depth map if available
+    if (depth_ptr != nullptr && depth_width > 0 && depth_height > 0) {
+        g_depth_processor->updateDepthMap(triage::DepthView::packed(
+            reinterpret_cast<uint16_t*>(depth_ptr), depth_width, depth_height));
+    }
+
+    std::string result_json = "{}";
+#ifdef HAVE_NCNN
+    result_json = runDepthPipeline(bitmapView(info, pixels));
+#endif
+
+    // Cleanup
+    if (depth_ptr != nullptr) {
+        env->ReleaseShortArrayElements(depth_data, depth_ptr, JNI_ABORT);
+    }
+    AndroidBitmap_unlockPixels(env, bitmap);
+
+    return env->NewStringUTF(result_json.c_str());
+}
+
+JNIEXPORT jfloat JNICALL
+Java_com_triage_vision_native_NativeBridge_getDepthAt(
+    JNIEnv *env,
+    jobject thiz,
+    jint x,
+    jint y
+) {
+    if (g_depth_processor) {
+        return g_depth_processor->getDepthAt(x, y);
+    }
+    return -1.0f;
+}
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setDepthConfidenceFloor(
+    JNIEnv *env,
+    jobject thiz,
+    jfloat min_confidence
+) {
+    if (!g_depth_processor) {
+        g_depth_processor = std::make_unique<triage::DepthProcessor>();
+    }
+    g_depth_processor->setConfidenceFloor(min_confidence);
+}
+
+JNIEXPORT jfloat JNICALL
+Java_com_triage_vision_native_NativeBridge_getAverageDistance(
+    JNIEnv *env,
+    jobject thiz
+) {
+    if (g_depth_processor) {
+        return g_depth_processor->getAverageDistance();
+    }
+    return 0.0f;
+}
+
+// ============================================================================
+// Native RGB-Depth Synchronization
+// ============================================================================
+
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_initFrameSync(
+    JNIEnv *env,
+    jobject thiz,
+    jfloat tolerance_ms,
+    jint capacity
+) {
+    std::lock_guard<std::mutex> lock(g_frame_sync_mutex);
+    if (!g_frame_sync) {
+        g_frame_sync = std::make_unique<triage::FrameSynchronizer>();
+    }
+    g_frame_sync->init(static_cast<int64_t>(tolerance_ms * 1e6f), capacity);
+    LOGI("Frame sync initialized: tolerance=%.1fms, capacity=%d", tolerance_ms, capacity);
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_submitSyncRgbFrame(
+    JNIEnv *env,
+    jobject thiz,
+    jobject bitmap,
+    jlong timestamp_ns
+) {
+    AndroidBitmapInfo info;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS) {
+        LOGE("Failed to get bitmap info");
+        return env->NewStringUTF(R"({"synced": false})");
+    }
+    if (info.format != ANDROID_BITMAP_FORMAT_RGBA_8888) {
+        LOGE("Frame sync needs an RGBA_8888 bitmap");
+        return env->NewStringUTF(R"({"synced": false})");
+    }
+
+    void *pixels;
+    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != ANDROID_BITMAP_RESULT_SUCCESS) {
+        LOGE("Failed to lock bitmap pixels");
+        return env->NewStringUTF(R"({"synced": false})");
+    }
+
+    std::string result_json = R"({"synced": false})";
+    bool matched = false;
+    {
+        std::lock_guard<std::mutex> lock(g_frame_sync_mutex);
+        if (!g_frame_sync) {
+            g_frame_sync = std::make_unique<triage::FrameSynchronizer>();
+        }
+
+        triage::SyncedPair pair;
+        if (g_frame_sync->submitRgb(static_cast<uint8_t*>(pixels), info.width, info.height,
+                                    info.stride, timestamp_ns, pair)) {
+            // The depth side lives in the synchronizer: copy it out so the
+            // depth thread is not blocked while the pipeline runs
+            g_running_pair.assign(pair, static_cast<const uint8_t*>(pixels));
+            matched = true;
+        }
+    }
+    if (matched) {
+        result_json = processSyncedPair(g_running_pair.pair);
+    }
+
+    AndroidBitmap_unlockPixels(env, bitmap);
+
+    return env->NewStringUTF(result_json.c_str());
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_submitSyncDepthFrame(
+    JNIEnv *env,
+    jobject thiz,
+    jobject depth_buffer,
+    jint width,
+    jint height,
+    jint row_stride,
+    jlong timestamp_ns
+) {
+    // Direct buffer from the Image plane - read in place, no JVM copy
+    auto* depth = static_cast<uint16_t*>(env->GetDirectBufferAddress(depth_buffer));
+    if (depth == nullptr) {
+        LOGE("Depth buffer is not a direct buffer");
+        return env->NewStringUTF(R"({"synced": false})");
+    }
+    if (width <= 0 || height <= 0 || row_stride < width * 2 ||
+        env->GetDirectBufferCapacity(depth_buffer) <
+            static_cast<jlong>(height - 1) * row_stride + static_cast<jlong>(width) * 2) {
+        LOGE("Invalid depth frame %dx%d (stride %d)", width, height, row_stride);
+        return env->NewStringUTF(R"({"synced": false})");
+    }
+
+    bool pending = false;
+    {
+        std::lock_guard<std::mutex> lock(g_frame_sync_mutex);
+        if (!g_frame_sync) {
+            g_frame_sync = std::make_unique<triage::FrameSynchronizer>();
+        }
+
+        // A completed pair is copied out (the Image closes after this call)
+        // and left for the frame thread; an unclaimed older pair is replaced
+        triage::SyncedPair pair;
+        if (g_frame_sync->submitDepth(depth, width, height, row_stride, timestamp_ns, pair)) {
+            g_pending_pair.assign(pair);
+            g_has_pending_pair = true;
+            pending = true;
+        }
+    }
+
+    return env->NewStringUTF(pending ? R"({"synced": false, "pair_pending": true})"
+                                     : R"({"synced": false})");
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_processPendingSyncPair(
+    JNIEnv *env,
+    jobject thiz
+) {
+    {
+        std::lock_guard<std::mutex> lock(g_frame_sync_mutex);
+        if (!g_has_pending_pair) {
+            return env->NewStringUTF(R"({"synced": false})");
+        }
+        std::swap(g_running_pair, g_pending_pair);
+        g_has_pending_pair = false;
+    }
+
+    std::string result_json = processSyncedPair(g_running_pair.pair);
+    return env->NewStringUTF(result_json.c_str());
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getFrameSyncStats(
+    JNIEnv *env,
+    jobject thiz
+) {
+    triage::SyncStats stats = {};
+    {
+        std::lock_guard<std::mutex> lock(g_frame_sync_mutex);
+        if (g_frame_sync) {
+            stats = g_frame_sync->getStats();
+        }
+    }
+
+    char json_buf[512];
+    snprintf(json_buf, sizeof(json_buf),
+        R"({"rgb_frames": %llu, "depth_frames": %llu, "synced_pairs": %llu, )"
+        R"("dropped_rgb": %llu, "dropped_depth": %llu, "mean_delta_ms": %.2f, )"
+        R"("rgb_buffered": %d, "depth_buffered": %d})",
+        (unsigned long long)stats.rgb_frames,
+        (unsigned long long)stats.depth_frames,
+        (unsigned long long)stats.synced_pairs,
+        (unsigned long long)stats.dropped_rgb,
+        (unsigned long long)stats.dropped_depth,
+        stats.mean_delta_ms,
+        stats.rgb_buffered,
+        stats.depth_buffered
+    );
+
+    return env->NewStringUTF(json_buf);
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getRepositionEvents(
+    JNIEnv *env,
+    jobject thiz
+) {
+    std::string result = "[]";
+
+#ifdef HAVE_NCNN
+    if (g_reposition_tracker) {
+        result = "[";
+        char json_buf[256];
+        auto events = g_reposition_tracker->getRecentEvents();
+        for (size_t i = 0; i < events.size(); i++) {
+            const auto& e = events[i];
+            snprintf(json_buf, sizeof(json_buf),
+                R"(%s{"timestamp_ms": %lld, "held_seconds": %lld, "from_pose": %d, "to_pose": %d, )"
+                R"("from_orientation": %d, "to_orientation": %d, "reasons": %d})",
+                i > 0 ? ", " : "",
+                (long long)e.timestamp_ms, (long long)(e.held_ms / 1000),
+                static_cast<int>(e.from_pose), static_cast<int>(e.to_pose),
+                static_cast<int>(e.from_orientation), static_cast<int>(e.to_orientation),
+                e.reasons
+            );
+            result += json_buf;
+        }
+        result += "]";
+    }
+#endif
+
+    return env->NewStringUTF(result.c_str());
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getSleepSummary(
+    JNIEnv *env,
+    jobject thiz
+) {
+    std::string result = "{}";
 
-    // Actual asset filenames (both model and mmproj required for vision)
-    std::string vlm_path = g_model_path + "/SmolVLM-500M-Instruct-Q8_0.gguf";
-    std::string mmproj_path = g_model_path + "/mmproj-SmolVLM-500M-Instruct-Q8_0.gguf";
+#ifdef HAVE_NCNN
+    if (g_sleep_estimator) {
+        char json_buf[512];
+        snprintf(json_buf, sizeof(json_buf),
+            R"({"state": %d, "minutes_in_state": %.1f, "activity_level": %.3f, )"
+            R"("sleep_minutes": %.1f, "wake_minutes": %.1f, "restless_minutes": %.1f, "epochs": [)",
+            static_cast<int>(g_sleep_estimator->getState()),
+            g_sleep_estimator->getMsInState(wallClockMs()) / 60000.0f,
+            g_sleep_estimator->getActivityLevel(),
+            g_sleep_estimator->getSleepMinutes(),
+            g_sleep_estimator->getWakeMinutes(),
+            g_sleep_estimator->getRestlessMinutes()
+        );
+        result = json_buf;
 
-    g_vlm = std::make_unique<triage::VLMInference>();
-    if (!g_vlm->init(vlm_path, mmproj_path, 4, 0)) {
-        LOGE("Failed to initialize VLM from: %s", vlm_path.c_str());
-        // Don't fail completely - VLM is optional
-    } else {
-        LOGI("VLM initialized successfully from: %s", vlm_path.c_str());
+        auto epochs = g_sleep_estimator->getRecentEpochs();
+        for (size_t i = 0; i < epochs.size(); i++) {
+            const auto& e = epochs[i];
+            snprintf(json_buf, sizeof(json_buf),
+                R"(%s{"start_ms": %lld, "count": %.1f, "score": %.2f, "state": %d})",
+                i > 0 ? ", " : "",
+                (long long)e.start_ms, e.activity_count, e.score, static_cast<int>(e.state)
+            );
+            result += json_buf;
+        }
+        result += "]}";
     }
-
-#else
-    LOGI("llama.cpp support not available - slow pipeline disabled");
 #endif
 
-    g_initialized = (result == 0);
-    env->ReleaseStringUTFChars(model_path, path);
-    return result;
+    return env->NewStringUTF(result.c_str());
 }
 
 // ============================================================================
-// Fast Pipeline - Motion/Pose Detection
+// Multi-Camera Sessions
 // ============================================================================
 
-JNIEXPORT jstring JNICALL
-Java_com_triage_vision_native_NativeBridge_detectMotion(
+#ifdef HAVE_NCNN
+static std::string sessionResultJson(const triage::SessionResult& r) {
+    char json_buf[768];
+    snprintf(json_buf, sizeof(json_buf),
+        R"({"session_id": %d, "timestamp_ms": %lld, "person_detected": %s, "pose": %d, )"
+        R"("motion_level": %.3f, "fall_detected": %s, "seconds_since_motion": %lld, )"
+        R"("detection_count": %zu, "inference_ms": %.1f, )"
+        R"("depth_available": %s, "depth_fall": %s, "fall_confidence": %.2f, )"
+        R"("vertical_drop_meters": %.3f, "distance_meters": %.2f, "depth_motion_level": %.3f})",
+        r.session_id, (long long)r.timestamp_ms,
+        r.person_detected ? "true" : "false",
+        static_cast<int>(r.pose),
+        r.motion_level,
+        r.fall_detected ? "true" : "false",
+        (long long)r.seconds_since_motion,
+        r.detection_count,
+        r.inference_ms,
+        r.depth_available ? "true" : "false",
+        r.depth_fall ? "true" : "false",
+        r.fall_confidence,
+        r.vertical_drop_meters,
+        r.distance_meters,
+        r.depth_motion_level
+    );
+    return json_buf;
+}
+#endif
+
+JNIEXPORT jint JNICALL
+Java_com_triage_vision_native_NativeBridge_createSession(
     JNIEnv *env,
     jobject thiz,
-    jobject bitmap
+    jstring name,
+    jint priority
 ) {
-    // Get bitmap info
-    AndroidBitmapInfo info;
-    if (AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS) {
-        LOGE("Failed to get bitmap info");
-        return env->NewStringUTF("{}");
-    }
+    int session_id = -1;
 
-    // Lock pixels
-    void *pixels;
-    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != ANDROID_BITMAP_RESULT_SUCCESS) {
-        LOGE("Failed to lock bitmap pixels");
-        return env->NewStringUTF("{}");
+#ifdef HAVE_NCNN
+    if (!g_session_manager) {
+        g_session_manager = std::make_unique<triage::SessionManager>();
+        if (!g_session_manager->init(g_yolo_model)) {
+            g_session_manager.reset();
+            return -1;
+        }
     }
 
-    std::string result_json = "{}";
+    const char *name_str = env->GetStringUTFChars(name, nullptr);
+    session_id = g_session_manager->addSession(name_str, priority);
+    env->ReleaseStringUTFChars(name, name_str);
+#endif
 
-#ifdef HAVE_NCNN
-    if (g_yolo_detector && g_motion_analyzer && g_pose_estimator) {
-        // Run YOLO detection
-        auto detections = g_yolo_detector->detect(
-            static_cast<uint8_t*>(pixels), info.width, info.height);
+    return session_id;
+}
 
-        // Analyze motion
-        auto motion_state = g_motion_analyzer->analyze(
-            static_cast<uint8_t*>(pixels), info.width, info.height);
+JNIEXPORT jboolean JNICALL
+Java_com_triage_vision_native_NativeBridge_submitSessionFrame(
+    JNIEnv *env,
+    jobject thiz,
+    jint session_id,
+    jobject bitmap,
+    jlong timestamp_ms
+) {
+    bool ok = false;
 
-        // Update pose estimator
-        g_pose_estimator->update(detections);
+#ifdef HAVE_NCNN
+    if (!g_session_manager) {
+        return JNI_FALSE;
+    }
 
-        // Build JSON result
-        char json_buf[1024];
-        snprintf(json_buf, sizeof(json_buf),
-            R"({"person_detected": %s, "pose": %d, "motion_level": %.3f, )"
-            R"("fall_detected": %s, "seconds_since_motion": %lld, "detection_count": %zu})",
-            g_yolo_detector->isPersonDetected() ? "true" : "false",
-            static_cast<int>(g_pose_estimator->getCurrentPose()),
-            motion_state.motion_level,
-            g_yolo_detector->isFallDetected() ? "true" : "false",
-            (long long)g_motion_analyzer->getSecondsSinceMotion(),
-            detections.size()
-        );
-        result_json = json_buf;
+    AndroidBitmapInfo info;
+    void *pixels;
+    if (AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS ||
+        AndroidBitmap_lockPixels(env, bitmap, &pixels) != ANDROID_BITMAP_RESULT_SUCCESS) {
+        LOGE("Failed to access session bitmap");
+        return JNI_FALSE;
     }
-#endif
 
-    // Unlock pixels
+    ok = g_session_manager->submitFrame(session_id, bitmapView(info, pixels), timestamp_ms);
+
     AndroidBitmap_unlockPixels(env, bitmap);
+#endif
 
-    return env->NewStringUTF(result_json.c_str());
+    return ok ? JNI_TRUE : JNI_FALSE;
 }
 
 JNIEXPORT jboolean JNICALL
-Java_com_triage_vision_native_NativeBridge_isPersonDetected(
+Java_com_triage_vision_native_NativeBridge_submitSessionDepth(
     JNIEnv *env,
     jobject thiz,
-    jobject bitmap
+    jint session_id,
+    jshortArray depth_data,
+    jint depth_width,
+    jint depth_height
 ) {
+    bool ok = false;
+
 #ifdef HAVE_NCNN
-    if (g_yolo_detector) {
-        return g_yolo_detector->isPersonDetected() ? JNI_TRUE : JNI_FALSE;
+    if (!g_session_manager || depth_data == nullptr) {
+        return JNI_FALSE;
     }
+
+    jshort* depth_ptr = env->GetShortArrayElements(depth_data, nullptr);
+    ok = g_session_manager->submitDepth(session_id, triage::DepthView::packed(
+        reinterpret_cast<uint16_t*>(depth_ptr), depth_width, depth_height));
+    env->ReleaseShortArrayElements(depth_data, depth_ptr, JNI_ABORT);
 #endif
-    return JNI_FALSE;
+
+    return ok ? JNI_TRUE : JNI_FALSE;
 }
 
-JNIEXPORT jfloat JNICALL
-Java_com_triage_vision_native_NativeBridge_getMotionLevel(
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_runSessionInference(
     JNIEnv *env,
     jobject thiz
 ) {
 #ifdef HAVE_NCNN
-    if (g_motion_analyzer) {
-        return g_motion_analyzer->getMotionLevel();
+    triage::SessionResult result;
+    if (g_session_manager && g_session_manager->runNext(result)) {
+        return env->NewStringUTF(sessionResultJson(result).c_str());
     }
 #endif
-    return 0.0f;
+    return env->NewStringUTF("{}");
 }
 
-// ============================================================================
-// Depth-Enhanced Detection
-// ============================================================================
-
 JNIEXPORT jstring JNICALL
-Java_com_triage_vision_native_NativeBridge_detectMotionWithDepth(
+Java_com_triage_vision_native_NativeBridge_runSessionBatch(
     JNIEnv *env,
     jobject thiz,
-    jobject bitmap,
-    jshortArray depth_data,
-    jint depth_width,
-    jint depth_height
+    jint max_streams
 ) {
-    // Get RGB bitmap info and pixels
-    AndroidBitmapInfo info;
-    if (AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS) {
-        LOGE("Failed to get bitmap info");
-        return env->NewStringUTF(R"({"error": "Failed to get bitmap info"})");
-    }
-
-    void *pixels;
-    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != ANDROID_BITMAP_RESULT_SUCCESS) {
-        LOGE("Failed to lock bitmap pixels");
-        return env->NewStringUTF(R"({"error": "Failed to lock bitmap pixels"})");
+#ifdef HAVE_NCNN
+    std::vector<triage::SessionResult> results;
+    if (g_session_manager && g_session_manager->runBatch(max_streams, results) > 0) {
+        std::string json = "{\"results\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            if (i > 0) json += ", ";
+            json += sessionResultJson(results[i]);
+        }
+        char tail[64];
+        snprintf(tail, sizeof(tail), R"(], "aggregate_fps": %.1f})",
+                 g_session_manager->getAggregateFps());
+        json += tail;
+        return env->NewStringUTF(json.c_str());
     }
+#endif
+    return env->NewStringUTF(R"({"results": []})");
+}
 
-    // Get depth array
-    jshort* depth_ptr = nullptr;
-    if (depth_data != nullptr) {
-        depth_ptr = env->GetShortArrayElements(depth_data, nullptr);
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getSessionResult(
+    JNIEnv *env,
+    jobject thiz,
+    jint session_id
+) {
+#ifdef HAVE_NCNN
+    triage::SessionResult result;
+    if (g_session_manager && g_session_manager->getResult(session_id, result)) {
+        return env->NewStringUTF(sessionResultJson(result).c_str());
     }
+#endif
+    return env->NewStringUTF("{}");
+}
 
-    // Initialize depth processor if needed
-    if (!g_depth_processor) {
-        g_depth_processor = std::make_unique<triage::DepthProcessor>();
+JNIEXPORT void JNICALL
+Java_com_triage_vision_native_NativeBridge_setSessionScheduling(
+    JNIEnv *env,
+    jobject thiz,
+    jint policy
+) {
+#ifdef HAVE_NCNN
+    if (g_session_manager) {
+        g_session_manager->setPolicy(policy == 1 ? triage::SchedulingPolicy::PRIORITY
+                                                 : triage::SchedulingPolicy::ROUND_ROBIN);
     }
+#endif
+}
 
-    // Update depth map if available
-    if (depth_ptr != nullptr && depth_width > 0 && depth_height > 0) {
-        g_depth_processor->updateDepthMap(
-            reinterpret_cast<uint16_t*>(depth_ptr),
-            depth_width,
-            depth_height
-        );
+JNIEXPORT jboolean JNICALL
+Java_com_triage_vision_native_NativeBridge_setSessionPriority(
+    JNIEnv *env,
+    jobject thiz,
+    jint session_id,
+    jint priority
+) {
+#ifdef HAVE_NCNN
+    if (g_session_manager) {
+        return g_session_manager->setPriority(session_id, priority) ? JNI_TRUE : JNI_FALSE;
     }
+#endif
+    return JNI_FALSE;
+}
 
-    std::string result_json = "{}";
-
+JNIEXPORT jboolean JNICALL
+Java_com_triage_vision_native_NativeBridge_destroySession(
+    JNIEnv *env,
+    jobject thiz,
+    jint session_id
+) {
 #ifdef HAVE_NCNN
-    if (g_yolo_detector && g_motion_analyzer && g_pose_estimator) {
-        // Run YOLO detection on RGB
-        auto detections = g_yolo_detector->detect(
-            static_cast<uint8_t*>(pixels), info.width, info.height);
-
-        // Analyze RGB motion
-        auto motion_state = g_motion_analyzer->analyze(
-            static_cast<uint8_t*>(pixels), info.width, info.height);
-
-        // Update pose estimator
-        g_pose_estimator->update(detections);
-
-        // Depth-enhanced analysis
-        float distance_meters = 0.0f;
-        float depth_motion_level = 0.0f;
-        bool depth_fall = false;
-        float vertical_drop = 0.0f;
-        float fall_confidence = 0.0f;
-        float bed_proximity = 0.0f;
-        bool in_bed_zone = false;
-        float pos_x = 0.0f, pos_y = 0.0f, pos_z = 0.0f;
+    if (g_session_manager) {
+        return g_session_manager->removeSession(session_id) ? JNI_TRUE : JNI_FALSE;
+    }
+#endif
+    return JNI_FALSE;
+}
 
-        if (g_depth_processor->hasDepthData() && !detections.empty()) {
-            // Get person bounding box (use first detection)
-            auto& det = detections[0];
-            triage::BoundingBox person_bbox = {
-                det.x1 / static_cast<float>(info.width),
-                det.y1 / static_cast<float>(info.height),
-                (det.x2 - det.x1) / static_cast<float>(info.width),
-                (det.y2 - det.y1) / static_cast<float>(info.height)
-            };
-
-            // Fall detection with depth
-            auto fall_result = g_depth_processor->detectFall(
-                person_bbox, info.width, info.height);
-            depth_fall = fall_result.fall_detected;
-            vertical_drop = fall_result.vertical_drop_meters;
-            fall_confidence = fall_result.confidence;
-
-            // Motion analysis with depth
-            auto motion_result = g_depth_processor->analyzeMotion(
-                person_bbox, info.width, info.height);
-            distance_meters = motion_result.distance_meters;
-            depth_motion_level = motion_result.depth_motion_level;
-            bed_proximity = motion_result.bed_proximity_meters;
-            in_bed_zone = motion_result.in_bed_zone;
-            pos_x = motion_result.position_3d.x;
-            pos_y = motion_result.position_3d.y;
-            pos_z = motion_result.position_3d.z;
-        }
+// ============================================================================
+// Telemetry Log
+// ============================================================================
 
-        // Combined fall detection (2D + depth)
-        bool combined_fall = g_yolo_detector->isFallDetected() || depth_fall;
+JNIEXPORT jboolean JNICALL
+Java_com_triage_vision_native_NativeBridge_openTelemetryLog(
+    JNIEnv *env,
+    jobject thiz,
+    jstring directory
+) {
+    const char *dir = env->GetStringUTFChars(directory, nullptr);
 
-        // Build JSON result with depth metrics
-        char json_buf[2048];
-        snprintf(json_buf, sizeof(json_buf),
-            R"({)"
-            R"("person_detected": %s, )"
-            R"("pose": %d, )"
-            R"("motion_level": %.3f, )"
-            R"("fall_detected": %s, )"
-            R"("depth_fall": %s, )"
-            R"("vertical_drop_meters": %.3f, )"
-            R"("fall_confidence": %.2f, )"
-            R"("seconds_since_motion": %lld, )"
-            R"("detection_count": %zu, )"
-            R"("distance_meters": %.2f, )"
-            R"("depth_motion_level": %.3f, )"
-            R"("bed_proximity_meters": %.2f, )"
-            R"("in_bed_zone": %s, )"
-            R"("position_3d": {"x": %.3f, "y": %.3f, "z": %.3f}, )"
-            R"("depth_available": %s)"
-            R"(})",
-            g_yolo_detector->isPersonDetected() ? "true" : "false",
-            static_cast<int>(g_pose_estimator->getCurrentPose()),
-            motion_state.motion_level,
-            combined_fall ? "true" : "false",
-            depth_fall ? "true" : "false",
-            vertical_drop,
-            fall_confidence,
-            (long long)g_motion_analyzer->getSecondsSinceMotion(),
-            detections.size(),
-            distance_meters,
-            depth_motion_level,
-            bed_proximity,
-            in_bed_zone ? "true" : "false",
-            pos_x, pos_y, pos_z,
-            g_depth_processor->hasDepthData() ? "true" : "false"
-        );
-        result_json = json_buf;
+    if (!g_telemetry_log) {
+        g_telemetry_log = std::make_unique<triage::TelemetryLog>();
     }
-#endif
-
-    // Cleanup
-    if (depth_ptr != nullptr) {
-        env->ReleaseShortArrayElements(depth_data, depth_ptr, JNI_ABORT);
+    bool ok = g_telemetry_log->open(dir);
+    if (ok) {
+        LOGI("Telemetry log open at %s (recovered %u records)",
+             dir, g_telemetry_log->getRecoveredCount());
+    } else {
+        LOGE("Failed to open telemetry log at %s", dir);
     }
-    AndroidBitmap_unlockPixels(env, bitmap);
 
-    return env->NewStringUTF(result_json.c_str());
+    env->ReleaseStringUTFChars(directory, dir);
+    return ok ? JNI_TRUE : JNI_FALSE;
 }
 
-JNIEXPORT jfloat JNICALL
-Java_com_triage_vision_native_NativeBridge_getDepthAt(
+JNIEXPORT jstring JNICALL
+Java_com_triage_vision_native_NativeBridge_getTelemetrySummary(
     JNIEnv *env,
     jobject thiz,
-    jint x,
-    jint y
+    jlong from_ms,
+    jlong to_ms,
+    jlong bucket_ms
 ) {
-    if (g_depth_processor) {
-        return g_depth_processor->getDepthAt(x, y);
+    if (!g_telemetry_log || !g_telemetry_log->isOpen()) {
+        return env->NewStringUTF("[]");
     }
-    return -1.0f;
-}
 
-JNIEXPORT jfloat JNICALL
-Java_com_triage_vision_native_NativeBridge_getAverageDistance(
-    JNIEnv *env,
-    jobject thiz
-) {
-    if (g_depth_processor) {
-        return g_depth_processor->getAverageDistance();
+    auto buckets = g_telemetry_log->summarize(from_ms, to_ms, bucket_ms);
+
+    std::string result = "[";
+    char json_buf[512];
+    for (size_t i = 0; i < buckets.size(); i++) {
+        const auto& b = buckets[i];
+        snprintf(json_buf, sizeof(json_buf),
+            R"(%s{"start_ms": %lld, "samples": %d, "mean_motion": %.3f, "max_motion": %.3f, )"
+            R"("mean_distance": %.2f, "pose_counts": [%d, %d, %d, %d, %d], )"
+            R"("fall_events": %d, "person_present": %d})",
+            i > 0 ? ", " : "",
+            (long long)b.start_ms, b.samples, b.mean_motion, b.max_motion,
+            b.mean_distance,
+            b.pose_counts[0], b.pose_counts[1], b.pose_counts[2], b.pose_counts[3], b.pose_counts[4],
+            b.fall_events, b.person_present
+        );
+        result += json_buf;
     }
-    return 0.0f;
+    result += "]";
+
+    return env->NewStringUTF(result.c_str());
 }
 
 // ============================================================================
@@ -404,8 +1948,7 @@ Java_com_triage_vision_native_NativeBridge_analyzeScene(
 
 #ifdef HAVE_LLAMA
     if (g_vlm && g_vlm->isInitialized()) {
-        auto observation = g_vlm->analyze(
-            static_cast<uint8_t*>(pixels), info.width, info.height, prompt_str);
+        auto observation = g_vlm->analyze(bitmapView(info, pixels), prompt_str);
 
         // Build JSON result
         char json_buf[4096];
@@ -467,12 +2010,21 @@ Java_com_triage_vision_native_NativeBridge_cleanup(
     LOGI("Cleaning up native resources");
 
 #ifdef HAVE_NCNN
+    if (g_session_manager) {
+        g_session_manager->cleanup();
+        g_session_manager.reset();
+    }
     if (g_yolo_detector) {
         g_yolo_detector->cleanup();
         g_yolo_detector.reset();
     }
+    g_bed_region_revision = 0;
+    g_yolo_model.reset();
     g_motion_analyzer.reset();
     g_pose_estimator.reset();
+    g_reposition_tracker.reset();
+    g_sleep_estimator.reset();
+    g_scene_detector.reset();
 #endif
 
 #ifdef HAVE_LLAMA
@@ -482,12 +2034,25 @@ Java_com_triage_vision_native_NativeBridge_cleanup(
     }
 #endif
 
+    // Cleanup frame synchronizer
+    {
+        std::lock_guard<std::mutex> lock(g_frame_sync_mutex);
+        g_frame_sync.reset();
+        g_has_pending_pair = false;
+    }
+
     // Cleanup depth processor
     if (g_depth_processor) {
         g_depth_processor->reset();
         g_depth_processor.reset();
     }
 
+    // Flush and close telemetry log
+    if (g_telemetry_log) {
+        g_telemetry_log->close();
+        g_telemetry_log.reset();
+    }
+
     g_initialized = false;
     LOGI("Native cleanup complete");
 }
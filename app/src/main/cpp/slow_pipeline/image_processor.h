@@ -3,40 +3,42 @@
 #include <cstdint>
 #include <vector>
 
+#include "../fast_pipeline/image_view.h"
+
 namespace triage {
 
 /**
  * Image preprocessing utilities for VLM inference
+ *
+ * Inputs are views (any row stride, any PixelFormat); outputs are packed
+ * RGB buffers.
  */
 class ImageProcessor {
 public:
     /**
      * Resize image using bilinear interpolation
      */
-    static std::vector<uint8_t> resize(const uint8_t* src, int src_width, int src_height,
-                                        int dst_width, int dst_height, int channels = 4);
+    static std::vector<uint8_t> resize(const ImageView& src, int dst_width, int dst_height);
 
     /**
-     * Convert RGBA to RGB
+     * Convert any pixel format to packed RGB
      */
-    static std::vector<uint8_t> rgbaToRgb(const uint8_t* rgba, int width, int height);
+    static std::vector<uint8_t> rgbaToRgb(const ImageView& src);
 
     /**
-     * Normalize image to float [0, 1]
+     * Normalize image to float [0, 1], RGB out
      */
-    static std::vector<float> normalizeToFloat(const uint8_t* src, int width, int height,
-                                                int channels = 3);
+    static std::vector<float> normalizeToFloat(const ImageView& src);
 
     /**
-     * Apply ImageNet normalization (mean subtract, std divide)
+     * Apply ImageNet normalization (mean subtract, std divide), RGB out
      */
-    static std::vector<float> normalizeImageNet(const uint8_t* src, int width, int height);
+    static std::vector<float> normalizeImageNet(const ImageView& src);
 
     /**
-     * Center crop image
+     * Center crop image (sub-view, no copy)
      */
-    static std::vector<uint8_t> centerCrop(const uint8_t* src, int src_width, int src_height,
-                                            int crop_size, int channels = 4);
+    static ImageView centerCrop(const ImageView& src, int crop_size);
 
     /**
      * Convert grayscale to RGB
@@ -1,4 +1,6 @@
 #include "vlm_inference.h"
+#include "image_processor.h"
+#include "../fast_pipeline/thread_pool.h"
 #include <android/log.h>
 #include <sstream>
 #include <cstring>
@@ -122,8 +124,7 @@ bool VLMInference::init(const std::string& model_path,
 #endif
 }
 
-VLMObservation VLMInference::analyze(const uint8_t* pixels, int width, int height,
-                                      const std::string& prompt) {
+VLMObservation VLMInference::analyze(const ImageView& image, const std::string& prompt) {
     VLMObservation result;
     result.success = false;
 
@@ -133,13 +134,25 @@ VLMObservation VLMInference::analyze(const uint8_t* pixels, int width, int heigh
         return result;
     }
 
-    LOGI("Running VLM analysis (%dx%d)", width, height);
+    LOGI("Running VLM analysis (%dx%d)", image.width, image.height);
+
+    const int requested = requested_threads_.exchange(0);
+    if (requested > 0 && requested != n_threads_) {
+        llama_set_n_threads(llama_ctx_, requested, requested);
+        LOGI("VLM threads %d -> %d", n_threads_, requested);
+        n_threads_ = requested;
+    }
+
+    // Image conversion queues behind fast pipeline work on the shared
+    // pool, and the pool leaves llama.cpp's threads their cores
+    ThreadPool::PriorityScope slow(TaskPriority::SLOW);
+    ThreadPool::ExternalThreads llama_threads(n_threads_);
 
     std::string response;
 
 #ifdef HAVE_MTMD
-    if (vision_enabled_ && pixels != nullptr && width > 0 && height > 0) {
-        response = generateResponseWithImage(pixels, width, height, prompt);
+    if (vision_enabled_ && !image.empty()) {
+        response = generateResponseWithImage(image, prompt);
     } else {
         response = generateResponseTextOnly(prompt);
     }
@@ -174,23 +187,27 @@ VLMObservation VLMInference::analyze(const uint8_t* pixels, int width, int heigh
 }
 
 #ifdef HAVE_MTMD
-std::string VLMInference::generateResponseWithImage(const uint8_t* pixels, int width, int height,
+std::string VLMInference::generateResponseWithImage(const ImageView& image,
                                                      const std::string& prompt) {
     std::string response;
 
-    LOGI("Generating response with image (%dx%d)", width, height);
-
-    // Convert RGBA to RGB (mtmd expects RGB)
-    std::vector<unsigned char> rgb_data(width * height * 3);
-    for (int i = 0; i < width * height; i++) {
-        rgb_data[i * 3 + 0] = pixels[i * 4 + 0]; // R
-        rgb_data[i * 3 + 1] = pixels[i * 4 + 1]; // G
-        rgb_data[i * 3 + 2] = pixels[i * 4 + 2]; // B
-        // Alpha (pixels[i * 4 + 3]) is discarded
+    LOGI("Generating response with image (%dx%d)", image.width, image.height);
+
+    // mtmd expects packed RGB; a packed RGB view goes in as is, anything
+    // else (other pixel formats, row padding, crop) is converted row by row
+    std::vector<unsigned char> rgb_data;
+    const unsigned char* rgb = image.data;
+    if (image.format != PixelFormat::RGB_888 || !image.isPacked()) {
+        rgb_data = ImageProcessor::rgbaToRgb(image);
+        if (rgb_data.empty()) {
+            LOGE("Unsupported image format %d", static_cast<int>(image.format));
+            return "";
+        }
+        rgb = rgb_data.data();
     }
 
     // Create bitmap from RGB data
-    mtmd_bitmap* bitmap = mtmd_bitmap_init(width, height, rgb_data.data());
+    mtmd_bitmap* bitmap = mtmd_bitmap_init(image.width, image.height, rgb);
     if (!bitmap) {
         LOGE("Failed to create mtmd bitmap");
         return "";
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
 
+#include "../fast_pipeline/image_view.h"
+
 #ifdef HAVE_LLAMA
 #include <llama.h>
 #endif
@@ -47,14 +50,19 @@ public:
 
     /**
      * Run inference on an image
-     * @param pixels RGBA pixel data
-     * @param width Image width
-     * @param height Image height
+     * @param image View in any PixelFormat (any row stride, may be a crop);
+     *        an empty view runs text-only
      * @param prompt Analysis prompt
      * @return Observation result
      */
-    VLMObservation analyze(const uint8_t* pixels, int width, int height,
-                           const std::string& prompt);
+    VLMObservation analyze(const ImageView& image, const std::string& prompt);
+
+    /**
+     * CPU threads for the next analysis (safe to call while one runs;
+     * the mtmd image encoder keeps the count given to init)
+     */
+    void setThreadCount(int n_threads) { requested_threads_ = n_threads; }
+    int getThreadCount() const { return n_threads_; }
 
     /**
      * Check if model is loaded
@@ -90,12 +98,12 @@ private:
 #endif
 
     int n_threads_ = 4;
+    std::atomic<int> requested_threads_{0};   // 0 = keep n_threads_
     int n_ctx_ = 2048;
     int max_tokens_ = 512;
     int n_batch_ = 512;
 
-    std::string generateResponseWithImage(const uint8_t* pixels, int width, int height,
-                                           const std::string& prompt);
+    std::string generateResponseWithImage(const ImageView& image, const std::string& prompt);
     std::string generateResponseTextOnly(const std::string& prompt);
     VLMObservation parseResponse(const std::string& response);
 };
@@ -0,0 +1,512 @@
+#include "telemetry_log.h"
+#include <android/log.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+#define LOG_TAG "TelemetryLog"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace triage {
+
+namespace {
+
+constexpr char SEGMENT_MAGIC[4] = {'T', 'V', 'L', 'G'};
+
+// Byte-wise CRC32C table (reflected polynomial 0x82F63B78)
+constexpr std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : (crc >> 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint32_t, 256> CRC_TABLE = makeCrcTable();
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+uint32_t TelemetryLog::crc32c(const void* data, size_t length) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint32_t crc = 0xFFFFFFFFu;
+
+#if defined(__ARM_FEATURE_CRC32)
+    // Hardware CRC32C - 8 bytes per instruction
+    while (length >= 8) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        crc = __crc32cd(crc, v);
+        p += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = __crc32cb(crc, *p++);
+    }
+#else
+    while (length-- > 0) {
+        crc = CRC_TABLE[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+#endif
+
+    return crc ^ 0xFFFFFFFFu;
+}
+
+TelemetryLog::TelemetryLog() = default;
+
+TelemetryLog::~TelemetryLog() {
+    close();
+}
+
+bool TelemetryLog::open(const std::string& directory,
+                        uint32_t records_per_segment,
+                        int max_segments) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (active_map_ != nullptr) {
+        LOGW("Telemetry log already open at %s", directory_.c_str());
+        return true;
+    }
+
+    directory_ = directory;
+    capacity_ = std::max<uint32_t>(records_per_segment, 1);
+    max_segments_ = std::max(max_segments, 1);
+
+    if (mkdir(directory_.c_str(), 0700) != 0 && errno != EEXIST) {
+        LOGE("Failed to create telemetry directory: %s", directory_.c_str());
+        return false;
+    }
+
+    std::vector<uint32_t> segments = listSegments();
+    if (segments.empty()) {
+        next_sequence_ = 0;
+        if (!openSegment(0, true)) {
+            return false;
+        }
+        recovered_count_ = 0;
+        LOGI("Created telemetry log at %s", directory_.c_str());
+        return true;
+    }
+
+    // Resume in the newest segment
+    if (!openSegment(segments.back(), false)) {
+        // Unreadable newest segment - start a fresh one after it
+        LOGW("Newest segment unreadable, starting segment %u", segments.back() + 1);
+        if (!openSegment(segments.back() + 1, true)) {
+            return false;
+        }
+        recovered_count_ = 0;
+        return true;
+    }
+
+    recovered_count_ = recoverWriteIndex();
+    LOGI("Telemetry log recovered: segment=%u, records=%u, next_seq=%u",
+         active_id_, recovered_count_, next_sequence_);
+
+    if (write_index_ >= capacity_) {
+        return rotate();
+    }
+    return true;
+}
+
+bool TelemetryLog::append(const TelemetryRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (active_map_ == nullptr) {
+        return false;
+    }
+
+    if (write_index_ >= capacity_ && !rotate()) {
+        return false;
+    }
+
+    TelemetryRecord staged = record;
+    // Keep segments sorted for binary search even if the wall clock steps back
+    staged.timestamp_ms = std::max(staged.timestamp_ms, last_timestamp_ms_);
+    staged.reserved = 0;
+    staged.sequence = next_sequence_;
+    staged.crc = crc32c(&staged, offsetof(TelemetryRecord, crc));
+
+    // Payload first, CRC last: a torn write leaves a record that fails validation
+    TelemetryRecord* slot = recordAt(active_map_, write_index_);
+    std::memcpy(slot, &staged, offsetof(TelemetryRecord, crc));
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->crc = staged.crc;
+
+    write_index_++;
+    next_sequence_++;
+    last_timestamp_ms_ = staged.timestamp_ms;
+
+    if (++unsynced_ >= SYNC_INTERVAL_RECORDS) {
+        msync(active_map_, active_map_size_, MS_ASYNC);
+        unsynced_ = 0;
+    }
+
+    return true;
+}
+
+void TelemetryLog::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (active_map_ != nullptr) {
+        msync(active_map_, active_map_size_, MS_SYNC);
+        unsynced_ = 0;
+    }
+}
+
+void TelemetryLog::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (active_map_ != nullptr) {
+        msync(active_map_, active_map_size_, MS_SYNC);
+        munmap(active_map_, active_map_size_);
+        active_map_ = nullptr;
+        active_map_size_ = 0;
+    }
+    if (active_fd_ >= 0) {
+        ::close(active_fd_);
+        active_fd_ = -1;
+    }
+    write_index_ = 0;
+    unsynced_ = 0;
+}
+
+size_t TelemetryLog::scan(int64_t from_ms, int64_t to_ms,
+                          const std::function<void(const TelemetryRecord&)>& visitor) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (active_map_ == nullptr) {
+        return 0;
+    }
+
+    size_t visited = 0;
+
+    for (uint32_t id : listSegments()) {
+        if (id == active_id_) {
+            visited += scanMapped(active_map_, write_index_, from_ms, to_ms, visitor);
+            continue;
+        }
+
+        std::string path = segmentPath(id);
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(SegmentHeader))) {
+            ::close(fd);
+            continue;
+        }
+
+        size_t size = static_cast<size_t>(st.st_size);
+        void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) continue;
+
+        madvise(map, size, MADV_SEQUENTIAL);
+
+        const uint8_t* base = static_cast<const uint8_t*>(map);
+        SegmentHeader header;
+        std::memcpy(&header, base, sizeof(header));
+
+        bool header_ok = std::memcmp(header.magic, SEGMENT_MAGIC, 4) == 0 &&
+                         header.record_size == sizeof(TelemetryRecord) &&
+                         header.crc == crc32c(&header, offsetof(SegmentHeader, crc));
+        if (header_ok) {
+            uint32_t slots = static_cast<uint32_t>(
+                (size - sizeof(SegmentHeader)) / sizeof(TelemetryRecord));
+            uint32_t capacity = std::min(header.capacity, slots);
+
+            // Records are contiguous from slot 0; unused slots are all zero
+            const TelemetryRecord* records =
+                reinterpret_cast<const TelemetryRecord*>(base + sizeof(SegmentHeader));
+            uint32_t count = static_cast<uint32_t>(std::partition_point(
+                records, records + capacity,
+                [](const TelemetryRecord& r) { return r.timestamp_ms != 0; }) - records);
+
+            visited += scanMapped(base, count, from_ms, to_ms, visitor);
+        }
+
+        munmap(map, size);
+    }
+
+    return visited;
+}
+
+std::vector<TelemetrySummary> TelemetryLog::summarize(int64_t from_ms, int64_t to_ms,
+                                                      int64_t bucket_ms) const {
+    std::vector<TelemetrySummary> buckets;
+    if (to_ms <= from_ms || bucket_ms <= 0) {
+        return buckets;
+    }
+
+    // Range and offsets in unsigned arithmetic: JNI passes any from/to
+    const uint64_t range = static_cast<uint64_t>(to_ms) - static_cast<uint64_t>(from_ms);
+    const uint64_t min_bucket = range / MAX_SUMMARY_BUCKETS + (range % MAX_SUMMARY_BUCKETS != 0);
+    const uint64_t width = std::max(static_cast<uint64_t>(bucket_ms), min_bucket);
+
+    size_t bucket_count = static_cast<size_t>(range / width + (range % width != 0));
+    buckets.resize(bucket_count);
+    std::vector<int> distance_samples(bucket_count, 0);
+
+    for (size_t i = 0; i < bucket_count; i++) {
+        buckets[i] = TelemetrySummary{};
+        buckets[i].start_ms = static_cast<int64_t>(static_cast<uint64_t>(from_ms) + i * width);
+    }
+
+    scan(from_ms, to_ms, [&](const TelemetryRecord& r) {
+        size_t b = static_cast<size_t>(
+            (static_cast<uint64_t>(r.timestamp_ms) - static_cast<uint64_t>(from_ms)) / width);
+        TelemetrySummary& s = buckets[b];
+
+        s.samples++;
+        s.mean_motion += r.motion_level;
+        s.max_motion = std::max(s.max_motion, r.motion_level);
+        if (r.flags & TELEMETRY_DEPTH_VALID) {
+            s.mean_distance += r.distance_meters;
+            distance_samples[b]++;
+        }
+        if (r.pose < 5) {
+            s.pose_counts[r.pose]++;
+        }
+        if (r.flags & TELEMETRY_FALL_DETECTED) {
+            s.fall_events++;
+        }
+        if (r.flags & TELEMETRY_PERSON_PRESENT) {
+            s.person_present++;
+        }
+    });
+
+    for (size_t i = 0; i < bucket_count; i++) {
+        if (buckets[i].samples > 0) {
+            buckets[i].mean_motion /= buckets[i].samples;
+        }
+        if (distance_samples[i] > 0) {
+            buckets[i].mean_distance /= distance_samples[i];
+        }
+    }
+
+    return buckets;
+}
+
+std::string TelemetryLog::segmentPath(uint32_t id) const {
+    char name[32];
+    snprintf(name, sizeof(name), "/telemetry_%08u.seg", id);
+    return directory_ + name;
+}
+
+std::vector<uint32_t> TelemetryLog::listSegments() const {
+    std::vector<uint32_t> ids;
+
+    DIR* dir = opendir(directory_.c_str());
+    if (!dir) {
+        return ids;
+    }
+
+    while (dirent* entry = readdir(dir)) {
+        unsigned int id = 0;
+        char suffix[8] = {0};
+        if (sscanf(entry->d_name, "telemetry_%8u.%3s", &id, suffix) == 2 &&
+            std::strcmp(suffix, "seg") == 0) {
+            ids.push_back(id);
+        }
+    }
+    closedir(dir);
+
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+bool TelemetryLog::openSegment(uint32_t id, bool create) {
+    std::string path = segmentPath(id);
+    size_t size = sizeof(SegmentHeader) + static_cast<size_t>(capacity_) * sizeof(TelemetryRecord);
+
+    int flags = O_RDWR | O_CLOEXEC | (create ? (O_CREAT | O_TRUNC) : 0);
+    int fd = ::open(path.c_str(), flags, 0600);
+    if (fd < 0) {
+        LOGE("Failed to open segment: %s", path.c_str());
+        return false;
+    }
+
+    if (!create) {
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        // Keep the on-disk capacity of existing segments
+        if (st.st_size > static_cast<off_t>(sizeof(SegmentHeader))) {
+            size = static_cast<size_t>(st.st_size);
+        }
+    }
+
+    // Preallocate so appends never extend the file (zero-filled slots = empty)
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        LOGE("Failed to size segment %s to %zu bytes", path.c_str(), size);
+        ::close(fd);
+        return false;
+    }
+
+    void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        LOGE("Failed to mmap segment: %s", path.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    uint8_t* base = static_cast<uint8_t*>(map);
+    SegmentHeader header;
+
+    if (create) {
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, SEGMENT_MAGIC, 4);
+        header.version = FORMAT_VERSION;
+        header.record_size = sizeof(TelemetryRecord);
+        header.capacity = capacity_;
+        header.segment_id = id;
+        header.first_sequence = next_sequence_;
+        header.created_ms = nowMs();
+        header.crc = crc32c(&header, offsetof(SegmentHeader, crc));
+        std::memcpy(base, &header, sizeof(header));
+        msync(base, sizeof(header), MS_SYNC);
+    } else {
+        std::memcpy(&header, base, sizeof(header));
+        bool valid = std::memcmp(header.magic, SEGMENT_MAGIC, 4) == 0 &&
+                     header.version == FORMAT_VERSION &&
+                     header.record_size == sizeof(TelemetryRecord) &&
+                     header.segment_id == id &&
+                     header.crc == crc32c(&header, offsetof(SegmentHeader, crc));
+        if (!valid) {
+            LOGE("Corrupt segment header: %s", path.c_str());
+            munmap(map, size);
+            ::close(fd);
+            return false;
+        }
+        capacity_ = std::min<uint32_t>(header.capacity, static_cast<uint32_t>(
+            (size - sizeof(SegmentHeader)) / sizeof(TelemetryRecord)));
+        next_sequence_ = header.first_sequence;
+    }
+
+    active_fd_ = fd;
+    active_map_ = base;
+    active_map_size_ = size;
+    active_id_ = id;
+    write_index_ = 0;
+    unsynced_ = 0;
+    return true;
+}
+
+bool TelemetryLog::rotate() {
+    uint32_t next_id = active_id_ + 1;
+
+    msync(active_map_, active_map_size_, MS_SYNC);
+    munmap(active_map_, active_map_size_);
+    ::close(active_fd_);
+    active_map_ = nullptr;
+    active_fd_ = -1;
+
+    if (!openSegment(next_id, true)) {
+        LOGE("Segment rotation failed");
+        return false;
+    }
+
+    pruneSegments();
+    LOGI("Rotated telemetry log to segment %u", next_id);
+    return true;
+}
+
+void TelemetryLog::pruneSegments() {
+    std::vector<uint32_t> ids = listSegments();
+    while (static_cast<int>(ids.size()) > max_segments_) {
+        std::string path = segmentPath(ids.front());
+        if (unlink(path.c_str()) != 0) {
+            LOGW("Failed to delete old segment: %s", path.c_str());
+        }
+        ids.erase(ids.begin());
+    }
+}
+
+uint32_t TelemetryLog::recoverWriteIndex() {
+    uint32_t first_sequence = next_sequence_;
+    uint32_t index = 0;
+
+    while (index < capacity_) {
+        const TelemetryRecord* r = recordAt(active_map_, index);
+        if (!isValidRecord(*r) || r->sequence != first_sequence + index) {
+            break;
+        }
+        index++;
+    }
+
+    // Zero the torn/stale tail so scans stop at the recovered end
+    if (index < capacity_) {
+        uint8_t* tail = reinterpret_cast<uint8_t*>(recordAt(active_map_, index));
+        uint8_t* end = active_map_ + active_map_size_;
+        bool dirty = std::any_of(tail, end, [](uint8_t b) { return b != 0; });
+        if (dirty) {
+            LOGW("Discarding torn tail after record %u", index);
+            std::memset(tail, 0, end - tail);
+            msync(active_map_, active_map_size_, MS_SYNC);
+        }
+    }
+
+    write_index_ = index;
+    next_sequence_ = first_sequence + index;
+    if (index > 0) {
+        last_timestamp_ms_ = recordAt(active_map_, index - 1)->timestamp_ms;
+    }
+    return index;
+}
+
+bool TelemetryLog::isValidRecord(const TelemetryRecord& record) {
+    return record.timestamp_ms != 0 &&
+           record.crc == crc32c(&record, offsetof(TelemetryRecord, crc));
+}
+
+size_t TelemetryLog::scanMapped(const uint8_t* base, uint32_t count, int64_t from_ms, int64_t to_ms,
+                                const std::function<void(const TelemetryRecord&)>& visitor) const {
+    const TelemetryRecord* begin =
+        reinterpret_cast<const TelemetryRecord*>(base + sizeof(SegmentHeader));
+    const TelemetryRecord* end = begin + count;
+
+    if (count == 0 || end[-1].timestamp_ms < from_ms || begin->timestamp_ms >= to_ms) {
+        return 0;
+    }
+
+    // Records are appended in time order
+    const TelemetryRecord* it = std::lower_bound(begin, end, from_ms,
+        [](const TelemetryRecord& r, int64_t t) { return r.timestamp_ms < t; });
+
+    size_t visited = 0;
+    for (; it != end && it->timestamp_ms < to_ms; ++it) {
+        if (!isValidRecord(*it)) {
+            continue;
+        }
+        visitor(*it);
+        visited++;
+    }
+    return visited;
+}
+
+} // namespace triage
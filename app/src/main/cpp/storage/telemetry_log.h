@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <functional>
+
+namespace triage {
+
+/**
+ * One fixed-size telemetry sample (typically one per second).
+ *
+ * Layout is part of the on-disk format - do not reorder fields.
+ * The CRC covers every byte before it and is written last, so a torn
+ * write is detected on recovery.
+ */
+struct TelemetryRecord {
+    int64_t timestamp_ms;        // Wall clock (ms since epoch)
+    float motion_level;          // RGB motion 0-1
+    float depth_motion_level;    // Z-axis motion 0-1
+    float distance_meters;       // Camera to person
+    float position_x;            // 3D centroid (meters)
+    float position_y;
+    float position_z;
+    float fall_confidence;       // 0-1
+    uint8_t pose;                // triage::Pose value
+    uint8_t flags;               // TelemetryFlags bits
+    uint16_t reserved;
+    uint32_t sequence;           // Monotonic across segments
+    uint32_t crc;                // CRC32C of the preceding 44 bytes
+};
+static_assert(sizeof(TelemetryRecord) == 48, "TelemetryRecord layout changed");
+
+enum TelemetryFlags : uint8_t {
+    TELEMETRY_PERSON_PRESENT = 1 << 0,
+    TELEMETRY_FALL_DETECTED  = 1 << 1,
+    TELEMETRY_IN_BED_ZONE    = 1 << 2,
+    TELEMETRY_DEPTH_VALID    = 1 << 3,
+};
+
+/**
+ * Aggregate over one time bucket, built by a sequential scan
+ */
+struct TelemetrySummary {
+    int64_t start_ms;
+    int samples;
+    float mean_motion;
+    float max_motion;
+    float mean_distance;         // Over samples with valid depth
+    int pose_counts[5];          // Indexed by triage::Pose
+    int fall_events;
+    int person_present;          // Samples with a person in frame
+};
+
+/**
+ * Append-only, memory-mapped telemetry log.
+ *
+ * High-rate native telemetry (motion, pose, depth) is persisted here
+ * instead of going through the JVM and Room.
+ *
+ * On-disk layout:
+ * - Directory of segments named telemetry_<id>.seg
+ * - Each segment: 64-byte header + fixed capacity of TelemetryRecords,
+ *   preallocated and mapped MAP_SHARED
+ * - Full segments rotate; only the newest max_segments are kept
+ *
+ * Recovery after power loss scans the newest segment and resumes after
+ * the last record with a valid CRC and sequence number. Everything past
+ * that point is zeroed so a torn tail can never be read back.
+ */
+class TelemetryLog {
+public:
+    TelemetryLog();
+    ~TelemetryLog();
+
+    /**
+     * Open (or create) a log directory and recover the write position
+     * @param directory Directory holding the segments (created if missing)
+     * @param records_per_segment Segment capacity (default ~18h at 1 Hz)
+     * @param max_segments Segments kept before the oldest is deleted
+     * @return true on success
+     */
+    bool open(const std::string& directory,
+              uint32_t records_per_segment = 65536,
+              int max_segments = 4);
+
+    /**
+     * Append one record (sequence and CRC are filled in)
+     * @return false if the log is not open or rotation failed
+     */
+    bool append(const TelemetryRecord& record);
+
+    /**
+     * Force dirty pages of the active segment to storage
+     */
+    void flush();
+
+    /**
+     * Visit every valid record with from_ms <= timestamp < to_ms, oldest first.
+     * Uses binary search on each segment to skip to the start of the range.
+     * @return Number of records visited
+     */
+    size_t scan(int64_t from_ms, int64_t to_ms,
+                const std::function<void(const TelemetryRecord&)>& visitor) const;
+
+    static const int64_t MAX_SUMMARY_BUCKETS = 4096;
+
+    /**
+     * Bucketed chart summary over [from_ms, to_ms)
+     * @param bucket_ms Bucket width (e.g. 15 min for charting); widened so
+     *        the range spans at most MAX_SUMMARY_BUCKETS buckets
+     */
+    std::vector<TelemetrySummary> summarize(int64_t from_ms, int64_t to_ms,
+                                            int64_t bucket_ms) const;
+
+    /**
+     * Records recovered from the active segment at open()
+     */
+    uint32_t getRecoveredCount() const { return recovered_count_; }
+
+    /**
+     * Total records appended since the log was created
+     */
+    uint32_t getNextSequence() const { return next_sequence_; }
+
+    bool isOpen() const { return active_map_ != nullptr; }
+
+    /**
+     * Flush and unmap the active segment
+     */
+    void close();
+
+    /**
+     * CRC32C (Castagnoli) used for records and headers
+     */
+    static uint32_t crc32c(const void* data, size_t length);
+
+private:
+    struct SegmentHeader {
+        char magic[4];               // "TVLG"
+        uint32_t version;
+        uint32_t record_size;
+        uint32_t capacity;
+        uint32_t segment_id;
+        uint32_t first_sequence;     // Sequence of slot 0
+        int64_t created_ms;
+        uint8_t reserved1[28];
+        uint32_t crc;                // CRC32C of the preceding 60 bytes
+    };
+    static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader layout changed");
+
+    static const uint32_t FORMAT_VERSION = 1;
+    static const uint32_t SYNC_INTERVAL_RECORDS = 60;  // ~1 min at 1 Hz
+
+    mutable std::mutex mutex_;
+    std::string directory_;
+    uint32_t capacity_ = 0;
+    int max_segments_ = 0;
+
+    // Active (writable) segment
+    int active_fd_ = -1;
+    uint8_t* active_map_ = nullptr;
+    size_t active_map_size_ = 0;
+    uint32_t active_id_ = 0;
+    uint32_t write_index_ = 0;
+    uint32_t unsynced_ = 0;
+
+    uint32_t next_sequence_ = 0;
+    int64_t last_timestamp_ms_ = 0;
+    uint32_t recovered_count_ = 0;
+
+    std::string segmentPath(uint32_t id) const;
+    std::vector<uint32_t> listSegments() const;
+    bool openSegment(uint32_t id, bool create);
+    bool rotate();
+    void pruneSegments();
+    uint32_t recoverWriteIndex();
+
+    TelemetryRecord* recordAt(uint8_t* base, uint32_t index) const {
+        return reinterpret_cast<TelemetryRecord*>(base + sizeof(SegmentHeader)) + index;
+    }
+    static bool isValidRecord(const TelemetryRecord& record);
+
+    size_t scanMapped(const uint8_t* base, uint32_t count, int64_t from_ms, int64_t to_ms,
+                      const std::function<void(const TelemetryRecord&)>& visitor) const;
+};
+
+} // namespace triage
@@ -3,6 +3,12 @@ package com.triage.vision
 import android.app.Application
 import android.app.NotificationChannel
 import android.app.NotificationManager
+import android.content.BroadcastReceiver
+import android.content.Context
+import android.content.Intent
+import android.content.IntentFilter
+import android.os.BatteryManager
+import android.os.PowerManager
 import android.util.Log
 import com.triage.vision.backend.BackendRegistry
 import com.triage.vision.backend.BackendType
@@ -19,8 +25,11 @@ import com.triage.vision.charting.AutoChartEngine
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
 import java.io.File
+import java.time.LocalTime
 
 /**
  * Application class for Triage Vision
@@ -35,6 +44,16 @@ class TriageVisionApp : Application() {
     companion object {
         private const val TAG = "TriageVisionApp"
 
+        // Thermal headroom forecast window and poll interval (the platform
+        // rate-limits getThermalHeadroom to about once per second)
+        private const val HEADROOM_FORECAST_SECONDS = 10
+        private const val HEADROOM_POLL_MS = 10_000L
+
+        // Night hours in which the fast pipeline may idle a still patient
+        private const val NIGHT_START_HOUR = 22
+        private const val NIGHT_END_HOUR = 7
+        private const val NIGHT_CHECK_MS = 60_000L
+
         const val CHANNEL_MONITORING = "monitoring"
         const val CHANNEL_ALERTS = "alerts"
 
@@ -220,6 +239,15 @@ class TriageVisionApp : Application() {
             if (result == 0) {
                 isNativeInitialized = true
                 Log.i(TAG, "Native libraries initialized successfully")
+
+                val telemetryDir = File(filesDir, "telemetry")
+                if (!nativeBridge.openTelemetryLog(telemetryDir.absolutePath)) {
+                    Log.w(TAG, "Telemetry log unavailable at: ${telemetryDir.absolutePath}")
+                }
+
+                registerThermalListener()
+                registerBatteryListener()
+                scheduleNightDutyCycling()
             } else {
                 Log.e(TAG, "Native library initialization failed with code: $result")
             }
@@ -232,6 +260,92 @@ class TriageVisionApp : Application() {
         }
     }
 
+    /**
+     * Forward thermal status to the native YOLO input-size governor, and
+     * status and headroom to the pipeline governor (PowerManager thermal
+     * API is available from Android 10, headroom from Android 11; sysfs
+     * stands in for the headroom before that)
+     */
+    private fun registerThermalListener() {
+        if (android.os.Build.VERSION.SDK_INT < android.os.Build.VERSION_CODES.Q) {
+            pollSysfsPower()
+            return
+        }
+
+        val powerManager = getSystemService(PowerManager::class.java)
+        nativeBridge.setThermalState(powerManager.currentThermalStatus)
+        powerManager.addThermalStatusListener(mainExecutor) { status ->
+            Log.i(TAG, "Thermal status changed: $status")
+            nativeBridge.setThermalState(status)
+        }
+
+        // Headroom leads the status: the governor steps down before throttling
+        if (android.os.Build.VERSION.SDK_INT >= android.os.Build.VERSION_CODES.R) {
+            applicationScope.launch {
+                while (isActive) {
+                    nativeBridge.setThermalHeadroom(powerManager.getThermalHeadroom(HEADROOM_FORECAST_SECONDS))
+                    delay(HEADROOM_POLL_MS)
+                }
+            }
+        } else {
+            pollSysfsPower()
+        }
+    }
+
+    /**
+     * Without the headroom API (before Android 11) the governor reads the
+     * thermal zones from sysfs instead, where the device allows it
+     */
+    private fun pollSysfsPower() {
+        applicationScope.launch(Dispatchers.IO) {
+            if (!nativeBridge.pollSysfsPower()) {
+                Log.i(TAG, "No readable sysfs thermal zones; governor uses thermal status only")
+                return@launch
+            }
+            while (isActive) {
+                delay(HEADROOM_POLL_MS)
+                nativeBridge.pollSysfsPower()
+            }
+        }
+    }
+
+    /**
+     * Forward battery charge and power source to the native pipeline governor
+     */
+    private fun registerBatteryListener() {
+        val receiver = object : BroadcastReceiver() {
+            override fun onReceive(context: Context, intent: Intent) {
+                val level = intent.getIntExtra(BatteryManager.EXTRA_LEVEL, -1)
+                val scale = intent.getIntExtra(BatteryManager.EXTRA_SCALE, 100)
+                if (level < 0 || scale <= 0) return
+                val plugged = intent.getIntExtra(BatteryManager.EXTRA_PLUGGED, 0) != 0
+                nativeBridge.setBatteryState(level * 100f / scale, plugged)
+            }
+        }
+        // Sticky broadcast: the current state is delivered on registration
+        registerReceiver(receiver, IntentFilter(Intent.ACTION_BATTERY_CHANGED))
+    }
+
+    /**
+     * Allow native duty cycling during night hours only, so a still patient
+     * by day is always watched at full rate
+     */
+    private fun scheduleNightDutyCycling() {
+        applicationScope.launch {
+            var night: Boolean? = null
+            while (isActive) {
+                val hour = LocalTime.now().hour
+                val isNight = hour >= NIGHT_START_HOUR || hour < NIGHT_END_HOUR
+                if (isNight != night) {
+                    Log.i(TAG, "Night duty cycling ${if (isNight) "enabled" else "disabled"}")
+                    nativeBridge.setDutyCycling(isNight, 0)
+                    night = isNight
+                }
+                delay(NIGHT_CHECK_MS)
+            }
+        }
+    }
+
     /**
      * Get the directory where ML models are stored
      */
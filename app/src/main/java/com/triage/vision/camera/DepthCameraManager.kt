@@ -18,6 +18,7 @@ import kotlinx.coroutines.flow.SharedFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.suspendCancellableCoroutine
+import java.nio.ByteBuffer
 import java.util.concurrent.Semaphore
 import java.util.concurrent.TimeUnit
 import kotlin.coroutines.resume
@@ -102,6 +103,21 @@ class DepthCameraManager(private val context: Context) {
     val depthFrames: SharedFlow<DepthFrame> = _depthFrames
 
     private var onDepthFrameCallback: ((DepthFrame) -> Unit)? = null
+
+    /**
+     * Receives DEPTH16 planes in place on the camera thread. The buffer is
+     * only valid during the call (the Image is closed right after).
+     */
+    fun interface DirectDepthListener {
+        fun onDepthImage(buffer: ByteBuffer, width: Int, height: Int, rowStride: Int, timestampNs: Long)
+    }
+
+    /**
+     * When set, depth images go only to this listener (native synchronizer)
+     * and no ShortArray frames are allocated or emitted
+     */
+    @Volatile
+    var directDepthListener: DirectDepthListener? = null
     private val scope = CoroutineScope(Dispatchers.Default)
 
     /**
@@ -416,6 +432,12 @@ class DepthCameraManager(private val context: Context) {
     private fun processDepthImage(image: Image) {
         if (!isCapturing) return
 
+        directDepthListener?.let { listener ->
+            val plane = image.planes[0]
+            listener.onDepthImage(plane.buffer, image.width, image.height, plane.rowStride, image.timestamp)
+            return
+        }
+
         val plane = image.planes[0]
         val buffer = plane.buffer
         val width = image.width
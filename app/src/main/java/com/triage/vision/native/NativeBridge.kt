@@ -1,6 +1,7 @@
 package com.triage.vision.native
 
 import android.graphics.Bitmap
+import java.nio.ByteBuffer
 
 /**
  * JNI bridge to native inference libraries (NCNN, llama.cpp)
@@ -20,13 +21,165 @@ class NativeBridge {
      */
     external fun init(modelPath: String): Int
 
+    /**
+     * Prefer the INT8-quantized YOLO model (model.ncnn.int8.*) on the next init.
+     * Falls back to the float model if the quantized files are missing.
+     */
+    external fun setYoloInt8(enabled: Boolean)
+
+    /**
+     * Whether the loaded YOLO model is the INT8-quantized one
+     */
+    external fun isYoloInt8(): Boolean
+
+    /**
+     * CPU extensions found at startup and the SIMD kernel variant in use
+     * @return JSON flags (neon, dotprod, fp16, i8mm, avx2, fma) and "kernels"
+     */
+    external fun getCpuFeatures(): String
+
+    /**
+     * Shared native thread pool counters
+     * @return JSON with workers, active_workers, external_threads (cores
+     *         lent to ncnn/llama.cpp), tasks_run, tasks_stolen,
+     *         parallel_fors, chunks_run and chunks_by_caller
+     */
+    external fun getThreadPoolStats(): String
+
+    /**
+     * Device thermal status (PowerManager.THERMAL_STATUS_*); hotter states
+     * cap the YOLO input size
+     */
+    external fun setThermalState(status: Int)
+
+    /**
+     * PowerManager.getThermalHeadroom() forecast (1.0 = throttling starts;
+     * NaN if unsupported); feeds the pipeline governor
+     */
+    external fun setThermalHeadroom(headroom: Float)
+
+    /**
+     * Battery charge and power source; on battery the pipeline governor
+     * steps down as the charge drops
+     * @param percent Charge 0-100
+     * @param charging On external power
+     */
+    external fun setBatteryState(percent: Float, charging: Boolean)
+
+    /**
+     * Read thermal zones and the battery from sysfs into the pipeline
+     * governor (for devices without the headroom API); inputs sysfs does
+     * not expose keep their reported values
+     * @return false if nothing readable was found
+     */
+    external fun pollSysfsPower(): Boolean
+
+    /**
+     * Current pipeline governor level and what it applies
+     * @return JSON with level (0 nominal - 3 critical), name, demand, max_fps
+     *         (0 = uncapped), yolo_max_input, motion_step, vlm_threads,
+     *         level_changes, frames_admitted, frames_skipped,
+     *         seconds_at_level, and the thermal/battery inputs
+     */
+    external fun getGovernorState(): String
+
+    /**
+     * Night idle duty cycling: after long stillness the fast pipeline drops
+     * to motion-only (or depth-only with ToF) checks at 2 fps with YOLO idle,
+     * and runs in full again on the first frame with motion, a depth spike
+     * or a fall precursor
+     * @param enabled Allow idling (disabling returns to full rate at once)
+     * @param idleAfterSeconds Stillness before idling (0 = default 300)
+     */
+    external fun setDutyCycling(enabled: Boolean, idleAfterSeconds: Int)
+
+    /**
+     * Duty cycling mode and time per mode
+     * @return JSON with enabled, mode (full, motion_only, depth_only),
+     *         idle_entries, wakes, last_wake_reason, frames_processed,
+     *         frames_skipped and seconds_in_mode
+     */
+    external fun getDutyCycleState(): String
+
+    /**
+     * Target YOLO inference time per frame for the input-size governor
+     * @param budgetMs Milliseconds (default 25)
+     */
+    external fun setYoloLatencyBudget(budgetMs: Float)
+
+    /**
+     * Presence cascade: a 160 px YOLO pass over a fixed ROI decides whether
+     * the full detector needs to run; clear, unchanged frames reuse the last
+     * full result
+     * @param refreshFrames Run the full detector at least this often
+     */
+    external fun setPresenceCascade(enabled: Boolean, refreshFrames: Int)
+
+    /**
+     * ROI the presence stage looks at, normalized to the frame (0-1)
+     */
+    external fun setPresenceRoi(left: Float, top: Float, right: Float, bottom: Float)
+
+    /**
+     * Presence cascade benchmark: frames, full runs, fraction of full
+     * inferences avoided and mean stage / full / per-frame cost
+     * @return JSON stats
+     */
+    external fun getPresenceCascadeStats(): String
+
+    /**
+     * Static object cache: all 80 classes are decoded only on occasional
+     * refresh passes (furniture is remembered in between); other frames
+     * decode the person class alone. The cached bed sets the depth bed zone.
+     * On by default.
+     */
+    external fun setStaticObjectCache(enabled: Boolean)
+
+    /**
+     * Low-light enhancement: on dark frames an adaptive gamma / contrast
+     * limited equalization curve is applied to the detector input. On by
+     * default; does nothing on normally lit frames.
+     */
+    external fun setLowLightEnhancement(enabled: Boolean)
+
+    /**
+     * Low-light state (enabled, active, mean luma, gamma)
+     * @return JSON status
+     */
+    external fun getLowLightStatus(): String
+
+    /**
+     * Cached furniture (normalized boxes, persistence, stable flag)
+     * @return JSON with a revision counter and an "objects" array
+     */
+    external fun getStaticObjects(): String
+
     /**
      * Fast Pipeline: Detect motion and pose in frame
      * @param bitmap Camera frame
-     * @return Detection results (JSON string)
+     * @return Detection results (JSON string), or {"skipped": true} for a
+     *         frame over the governor or duty-cycle rate (nothing was run)
      */
     external fun detectMotion(bitmap: Bitmap): String?
 
+    /**
+     * Fast Pipeline: Detect motion and pose in an NV21 camera frame, read
+     * in place (no Bitmap conversion)
+     * @param yPlane Direct buffer of the Y plane (valid only during the call)
+     * @param vuPlane Direct buffer of the interleaved V/U plane, V first
+     * @param yRowStride Bytes per Y row
+     * @param vuRowStride Bytes per V/U row
+     * @return Detection results (JSON string, as detectMotion)
+     */
+    external fun detectMotionNv21(
+        yPlane: ByteBuffer,
+        vuPlane: ByteBuffer,
+        width: Int,
+        height: Int,
+        yRowStride: Int,
+        vuRowStride: Int
+    ): String?
+
     /**
      * Fast Pipeline: Quick check if person is in frame
      * @param bitmap Camera frame
@@ -40,13 +193,39 @@ class NativeBridge {
      */
     external fun getMotionLevel(): Float
 
+    /**
+     * Fast Pipeline: motion history decay time and feature window length
+     * @param durationMs Time for a cell to fade from "moving now" to 0
+     * @param windowFrames Frames the feature histograms cover
+     */
+    external fun setMotionHistoryConfig(durationMs: Int, windowFrames: Int)
+
+    /**
+     * Fast Pipeline: motion history features over the sliding window
+     * (energy, energy and direction histograms, edge fraction, centroid)
+     * for activity classification
+     * @return JSON features
+     */
+    external fun getMotionFeatures(): String
+
+    /**
+     * Fast Pipeline: detect small objects in a high-resolution still
+     * (overlapping native-resolution tiles, merged with global NMS).
+     * On demand only - cost grows with the number of tiles.
+     * @param bitmap Full-resolution still (ARGB_8888 or RGB_565)
+     * @param overlap Fraction of each tile shared with its neighbour (0-0.5)
+     * @return JSON with a "detections" array (pixel boxes) and per-tile timing
+     */
+    external fun detectTiled(bitmap: Bitmap, overlap: Float): String
+
     /**
      * Fast Pipeline: Detect motion and pose with depth enhancement
      * @param bitmap Camera frame (RGB)
-     * @param depthData Depth map (DEPTH16 format, values in millimeters)
+     * @param depthData Depth map (DEPTH16 format: 3-bit confidence, 13-bit range in millimeters)
      * @param depthWidth Depth frame width
      * @param depthHeight Depth frame height
-     * @return Detection results with depth metrics (JSON string)
+     * @return Detection results with depth metrics (JSON string), or
+     *         {"skipped": true} as detectMotion
      */
     external fun detectMotionWithDepth(
         bitmap: Bitmap,
@@ -63,12 +242,153 @@ class NativeBridge {
      */
     external fun getDepthAt(x: Int, y: Int): Float
 
+    /**
+     * Minimum DEPTH16 sample confidence to keep (0-1, quantized to 1/7).
+     * Lower-confidence samples are treated as invalid depth.
+     */
+    external fun setDepthConfidenceFloor(minConfidence: Float)
+
+    /**
+     * Configure the native RGB-depth synchronizer
+     * @param toleranceMs Maximum RGB/depth timestamp difference for a pair
+     * @param capacity Frames buffered per stream
+     */
+    external fun initFrameSync(toleranceMs: Float, capacity: Int)
+
+    /**
+     * Submit an RGB frame to the native synchronizer. If a depth frame is
+     * within tolerance the pair runs through the depth pipeline immediately.
+     * @param timestampNs Camera timestamp (ImageProxy.imageInfo.timestamp)
+     * @return Depth pipeline JSON with "synced": true (and "skipped": true
+     *         for a frame over the governor rate), or {"synced": false}
+     */
+    external fun submitSyncRgbFrame(bitmap: Bitmap, timestampNs: Long): String
+
+    /**
+     * Submit a DEPTH16 frame to the native synchronizer, read in place.
+     * A pair it completes is copied out but not run here: call
+     * processPendingSyncPair() on the frame thread.
+     * @param depthBuffer Direct buffer of the Image plane (valid only during the call)
+     * @param rowStride Bytes per row of the plane
+     * @param timestampNs Camera timestamp (Image.timestamp)
+     * @return {"synced": false, "pair_pending": true} if a pair is waiting,
+     *         else {"synced": false}
+     */
+    external fun submitSyncDepthFrame(
+        depthBuffer: ByteBuffer,
+        width: Int,
+        height: Int,
+        rowStride: Int,
+        timestampNs: Long
+    ): String
+
+    /**
+     * Run the pair completed by the last depth frame through the depth pipeline
+     * @return Depth pipeline JSON with "synced": true (and "skipped": true
+     *         for a frame over the governor rate), or {"synced": false}
+     *         if no pair is waiting
+     */
+    external fun processPendingSyncPair(): String
+
+    /**
+     * Native synchronizer statistics (JSON: pairs, drops, mean delta, buffered frames)
+     */
+    external fun getFrameSyncStats(): String
+
     /**
      * Get average distance to detected person
      * @return Distance in meters
      */
     external fun getAverageDistance(): Float
 
+    /**
+     * Get recent repositioning events (pressure-injury timer log)
+     * @return JSON array of events, oldest first
+     */
+    external fun getRepositionEvents(): String
+
+    /**
+     * Get streaming sleep/wake estimate (30 s actigraphy epochs)
+     * @return JSON with current state, per-state minutes and recent epochs
+     */
+    external fun getSleepSummary(): String
+
+    /**
+     * Multi-camera: create a monitoring session for one bed/camera.
+     * Sessions share the loaded YOLO weights; only per-session state is allocated.
+     * @param name Display name (e.g. bed label)
+     * @param priority Scheduling weight (>= 1, higher is served more often)
+     * @return Session id, or -1 on failure
+     */
+    external fun createSession(name: String, priority: Int): Int
+
+    /**
+     * Multi-camera: submit an RGB frame (motion runs immediately, YOLO when scheduled)
+     * @return true if the session exists and the frame was accepted
+     */
+    external fun submitSessionFrame(sessionId: Int, bitmap: Bitmap, timestampMs: Long): Boolean
+
+    /**
+     * Multi-camera: submit a DEPTH16 frame for a session. Results of the
+     * session's next inferences add depth_available, depth_fall,
+     * fall_confidence, vertical_drop_meters, distance_meters and
+     * depth_motion_level, measured on its person box.
+     */
+    external fun submitSessionDepth(
+        sessionId: Int,
+        depthData: ShortArray,
+        depthWidth: Int,
+        depthHeight: Int
+    ): Boolean
+
+    /**
+     * Multi-camera: run YOLO for the next scheduled session
+     * @return JSON result of the served session, or "{}" if none had a pending frame
+     */
+    external fun runSessionInference(): String
+
+    /**
+     * Multi-camera: run YOLO for up to maxStreams scheduled sessions concurrently
+     * @return JSON with a "results" array (one per served session) and "aggregate_fps"
+     */
+    external fun runSessionBatch(maxStreams: Int): String
+
+    /**
+     * Multi-camera: latest result for a session (JSON)
+     */
+    external fun getSessionResult(sessionId: Int): String
+
+    /**
+     * Multi-camera: scheduling policy (0 = round-robin, 1 = priority)
+     */
+    external fun setSessionScheduling(policy: Int)
+
+    /**
+     * Multi-camera: change a session's scheduling weight
+     */
+    external fun setSessionPriority(sessionId: Int, priority: Int): Boolean
+
+    /**
+     * Multi-camera: remove a session and free its state
+     */
+    external fun destroySession(sessionId: Int): Boolean
+
+    /**
+     * Open the native append-only telemetry log (per-second motion/pose/depth)
+     * @param directory Directory for log segments (created if missing)
+     * @return true if the log is open and recovered
+     */
+    external fun openTelemetryLog(directory: String): Boolean
+
+    /**
+     * Summarize logged telemetry into fixed time buckets for charting
+     * @param fromMs Range start (ms since epoch, inclusive)
+     * @param toMs Range end (ms since epoch, exclusive)
+     * @param bucketMs Bucket width in milliseconds (widened to at most 4096 buckets)
+     * @return JSON array of bucket summaries
+     */
+    external fun getTelemetrySummary(fromMs: Long, toMs: Long, bucketMs: Long): String
+
     /**
      * Slow Pipeline: Run VLM analysis on frame
      * @param bitmap Camera frame to analyze
@@ -4,6 +4,7 @@ import android.graphics.Bitmap
 import com.triage.vision.camera.DepthCameraManager
 import com.triage.vision.camera.MediaPipePoseDetector
 import com.triage.vision.native.NativeBridge
+import java.nio.ByteBuffer
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.serialization.Serializable
@@ -48,7 +49,26 @@ class FastPipeline(
         val depthMotionLevel: Float = 0f,
         val bedProximityMeters: Float = 0f,
         val inBedZone: Boolean = false,
-        val position3D: Position3D? = null
+        val position3D: Position3D? = null,
+        // Body point distribution (head height above floor, floor contact)
+        val headHeightMeters: Float = 0f,
+        val nearFloorFraction: Float = 0f,
+        // Patient relative to the estimated mattress surface
+        val bedSurfaceValid: Boolean = false,
+        val heightAboveBedMeters: Float = 0f,
+        val overBedEdgeFraction: Float = 0f,
+        // Pressure-injury repositioning timer (native tracker)
+        val secondsSinceReposition: Long = 0,
+        val repositionCount: Int = 0,
+        // Continuous actigraphy-based alertness context
+        val sleepState: SleepState = SleepState.UNKNOWN,
+        val activityLevel: Float = 0f,
+        // Global brightness jump (lights switched) compensated out of the motion level
+        val lightingChange: Boolean = false,
+        // Dark scene: detector input brightened by the low-light curve
+        val lowLight: Boolean = false,
+        // Increments when the camera is moved (floor/bed calibration re-learned)
+        val sceneGeneration: Int = 0
     )
 
     @Serializable
@@ -69,6 +89,13 @@ class FastPipeline(
         UNKNOWN, LYING, SITTING, STANDING, FALLEN
     }
 
+    /**
+     * Native sleep/wake epoch state (ordinal matches triage::SleepState)
+     */
+    enum class SleepState {
+        UNKNOWN, SLEEP, WAKE, RESTLESS
+    }
+
     sealed class Alert {
         data class Stillness(val durationSeconds: Long) : Alert()
         object FallDetected : Alert()
@@ -101,7 +128,12 @@ class FastPipeline(
 
         // Run native detection for person detection and motion
         val resultJson = nativeBridge.detectMotion(bitmap)
-        val personDetected = nativeBridge.isPersonDetected(bitmap)
+        if (isSkipped(resultJson)) return _detectionState.value
+
+        // While duty cycling idles only motion runs natively: the YOLO person
+        // flag is left over from before, so pose and alerts wait for a wake
+        val dutyFull = isDutyFull(resultJson)
+        val personDetected = dutyFull && nativeBridge.isPersonDetected(bitmap)
         val motionLevel = nativeBridge.getMotionLevel()
 
         // Update motion timestamp
@@ -153,7 +185,9 @@ class FastPipeline(
         )
 
         // Check for alerts
-        checkAlerts(result)
+        if (dutyFull) {
+            checkAlerts(result)
+        }
 
         // Update state
         _detectionState.value = result
@@ -182,6 +216,53 @@ class FastPipeline(
             depthFrame.height
         )
 
+        return handleDepthResult(resultJson)
+    }
+
+    /**
+     * Submit an RGB frame to the native RGB-depth synchronizer
+     * @return Detection result if it completed a synchronized pair, null otherwise
+     */
+    fun submitSyncedRgbFrame(bitmap: Bitmap, timestampNs: Long): DetectionResult? {
+        val resultJson = nativeBridge.submitSyncRgbFrame(bitmap, timestampNs)
+        if (!resultJson.contains("\"synced\": true")) return null
+
+        frameCount++
+        return handleDepthResult(resultJson)
+    }
+
+    /**
+     * Submit a DEPTH16 Image plane to the native RGB-depth synchronizer.
+     * The buffer is read during the call only, so the Image can be closed after.
+     * @return true if it completed a pair; run it with processPendingSyncedPair
+     *         on the frame thread
+     */
+    fun submitSyncedDepthFrame(
+        depthBuffer: ByteBuffer,
+        width: Int,
+        height: Int,
+        rowStride: Int,
+        timestampNs: Long
+    ): Boolean {
+        val resultJson = nativeBridge.submitSyncDepthFrame(depthBuffer, width, height, rowStride, timestampNs)
+        return resultJson.contains("\"pair_pending\": true")
+    }
+
+    /**
+     * Run the pair completed by the last depth frame
+     * @return Detection result, or null if no pair was waiting
+     */
+    fun processPendingSyncedPair(): DetectionResult? {
+        val resultJson = nativeBridge.processPendingSyncPair()
+        if (!resultJson.contains("\"synced\": true")) return null
+
+        frameCount++
+        return handleDepthResult(resultJson)
+    }
+
+    private fun handleDepthResult(resultJson: String?): DetectionResult {
+        if (isSkipped(resultJson)) return _detectionState.value
+
         // Update motion timestamp
         val motionLevel = nativeBridge.getMotionLevel()
         if (motionLevel > 0.1f) {
@@ -203,59 +284,20 @@ class FastPipeline(
         return result
     }
 
-    private fun parseDepthResult(json: String?, secondsSinceMotion: Long): DetectionResult {
-        if (json.isNullOrEmpty()) {
-            return DetectionResult(secondsSinceLastMotion = secondsSinceMotion)
-        }
-
-        return try {
-            // Parse JSON manually for now (could use kotlinx.serialization)
-            val personDetected = json.contains("\"person_detected\": true")
-            val fallDetected = json.contains("\"fall_detected\": true")
-            val depthFall = json.contains("\"depth_fall\": true")
-            val depthAvailable = json.contains("\"depth_available\": true")
-            val inBedZone = json.contains("\"in_bed_zone\": true")
-
-            // Extract numeric values
-            val distanceMeters = extractFloat(json, "distance_meters") ?: 0f
-            val verticalDrop = extractFloat(json, "vertical_drop_meters") ?: 0f
-            val fallConfidence = extractFloat(json, "fall_confidence") ?: 0f
-            val depthMotionLevel = extractFloat(json, "depth_motion_level") ?: 0f
-            val bedProximity = extractFloat(json, "bed_proximity_meters") ?: 0f
-            val motionLevel = extractFloat(json, "motion_level") ?: 0f
-
-            // Extract 3D position
-            val posX = extractFloat(json, "\"x\":") ?: 0f
-            val posY = extractFloat(json, "\"y\":") ?: 0f
-            val posZ = extractFloat(json, "\"z\":") ?: 0f
-
-            val pose = parsePose(json)
-
-            DetectionResult(
-                personDetected = personDetected,
-                pose = pose,
-                motionLevel = motionLevel,
-                fallDetected = fallDetected,
-                secondsSinceLastMotion = secondsSinceMotion,
-                depthAvailable = depthAvailable,
-                depthFallDetected = depthFall,
-                verticalDropMeters = verticalDrop,
-                fallConfidence = fallConfidence,
-                distanceMeters = distanceMeters,
-                depthMotionLevel = depthMotionLevel,
-                bedProximityMeters = bedProximity,
-                inBedZone = inBedZone,
-                position3D = Position3D(posX, posY, posZ)
-            )
-        } catch (e: Exception) {
-            DetectionResult(secondsSinceLastMotion = secondsSinceMotion)
-        }
-    }
+    /**
+     * Frame dropped by the governor or idle pacing: nothing new was measured,
+     * so the last state stands and no alerts are re-raised from it
+     */
+    private fun isSkipped(json: String?): Boolean =
+        json?.contains("\"skipped\": true") == true
 
-    private fun extractFloat(json: String, key: String): Float? {
-        val pattern = "$key\\s*[\":]?\\s*(-?\\d+\\.?\\d*)".toRegex()
-        return pattern.find(json)?.groupValues?.get(1)?.toFloatOrNull()
-    }
+    /**
+     * Whether the native pipeline ran in full duty mode (also true for a
+     * result without a mode, such as the empty one before native init)
+     */
+    private fun isDutyFull(json: String?): Boolean =
+        json == null || !json.contains("\"duty_mode\"") ||
+            json.contains("\"duty_mode\": \"full\"")
 
     private fun checkDepthAlerts(result: DetectionResult) {
         // Depth-verified fall (highest priority)
@@ -295,11 +337,6 @@ class FastPipeline(
         }
     }
 
-    private fun parsePose(json: String?): Pose {
-        // TODO: Parse actual pose from YOLO detection classes
-        return Pose.UNKNOWN
-    }
-
     private fun checkAlerts(result: DetectionResult) {
         // Fall detection
         if (config.fallDetectionEnabled && result.fallDetected) {
@@ -335,4 +372,93 @@ class FastPipeline(
     }
 
     fun getFrameCount(): Long = frameCount
+
+    companion object {
+        internal fun parseDepthResult(json: String?, secondsSinceMotion: Long): DetectionResult {
+            if (json.isNullOrEmpty()) {
+                return DetectionResult(secondsSinceLastMotion = secondsSinceMotion)
+            }
+
+            return try {
+                // Parse JSON manually for now (could use kotlinx.serialization)
+                val personDetected = json.contains("\"person_detected\": true")
+                val fallDetected = json.contains("\"fall_detected\": true")
+                val depthFall = json.contains("\"depth_fall\": true")
+                val depthAvailable = json.contains("\"depth_available\": true")
+                val inBedZone = json.contains("\"in_bed_zone\": true")
+                val bedSurfaceValid = json.contains("\"bed_surface_valid\": true")
+                val lightingChange = json.contains("\"lighting_change\": true")
+                val lowLight = json.contains("\"low_light\": true")
+
+                // Extract numeric values
+                val distanceMeters = extractFloat(json, "distance_meters") ?: 0f
+                val verticalDrop = extractFloat(json, "vertical_drop_meters") ?: 0f
+                val fallConfidence = extractFloat(json, "fall_confidence") ?: 0f
+                val headHeight = extractFloat(json, "head_height_meters") ?: 0f
+                val nearFloorFraction = extractFloat(json, "near_floor_fraction") ?: 0f
+                val heightAboveBed = extractFloat(json, "height_above_bed_meters") ?: 0f
+                val overBedEdge = extractFloat(json, "over_bed_edge_fraction") ?: 0f
+                val depthMotionLevel = extractFloat(json, "depth_motion_level") ?: 0f
+                val bedProximity = extractFloat(json, "bed_proximity_meters") ?: 0f
+                val motionLevel = extractFloat(json, "motion_level") ?: 0f
+                val secondsSinceReposition = extractFloat(json, "seconds_since_reposition")?.toLong() ?: 0L
+                val repositionCount = extractFloat(json, "reposition_count")?.toInt() ?: 0
+                val sleepState = extractFloat(json, "sleep_state")?.toInt()
+                    ?.let { SleepState.values().getOrNull(it) } ?: SleepState.UNKNOWN
+                val activityLevel = extractFloat(json, "activity_level") ?: 0f
+                val sceneGeneration = extractFloat(json, "scene_generation")?.toInt() ?: 0
+
+                // Extract 3D position
+                val posX = extractFloat(json, "x") ?: 0f
+                val posY = extractFloat(json, "y") ?: 0f
+                val posZ = extractFloat(json, "z") ?: 0f
+
+                val pose = parsePose(json)
+
+                DetectionResult(
+                    personDetected = personDetected,
+                    pose = pose,
+                    motionLevel = motionLevel,
+                    fallDetected = fallDetected,
+                    secondsSinceLastMotion = secondsSinceMotion,
+                    depthAvailable = depthAvailable,
+                    depthFallDetected = depthFall,
+                    verticalDropMeters = verticalDrop,
+                    fallConfidence = fallConfidence,
+                    distanceMeters = distanceMeters,
+                    depthMotionLevel = depthMotionLevel,
+                    bedProximityMeters = bedProximity,
+                    inBedZone = inBedZone,
+                    position3D = Position3D(posX, posY, posZ),
+                    headHeightMeters = headHeight,
+                    nearFloorFraction = nearFloorFraction,
+                    bedSurfaceValid = bedSurfaceValid,
+                    heightAboveBedMeters = heightAboveBed,
+                    overBedEdgeFraction = overBedEdge,
+                    secondsSinceReposition = secondsSinceReposition,
+                    repositionCount = repositionCount,
+                    sleepState = sleepState,
+                    activityLevel = activityLevel,
+                    lightingChange = lightingChange,
+                    lowLight = lowLight,
+                    sceneGeneration = sceneGeneration
+                )
+            } catch (e: Exception) {
+                DetectionResult(secondsSinceLastMotion = secondsSinceMotion)
+            }
+        }
+
+        /**
+         * Number after "key": in the native JSON (the first occurrence)
+         */
+        internal fun extractFloat(json: String, key: String): Float? {
+            val pattern = "\"$key\"\\s*:\\s*(-?\\d+(?:\\.\\d+)?)".toRegex()
+            return pattern.find(json)?.groupValues?.get(1)?.toFloatOrNull()
+        }
+
+        private fun parsePose(json: String?): Pose {
+            // TODO: Parse actual pose from YOLO detection classes
+            return Pose.UNKNOWN
+        }
+    }
 }
@@ -33,13 +33,11 @@ import androidx.compose.ui.viewinterop.AndroidView
 import androidx.core.content.ContextCompat
 import androidx.lifecycle.compose.collectAsStateWithLifecycle
 import com.triage.vision.camera.DepthCameraManager
-import com.triage.vision.camera.DepthFrameSynchronizer
 import com.triage.vision.classifier.NursingLabels
 import com.triage.vision.data.ObservationEntity
 import com.triage.vision.pipeline.FastPipeline
 import com.triage.vision.pipeline.SlowPipeline
 import com.triage.vision.ui.theme.TriageVisionTheme
-import kotlinx.coroutines.launch
 import java.text.SimpleDateFormat
 import java.util.Date
 import java.util.Locale
@@ -284,11 +282,9 @@ fun MonitoringScreen(
     onStopMonitoring: () -> Unit
 ) {
     val context = LocalContext.current
-    val scope = rememberCoroutineScope()
 
     // Initialize depth camera manager
     val depthCameraManager = remember { DepthCameraManager(context) }
-    val frameSynchronizer = remember { DepthFrameSynchronizer() }
 
     var depthAvailable by remember { mutableStateOf(false) }
 
@@ -301,23 +297,18 @@ fun MonitoringScreen(
 
         if (depthAvailable) {
             Log.i("MonitoringScreen", "Depth camera available, starting...")
-            depthCameraManager.start()
-
-            // Collect depth frames and feed to synchronizer
-            scope.launch {
-                depthCameraManager.depthFrames.collect { depthFrame ->
-                    frameSynchronizer.onDepthFrame(depthFrame)
-                }
-            }
 
-            // Collect synchronized frames
-            scope.launch {
-                frameSynchronizer.syncedFrames.collect { syncedFrame ->
-                    if (uiState.isMonitoring && !uiState.useBackgroundService) {
-                        viewModel.processFrameWithDepth(syncedFrame.rgb, syncedFrame.depth)
+            // Depth planes go straight to the native synchronizer on the depth
+            // camera thread; a pair they complete runs on the frame thread
+            depthCameraManager.directDepthListener =
+                DepthCameraManager.DirectDepthListener { buffer, width, height, rowStride, timestampNs ->
+                    if (viewModel.processSyncedDepthFrame(buffer, width, height, rowStride, timestampNs) &&
+                        !cameraExecutor.isShutdown
+                    ) {
+                        cameraExecutor.execute { viewModel.processPendingSyncedPair() }
                     }
                 }
-            }
+            depthCameraManager.start()
         } else {
             Log.i("MonitoringScreen", "No depth camera available, using RGB-only")
         }
@@ -326,8 +317,8 @@ fun MonitoringScreen(
     // Cleanup on dispose
     DisposableEffect(Unit) {
         onDispose {
+            depthCameraManager.directDepthListener = null
             depthCameraManager.stop()
-            frameSynchronizer.clear()
         }
     }
 
@@ -345,8 +336,8 @@ fun MonitoringScreen(
                     // Always send frames to ViewModel - it will decide whether to process
                     // This handles the case where isMonitoring state hasn't propagated yet
                     if (depthAvailable && !uiState.useBackgroundService && uiState.isMonitoring) {
-                        // Feed RGB frame to synchronizer (foreground only mode with depth)
-                        frameSynchronizer.onRgbFrame(bitmap, timestamp)
+                        // Feed RGB frame to native synchronizer (foreground only mode with depth)
+                        viewModel.processSyncedRgbFrame(bitmap, timestamp)
                     } else {
                         // Send to ViewModel - it routes to service or processes locally
                         viewModel.processFrame(bitmap)
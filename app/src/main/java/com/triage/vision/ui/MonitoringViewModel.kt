@@ -23,6 +23,7 @@ import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.*
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
+import java.nio.ByteBuffer
 
 class MonitoringViewModel : ViewModel() {
 
@@ -370,21 +371,7 @@ class MonitoringViewModel : ViewModel() {
 
                 // Run fast pipeline with depth
                 val result = fastPipeline.processFrameWithDepth(bitmap, depthFrame)
-
-                // Update UI state with depth metrics
-                _uiState.update { state ->
-                    state.copy(
-                        personDetected = result.personDetected,
-                        currentPose = result.pose,
-                        motionLevel = result.motionLevel,
-                        secondsSinceMotion = result.secondsSinceLastMotion,
-                        frameCount = fastPipeline.getFrameCount(),
-                        depthAvailable = result.depthAvailable,
-                        distanceMeters = result.distanceMeters,
-                        bedProximityMeters = result.bedProximityMeters,
-                        inBedZone = result.inBedZone
-                    )
-                }
+                applyDepthResult(result)
 
                 lastFrameTime = now
 
@@ -394,6 +381,89 @@ class MonitoringViewModel : ViewModel() {
         }
     }
 
+    /**
+     * Submit an RGB frame to the native RGB-depth synchronizer (foreground mode).
+     * Runs on the calling camera thread; a completed pair updates the UI.
+     */
+    fun processSyncedRgbFrame(bitmap: Bitmap, timestampNs: Long) {
+        if (!_uiState.value.isMonitoring) return
+        if (_uiState.value.useBackgroundService && isBound) return
+
+        lastFrame = bitmap
+
+        try {
+            fastPipeline.submitSyncedRgbFrame(bitmap, timestampNs)?.let { onSyncedResult(it) }
+        } catch (e: Exception) {
+            Log.e(TAG, "Synced RGB frame error: ${e.message}", e)
+        }
+    }
+
+    /**
+     * Submit a DEPTH16 plane to the native RGB-depth synchronizer.
+     * Called on the depth camera thread while the Image is still open; only
+     * buffers the plane, so the depth stream is never held up by the pipeline.
+     * @return true if a pair is ready for processPendingSyncedPair
+     */
+    fun processSyncedDepthFrame(
+        buffer: ByteBuffer,
+        width: Int,
+        height: Int,
+        rowStride: Int,
+        timestampNs: Long
+    ): Boolean {
+        if (!_uiState.value.isMonitoring) return false
+        if (_uiState.value.useBackgroundService && isBound) return false
+
+        return try {
+            fastPipeline.submitSyncedDepthFrame(buffer, width, height, rowStride, timestampNs)
+        } catch (e: Exception) {
+            Log.e(TAG, "Synced depth frame error: ${e.message}", e)
+            false
+        }
+    }
+
+    /**
+     * Run a pair completed by a depth frame. Call on the frame (camera
+     * analysis) thread, which owns the native pipeline.
+     */
+    fun processPendingSyncedPair() {
+        try {
+            fastPipeline.processPendingSyncedPair()?.let { onSyncedResult(it) }
+        } catch (e: Exception) {
+            Log.e(TAG, "Synced pair error: ${e.message}", e)
+        }
+    }
+
+    private fun onSyncedResult(result: FastPipeline.DetectionResult) {
+        val now = System.currentTimeMillis()
+        frameCountForFps++
+        if (now - fpsUpdateTime >= 1000) {
+            val fps = frameCountForFps * 1000f / (now - fpsUpdateTime)
+            _uiState.update { it.copy(fps = fps) }
+            frameCountForFps = 0
+            fpsUpdateTime = now
+        }
+
+        applyDepthResult(result)
+        lastFrameTime = now
+    }
+
+    private fun applyDepthResult(result: FastPipeline.DetectionResult) {
+        _uiState.update { state ->
+            state.copy(
+                personDetected = result.personDetected,
+                currentPose = result.pose,
+                motionLevel = result.motionLevel,
+                secondsSinceMotion = result.secondsSinceLastMotion,
+                frameCount = fastPipeline.getFrameCount(),
+                depthAvailable = result.depthAvailable,
+                distanceMeters = result.distanceMeters,
+                bedProximityMeters = result.bedProximityMeters,
+                inBedZone = result.inBedZone
+            )
+        }
+    }
+
     /**
      * Set depth sensor availability
      */
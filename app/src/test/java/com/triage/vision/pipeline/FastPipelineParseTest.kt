@@ -0,0 +1,105 @@
+package com.triage.vision.pipeline
+
+import org.junit.Assert.*
+import org.junit.Test
+
+/**
+ * Unit tests for FastPipeline's parsing of the native depth pipeline JSON.
+ */
+class FastPipelineParseTest {
+
+    companion object {
+        // Depth pipeline result as runDepthPipeline formats it
+        private val DEPTH_JSON = """
+            {"person_detected": true, "pose": 1, "motion_level": 0.125, "fall_detected": false,
+            "depth_fall": false, "vertical_drop_meters": 0.012, "fall_confidence": 0.00,
+            "head_height_meters": 0.85, "near_floor_fraction": 0.10, "seconds_since_motion": 42,
+            "detection_count": 1, "distance_meters": 2.35, "depth_motion_level": 0.300,
+            "bed_proximity_meters": 0.40, "in_bed_zone": true, "bed_surface_valid": true,
+            "height_above_bed_meters": 0.22, "over_bed_edge_fraction": 0.15,
+            "position_3d": {"x": -0.125, "y": 0.250, "z": 2.350}, "depth_available": true,
+            "depth_valid_fraction": 0.912, "seconds_since_reposition": 7260, "reposition_count": 12,
+            "lying_orientation": 2, "sleep_state": 2, "activity_level": 0.450,
+            "lighting_change": false, "low_light": false, "scene_generation": 3,
+            "scene_settling": false, "input_size": 640, "inference_ms": 38.5,
+            "full_inference": true, "duty_mode": "full"}
+        """.trimIndent().replace("\n", " ")
+    }
+
+    // ==================== extractFloat Tests ====================
+
+    @Test
+    fun `extractFloat reads a quoted key followed by a colon`() {
+        assertEquals(12f, FastPipeline.extractFloat("{\"reposition_count\": 12}", "reposition_count"))
+        assertEquals(-0.5f, FastPipeline.extractFloat("{\"x\":-0.5}", "x"))
+    }
+
+    @Test
+    fun `extractFloat does not match a key ending in the same name`() {
+        val json = "{\"depth_motion_level\": 0.300, \"motion_level\": 0.125}"
+        assertEquals(0.125f, FastPipeline.extractFloat(json, "motion_level"))
+    }
+
+    @Test
+    fun `extractFloat returns null for a missing key`() {
+        assertNull(FastPipeline.extractFloat(DEPTH_JSON, "no_such_key"))
+    }
+
+    // ==================== parseDepthResult Tests ====================
+
+    @Test
+    fun `parseDepthResult reads the repositioning timer`() {
+        val result = FastPipeline.parseDepthResult(DEPTH_JSON, 0)
+
+        assertEquals(7260L, result.secondsSinceReposition)
+        assertEquals(12, result.repositionCount)
+    }
+
+    @Test
+    fun `parseDepthResult reads distance, motion and position`() {
+        val result = FastPipeline.parseDepthResult(DEPTH_JSON, 0)
+
+        assertEquals(0.125f, result.motionLevel, 1e-6f)
+        assertEquals(0.3f, result.depthMotionLevel, 1e-6f)
+        assertEquals(2.35f, result.distanceMeters, 1e-6f)
+        assertEquals(FastPipeline.Position3D(-0.125f, 0.25f, 2.35f), result.position3D)
+    }
+
+    @Test
+    fun `parseDepthResult reads sleep state and activity`() {
+        val result = FastPipeline.parseDepthResult(DEPTH_JSON, 0)
+
+        assertEquals(FastPipeline.SleepState.WAKE, result.sleepState)
+        assertEquals(0.45f, result.activityLevel, 1e-6f)
+    }
+
+    @Test
+    fun `parseDepthResult maps an unknown sleep state to UNKNOWN`() {
+        val result = FastPipeline.parseDepthResult("{\"sleep_state\": 9}", 0)
+
+        assertEquals(FastPipeline.SleepState.UNKNOWN, result.sleepState)
+    }
+
+    @Test
+    fun `parseDepthResult reads head height and floor contact`() {
+        val result = FastPipeline.parseDepthResult(DEPTH_JSON, 0)
+
+        assertEquals(0.85f, result.headHeightMeters, 1e-6f)
+        assertEquals(0.1f, result.nearFloorFraction, 1e-6f)
+    }
+
+    @Test
+    fun `parseDepthResult reads the patient position relative to the bed`() {
+        val result = FastPipeline.parseDepthResult(DEPTH_JSON, 0)
+
+        assertTrue(result.bedSurfaceValid)
+        assertEquals(0.22f, result.heightAboveBedMeters, 1e-6f)
+        assertEquals(0.15f, result.overBedEdgeFraction, 1e-6f)
+    }
+
+    @Test
+    fun `parseDepthResult reads the scene generation`() {
+        assertEquals(3, FastPipeline.parseDepthResult(DEPTH_JSON, 0).sceneGeneration)
+        assertEquals(0, FastPipeline.parseDepthResult("{}", 0).sceneGeneration)
+    }
+}
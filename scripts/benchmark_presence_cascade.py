@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+"""Replay a recorded session through the presence cascade and report what it saves.
+
+For every frame (in recording order) this runs:
+  - the presence stage: YOLO11n at 160x160 on the fixed ROI
+  - the full detector: YOLO11n at 640x640 on the whole frame
+and applies the same policy as PresenceCascade (fast_pipeline/presence_cascade.cpp)
+to decide which full runs the cascade would have skipped. Because the full
+detector runs on every frame here, the report also shows what skipping cost:
+frames where the cascade reported a different presence than the full
+detector, and how far the reused person box was from the fresh one.
+
+Requires: numpy, pillow, ncnn (pip install ncnn).
+
+Example:
+  python scripts/benchmark_presence_cascade.py \\
+      --frames recordings/night_shift_bed3 \\
+      --model-dir app/src/main/assets/models/yolo11n_ncnn_model \\
+      --roi 0.15 0.2 0.85 1.0
+"""
+
+import argparse
+import json
+import sys
+import time
+from pathlib import Path
+
+import numpy as np
+from PIL import Image
+
+from calibrate_yolo_int8 import CONF_THRESHOLD, IMAGE_SUFFIXES, PERSON_CLASS, iou, load_net
+
+# Must match YoloDetector / PresenceCascade defaults
+FULL_INPUT_SIZE = 640
+STAGE_INPUT_SIZE = 160
+PRESENT_THRESHOLD = 0.5
+MAX_SHIFT = 0.08
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--frames", required=True, type=Path,
+                        help="Directory of frames from one recorded session (sorted by name)")
+    parser.add_argument("--model-dir", required=True, type=Path,
+                        help="Directory with model.ncnn.param / model.ncnn.bin")
+    parser.add_argument("--roi", type=float, nargs=4, default=[0.0, 0.0, 1.0, 1.0],
+                        metavar=("LEFT", "TOP", "RIGHT", "BOTTOM"),
+                        help="Presence ROI normalized to the frame (default: whole frame)")
+    parser.add_argument("--refresh-frames", type=int, default=15,
+                        help="Full detector runs at least this often")
+    parser.add_argument("--threads", type=int, default=4,
+                        help="Inference threads (match the device)")
+    parser.add_argument("--report", type=Path, default=None,
+                        help="Write the report as JSON here")
+    return parser.parse_args()
+
+
+def infer_timed(net, chw):
+    import ncnn
+
+    start = time.perf_counter()
+    ex = net.create_extractor()
+    ex.input("in0", ncnn.Mat(chw))
+    _, out = ex.extract("out0")
+    return np.array(out), (time.perf_counter() - start) * 1000.0
+
+
+def to_input(image, box, size):
+    """Crop box (pixels), stretch to size x size, scale to 0-1 (as YoloDetector::runInference)."""
+    resized = image.crop(box).resize((size, size), Image.BILINEAR)
+    chw = np.asarray(resized, dtype=np.float32).transpose(2, 0, 1) / 255.0
+    return np.ascontiguousarray(chw)
+
+
+def best_person(out, size, region):
+    """Highest-scoring person box (x1, y1, x2, y2) in image pixels, and its score."""
+    best = out[4:].argmax(axis=0)
+    scores = out[4 + PERSON_CLASS]
+    keep = np.flatnonzero((best == PERSON_CLASS) & (scores >= CONF_THRESHOLD))
+    if len(keep) == 0:
+        return None, 0.0
+
+    i = keep[scores[keep].argmax()]
+    cx, cy, bw, bh = out[0][i], out[1][i], out[2][i], out[3][i]
+    rx, ry, rx2, ry2 = region
+    sx, sy = (rx2 - rx) / size, (ry2 - ry) / size
+    box = np.array([rx + (cx - bw / 2) * sx, ry + (cy - bh / 2) * sy,
+                    rx + (cx + bw / 2) * sx, ry + (cy + bh / 2) * sy])
+    return box, float(scores[i])
+
+
+def person_present(out):
+    best = out[4:].argmax(axis=0)
+    return bool(((best == PERSON_CLASS) & (out[4 + PERSON_CLASS] >= CONF_THRESHOLD)).any())
+
+
+class Cascade:
+    """Python mirror of PresenceCascade's decision."""
+
+    def __init__(self, refresh_frames):
+        self.refresh_frames = max(1, refresh_frames)
+        self.has_reference = False
+        self.reference_present = False
+        self.reference_box = None
+        self.frames_since_full = 0
+
+    def needs_full_run(self, score, box):
+        if not self.has_reference or self.frames_since_full + 1 >= self.refresh_frames:
+            return True
+        present = score >= PRESENT_THRESHOLD
+        absent = score <= 0.0
+        if not present and not absent:
+            return True
+        if present != self.reference_present:
+            return True
+        if present:
+            if self.reference_box is None or np.abs(box - self.reference_box).max() > MAX_SHIFT:
+                return True
+        self.frames_since_full += 1
+        return False
+
+    def record_full_run(self, present, score, box):
+        self.has_reference = True
+        self.reference_present = present
+        self.reference_box = box if score >= PRESENT_THRESHOLD else None
+        self.frames_since_full = 0
+
+
+def main():
+    args = parse_args()
+
+    frames = sorted(p for p in args.frames.rglob("*") if p.suffix.lower() in IMAGE_SUFFIXES)
+    if len(frames) < 2:
+        sys.exit(f"Need a recorded session in {args.frames}, found {len(frames)} frames")
+
+    net = load_net(args.model_dir / "model.ncnn.param", args.model_dir / "model.ncnn.bin",
+                   False, args.threads)
+    cascade = Cascade(args.refresh_frames)
+
+    stage_ms, full_ms = [], []
+    full_runs = 0
+    presence_errors = 0
+    reused_iou = []
+    cached_present, cached_box = False, None
+
+    for frame in frames:
+        image = Image.open(frame).convert("RGB")
+        width, height = image.size
+        left, top, right, bottom = args.roi
+        roi = (int(left * width), int(top * height), int(right * width), int(bottom * height))
+
+        out, ms = infer_timed(net, to_input(image, roi, STAGE_INPUT_SIZE))
+        stage_ms.append(ms)
+        stage_box, stage_score = best_person(out, STAGE_INPUT_SIZE, roi)
+        roi_box = np.zeros(4)
+        if stage_box is not None:
+            rw, rh = roi[2] - roi[0], roi[3] - roi[1]
+            roi_box = (stage_box - [roi[0], roi[1], roi[0], roi[1]]) / [rw, rh, rw, rh]
+
+        # Full detector every frame: the cost when it runs, the truth when it does not
+        out, ms = infer_timed(net, to_input(image, (0, 0, width, height), FULL_INPUT_SIZE))
+        present = person_present(out)
+        full_box, _ = best_person(out, FULL_INPUT_SIZE, (0, 0, width, height))
+
+        if cascade.needs_full_run(stage_score, roi_box):
+            full_runs += 1
+            full_ms.append(ms)
+            cascade.record_full_run(present, stage_score, roi_box)
+            cached_present, cached_box = present, full_box
+        else:
+            presence_errors += int(cached_present != present)
+            if cached_box is not None and full_box is not None:
+                reused_iou.append(float(iou(cached_box, full_box[None, :])[0]))
+
+    num_frames = len(frames)
+    skipped = num_frames - full_runs
+    mean_stage = float(np.mean(stage_ms))
+    mean_full = float(np.mean(full_ms)) if full_ms else 0.0
+    mean_frame = (sum(stage_ms) + sum(full_ms)) / num_frames
+    report = {
+        "frames": num_frames,
+        "full_runs": full_runs,
+        "avoided_fraction": skipped / num_frames,
+        "mean_stage_ms": mean_stage,
+        "mean_full_ms": mean_full,
+        "mean_frame_ms": mean_frame,
+        "speedup_vs_always_full": mean_full / max(mean_frame, 1e-6),
+        "presence_errors": presence_errors,
+        "presence_error_rate": presence_errors / max(skipped, 1),
+        "mean_reused_box_iou": float(np.mean(reused_iou)) if reused_iou else None,
+        "roi": args.roi,
+        "refresh_frames": args.refresh_frames,
+        "threads": args.threads,
+    }
+    if args.report:
+        args.report.write_text(json.dumps(report, indent=2) + "\n")
+
+    print("=" * 60)
+    print(f"Session: {args.frames} ({num_frames} frames, {args.threads} threads, host CPU)")
+    print(f"  Stage {STAGE_INPUT_SIZE}px:    {mean_stage:8.2f} ms/frame")
+    print(f"  Full {FULL_INPUT_SIZE}px:     {mean_full:8.2f} ms/run")
+    print(f"  Full runs avoided: {skipped}/{num_frames} ({report['avoided_fraction']:.1%})")
+    print(f"  Mean cost/frame:   {mean_frame:8.2f} ms ({report['speedup_vs_always_full']:.2f}x vs always full)")
+    print(f"  Presence errors on skipped frames: {presence_errors} "
+          f"({report['presence_error_rate']:.2%})")
+    if reused_iou:
+        print(f"  Reused person box IoU vs fresh: {report['mean_reused_box_iou']:.3f}")
+    print("Host latency is indicative only - compare with")
+    print("NativeBridge.getPresenceCascadeStats() on the target device.")
+    print("=" * 60)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,305 @@
+#!/usr/bin/env python3
+"""Calibrate an INT8 YOLO11n NCNN model from recorded ward frames and compare it to the float model.
+
+Steps:
+  1. Split the frames into a calibration set and a validation set.
+  2. Build the int8 table with ncnn2table (same preprocessing as YoloDetector:
+     RGB, stretched to 640x640, scaled to 0-1).
+  3. Quantize with ncnn2int8 -> model.ncnn.int8.param / model.ncnn.int8.bin.
+  4. Run both models on the validation set and report latency, person AP@0.5
+     and person recall.
+
+Ground truth comes from YOLO-format label files (class cx cy w h, normalized)
+when --labels is given; otherwise the float model's detections are used as
+the reference, so the report shows how closely INT8 agrees with it.
+
+Requires: numpy, pillow, ncnn (pip install ncnn), and the ncnn2table /
+ncnn2int8 tools from an ncnn host build (tools/quantize).
+
+Example:
+  python scripts/calibrate_yolo_int8.py \\
+      --frames recordings/ward_frames \\
+      --model-dir app/src/main/assets/models/yolo11n_ncnn_model \\
+      --ncnn-tools ~/ncnn/build/tools/quantize
+"""
+
+import argparse
+import json
+import os
+import random
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+import numpy as np
+from PIL import Image
+
+# Must match YoloDetector (input size, thresholds, output layout)
+INPUT_SIZE = 640
+CONF_THRESHOLD = 0.15
+EVAL_CONF_THRESHOLD = 0.25
+NMS_THRESHOLD = 0.45
+IOU_MATCH = 0.5
+PERSON_CLASS = 0
+
+IMAGE_SUFFIXES = {".jpg", ".jpeg", ".png", ".bmp"}
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--frames", required=True, type=Path,
+                        help="Directory of recorded ward frames (searched recursively)")
+    parser.add_argument("--model-dir", required=True, type=Path,
+                        help="Directory with model.ncnn.param / model.ncnn.bin")
+    parser.add_argument("--ncnn-tools", type=Path, default=None,
+                        help="Directory containing ncnn2table and ncnn2int8 (default: PATH)")
+    parser.add_argument("--labels", type=Path, default=None,
+                        help="YOLO-format label directory (same stem as each frame)")
+    parser.add_argument("--val-fraction", type=float, default=0.2,
+                        help="Fraction of frames held out for evaluation")
+    parser.add_argument("--max-calibration", type=int, default=1000,
+                        help="Maximum frames used for calibration")
+    parser.add_argument("--method", default="kl", choices=["kl", "aciq", "eq"],
+                        help="ncnn2table calibration method")
+    parser.add_argument("--threads", type=int, default=4,
+                        help="Threads for calibration and benchmarking (match the device)")
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--skip-quantize", action="store_true",
+                        help="Only evaluate existing int8 files")
+    return parser.parse_args()
+
+
+def tool_path(tools_dir, name):
+    return str(tools_dir / name) if tools_dir else name
+
+
+def run(cmd):
+    print("  $ " + " ".join(cmd))
+    subprocess.run(cmd, check=True)
+
+
+def quantize(args, calibration, work_dir):
+    param = args.model_dir / "model.ncnn.param"
+    weights = args.model_dir / "model.ncnn.bin"
+    table = args.model_dir / "model.ncnn.table"
+
+    image_list = work_dir / "calibration_images.txt"
+    image_list.write_text("\n".join(str(p.resolve()) for p in calibration) + "\n")
+
+    norm = 1.0 / 255.0
+    run([
+        tool_path(args.ncnn_tools, "ncnn2table"),
+        str(param), str(weights), str(image_list), str(table),
+        "mean=[0,0,0]",
+        f"norm=[{norm:.8f},{norm:.8f},{norm:.8f}]",
+        f"shape=[{INPUT_SIZE},{INPUT_SIZE},3]",
+        "pixel=RGB",
+        f"thread={args.threads}",
+        f"method={args.method}",
+    ])
+    run([
+        tool_path(args.ncnn_tools, "ncnn2int8"),
+        str(param), str(weights),
+        str(args.model_dir / "model.ncnn.int8.param"),
+        str(args.model_dir / "model.ncnn.int8.bin"),
+        str(table),
+    ])
+
+
+def load_net(param, weights, int8, threads):
+    import ncnn
+
+    net = ncnn.Net()
+    net.opt.use_vulkan_compute = False
+    net.opt.use_int8_inference = int8
+    net.opt.num_threads = threads
+    net.load_param(str(param))
+    net.load_model(str(weights))
+    return net
+
+
+def preprocess(path):
+    """RGB, stretched to the model input, scaled to 0-1 (as YoloDetector::runInference)."""
+    image = Image.open(path).convert("RGB")
+    width, height = image.size
+    resized = image.resize((INPUT_SIZE, INPUT_SIZE), Image.BILINEAR)
+    chw = np.asarray(resized, dtype=np.float32).transpose(2, 0, 1) / 255.0
+    return np.ascontiguousarray(chw), width, height
+
+
+def infer(net, chw):
+    import ncnn
+
+    ex = net.create_extractor()
+    ex.input("in0", ncnn.Mat(chw))
+    start = time.perf_counter()
+    _, out = ex.extract("out0")
+    elapsed_ms = (time.perf_counter() - start) * 1000.0
+    return np.array(out), elapsed_ms
+
+
+def iou(box, boxes):
+    ix1 = np.maximum(box[0], boxes[:, 0])
+    iy1 = np.maximum(box[1], boxes[:, 1])
+    ix2 = np.minimum(box[2], boxes[:, 2])
+    iy2 = np.minimum(box[3], boxes[:, 3])
+    inter = np.clip(ix2 - ix1, 0, None) * np.clip(iy2 - iy1, 0, None)
+    area = (box[2] - box[0]) * (box[3] - box[1])
+    areas = (boxes[:, 2] - boxes[:, 0]) * (boxes[:, 3] - boxes[:, 1])
+    return inter / np.maximum(area + areas - inter, 1e-6)
+
+
+def decode_persons(out, width, height):
+    """Person boxes (x1, y1, x2, y2, score) in image pixels from the [84, 8400] output."""
+    scores = out[4 + PERSON_CLASS]
+    best = out[4:].argmax(axis=0)
+    keep = (best == PERSON_CLASS) & (scores >= CONF_THRESHOLD)
+    cx, cy, bw, bh = out[0][keep], out[1][keep], out[2][keep], out[3][keep]
+    sx, sy = width / INPUT_SIZE, height / INPUT_SIZE
+    boxes = np.stack([(cx - bw / 2) * sx, (cy - bh / 2) * sy,
+                      (cx + bw / 2) * sx, (cy + bh / 2) * sy, scores[keep]], axis=1)
+
+    order = boxes[:, 4].argsort()[::-1]
+    boxes = boxes[order]
+    kept = []
+    while len(boxes):
+        kept.append(boxes[0])
+        boxes = boxes[1:][iou(boxes[0], boxes[1:]) <= NMS_THRESHOLD]
+    return np.array(kept).reshape(-1, 5)
+
+
+def load_labels(label_dir, frame, width, height):
+    path = label_dir / (frame.stem + ".txt")
+    boxes = []
+    if path.exists():
+        for line in path.read_text().splitlines():
+            parts = line.split()
+            if len(parts) < 5 or int(parts[0]) != PERSON_CLASS:
+                continue
+            cx, cy, bw, bh = (float(v) for v in parts[1:5])
+            boxes.append([(cx - bw / 2) * width, (cy - bh / 2) * height,
+                          (cx + bw / 2) * width, (cy + bh / 2) * height])
+    return np.array(boxes).reshape(-1, 4)
+
+
+def evaluate(predictions, references):
+    """Person AP@0.5 (all-point interpolation) and recall at EVAL_CONF_THRESHOLD."""
+    total_gt = sum(len(r) for r in references)
+    if total_gt == 0:
+        return 0.0, 0.0
+
+    scored = []  # (score, is_true_positive)
+    recall_hits = 0
+    for preds, refs in zip(predictions, references):
+        matched = np.zeros(len(refs), dtype=bool)
+        for box in preds:
+            tp = False
+            if len(refs):
+                overlaps = iou(box[:4], refs)
+                overlaps[matched] = 0.0
+                j = overlaps.argmax()
+                if overlaps[j] >= IOU_MATCH:
+                    matched[j] = True
+                    tp = True
+                    if box[4] >= EVAL_CONF_THRESHOLD:
+                        recall_hits += 1
+            scored.append((box[4], tp))
+
+    scored.sort(key=lambda s: -s[0])
+    tps = np.cumsum([s[1] for s in scored])
+    fps = np.cumsum([not s[1] for s in scored])
+    recall = tps / total_gt
+    precision = tps / np.maximum(tps + fps, 1)
+
+    # All-point interpolated area under the precision-recall curve
+    mrec = np.concatenate([[0.0], recall, [1.0]])
+    mpre = np.concatenate([[0.0], precision, [0.0]])
+    for i in range(len(mpre) - 2, -1, -1):
+        mpre[i] = max(mpre[i], mpre[i + 1])
+    steps = np.where(mrec[1:] != mrec[:-1])[0]
+    ap = float(np.sum((mrec[steps + 1] - mrec[steps]) * mpre[steps + 1]))
+    return ap, recall_hits / total_gt
+
+
+def main():
+    args = parse_args()
+
+    print("=" * 60)
+    print("YOLO11n INT8 Calibration for Triage Vision Android")
+    print("=" * 60)
+
+    frames = sorted(p for p in args.frames.rglob("*") if p.suffix.lower() in IMAGE_SUFFIXES)
+    if len(frames) < 10:
+        sys.exit(f"Need at least 10 frames in {args.frames}, found {len(frames)}")
+
+    random.Random(args.seed).shuffle(frames)
+    num_val = max(1, int(len(frames) * args.val_fraction))
+    validation = frames[:num_val]
+    calibration = frames[num_val:num_val + args.max_calibration]
+    print(f"Frames: {len(calibration)} calibration, {len(validation)} validation")
+
+    if not args.skip_quantize:
+        print("\nQuantizing...")
+        quantize(args, calibration, args.model_dir)
+
+    print("\nEvaluating on held-out frames...")
+    float_net = load_net(args.model_dir / "model.ncnn.param",
+                         args.model_dir / "model.ncnn.bin", False, args.threads)
+    int8_net = load_net(args.model_dir / "model.ncnn.int8.param",
+                        args.model_dir / "model.ncnn.int8.bin", True, args.threads)
+
+    float_preds, int8_preds, references = [], [], []
+    float_ms, int8_ms = [], []
+    for frame in validation:
+        chw, width, height = preprocess(frame)
+
+        out, ms = infer(float_net, chw)
+        float_preds.append(decode_persons(out, width, height))
+        float_ms.append(ms)
+
+        out, ms = infer(int8_net, chw)
+        int8_preds.append(decode_persons(out, width, height))
+        int8_ms.append(ms)
+
+        if args.labels:
+            references.append(load_labels(args.labels, frame, width, height))
+        else:
+            reference = float_preds[-1]
+            references.append(reference[reference[:, 4] >= EVAL_CONF_THRESHOLD, :4])
+
+    float_ap, float_recall = evaluate(float_preds, references)
+    int8_ap, int8_recall = evaluate(int8_preds, references)
+    float_median = float(np.median(float_ms))
+    int8_median = float(np.median(int8_ms))
+
+    reference_name = "labels" if args.labels else "float model (pseudo-labels)"
+    report = {
+        "frames_calibration": len(calibration),
+        "frames_validation": len(validation),
+        "reference": reference_name,
+        "threads": args.threads,
+        "float": {"median_ms": float_median, "person_ap50": float_ap, "person_recall": float_recall},
+        "int8": {"median_ms": int8_median, "person_ap50": int8_ap, "person_recall": int8_recall},
+        "speedup": float_median / max(int8_median, 1e-6),
+        "ap50_delta": int8_ap - float_ap,
+        "recall_delta": int8_recall - float_recall,
+    }
+    report_path = args.model_dir / "int8_report.json"
+    report_path.write_text(json.dumps(report, indent=2) + "\n")
+
+    print("\n" + "=" * 60)
+    print(f"Reference: {reference_name}, {args.threads} threads (host CPU)")
+    print(f"  {'':8}{'median ms':>12}{'person AP50':>14}{'recall':>10}")
+    print(f"  {'float':8}{float_median:>12.1f}{float_ap:>14.3f}{float_recall:>10.3f}")
+    print(f"  {'int8':8}{int8_median:>12.1f}{int8_ap:>14.3f}{int8_recall:>10.3f}")
+    print(f"  Speedup: {report['speedup']:.2f}x, AP50 delta: {report['ap50_delta']:+.3f}, "
+          f"recall delta: {report['recall_delta']:+.3f}")
+    print(f"  Report: {report_path}")
+    print("Host latency is indicative only - confirm on the target device.")
+    print("Enable on device with NativeBridge.setYoloInt8(true) before init().")
+    print("=" * 60)
+
+
+if __name__ == "__main__":
+    main()